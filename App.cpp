@@ -1,16 +1,26 @@
 // bamboo/App.cpp
 #include "bamboo/App.hpp"
+#include "bamboo/Browser.hpp"
 #include "bamboo/JsBridge.hpp"
+#include "bamboo/Watchdog.hpp"
 #include "include/cef_app.h"
 #include "include/cef_command_line.h"
+#include "include/cef_trace.h"
+#include "include/wrapper/cef_closure_task.h"
 #include "include/wrapper/cef_helpers.h"
-#include <print>
 #include <format>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
 
 #if defined(_WIN32)
   #include <windows.h>
 #elif defined(__APPLE__)
   #include "include/wrapper/cef_library_loader.h"
+  #include <unistd.h>
+#else
+  #include <unistd.h>
 #endif
 
 namespace bamboo {
@@ -37,16 +47,32 @@ public:
         if (!config_.enableWebGL)            cmd->AppendSwitch("disable-webgl");
         if (config_.ignoreCertificateErrors) cmd->AppendSwitch("ignore-certificate-errors");
         for (const auto& flag : config_.chromiumFlags) {
-            cmd->AppendSwitch(flag.starts_with("--") ? flag.substr(2) : flag);
+            std::string_view sw = flag;
+            if (sw.starts_with("--")) sw.remove_prefix(2);
+            if (auto eq = sw.find('='); eq != std::string_view::npos)
+                cmd->AppendSwitchWithValue(std::string(sw.substr(0, eq)), std::string(sw.substr(eq + 1)));
+            else
+                cmd->AppendSwitch(std::string(sw));
         }
+        // Native overlay scrollbars are painted by the compositor and keep
+        // scrolling on Chromium's fast path, unlike ::-webkit-scrollbar CSS.
+        if (config_.nativeOverlayScrollbars) enableFeature(cmd, "OverlayScrollbar");
     }
 
     void OnContextInitialized() override {
-        std::println("[Bamboo] Chromium context initialized.");
+        BAMBOO_LOG_INFO("Chromium context initialized.");
     }
 
     IMPLEMENT_REFCOUNTING(BambooCefApp);
 private:
+    /** Add to --enable-features without clobbering features set elsewhere. */
+    static void enableFeature(CefRefPtr<CefCommandLine> cmd, std::string_view feature) {
+        std::string features = cmd->GetSwitchValue("enable-features").ToString();
+        if (!features.empty()) features += ',';
+        features += feature;
+        cmd->AppendSwitchWithValue("enable-features", features);
+    }
+
     AppConfig config_;
     CefRefPtr<BambooJsBridge> jsBridge_ = new BambooJsBridge();
 };
@@ -59,17 +85,76 @@ private:
     CefRefPtr<BambooJsBridge> jsBridge_ = new BambooJsBridge();
 };
 
+// ─── Trace writer ─────────────────────────────────────────────────────────────
+// Receives Chromium's trace file, merges Bamboo spans into it off the UI
+// thread (traces run to tens of MB), then reports back on the UI thread.
+
+class TraceWriter final : public CefEndTracingCallback {
+public:
+    using Done = std::function<void(std::expected<void, TraceError>)>;
+
+    TraceWriter(std::string path, std::vector<TraceSpan> spans, int64_t clockOffsetUs, Done done)
+        : path_(std::move(path)), spans_(std::move(spans)),
+          clockOffsetUs_(clockOffsetUs), done_(std::move(done)) {}
+
+    void OnEndTracingComplete(const CefString& tracingFile) override {
+        CefRefPtr<TraceWriter> self = this;
+        CefPostTask(TID_FILE_USER_VISIBLE, CefCreateClosureTask([self, file = tracingFile.ToString()] {
+            auto result = self->write(file);
+            CefPostTask(TID_UI, CefCreateClosureTask([self, result] {
+                if (self->done_) self->done_(result);
+            }));
+        }));
+    }
+
+    IMPLEMENT_REFCOUNTING(TraceWriter);
+private:
+    std::expected<void, TraceError> write(const std::string& chromeFile) {
+        if (chromeFile.empty()) return std::unexpected(TraceError::EndFailed);
+        std::string chromeJson;
+        {
+            std::ifstream in(chromeFile, std::ios::binary);
+            if (!in) return std::unexpected(TraceError::ReadFailed);
+            std::ostringstream buf;
+            buf << in.rdbuf();
+            chromeJson = std::move(buf).str();
+        }
+        std::error_code ec;
+        std::filesystem::remove(chromeFile, ec);
+
+#if defined(_WIN32)
+        const int64_t pid = GetCurrentProcessId();
+#else
+        const int64_t pid = getpid();
+#endif
+        auto merged = trace::mergeChromeTrace(chromeJson, spans_, clockOffsetUs_, pid);
+        if (!merged) return std::unexpected(merged.error());
+
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        if (!out.write(merged->data(), static_cast<std::streamsize>(merged->size())))
+            return std::unexpected(TraceError::WriteFailed);
+        return {};
+    }
+
+    std::string            path_;
+    std::vector<TraceSpan> spans_;
+    int64_t                clockOffsetUs_;
+    Done                   done_;
+};
+
 // ─── App ──────────────────────────────────────────────────────────────────────
 
 App::App(AppConfig config) : config_(std::move(config)) {}
 
 App::~App() {
     CefShutdown();
-    std::println("[Bamboo] Shutdown complete.");
+    BAMBOO_LOG_INFO("Shutdown complete.");
+    logging::stop();
 }
 
 std::expected<std::unique_ptr<App>, AppError>
 App::create(int argc, char* argv[], AppConfig config) {
+    BAMBOO_TRACE_SCOPE("App::create");
     if (config.userAgent.empty())
         config.userAgent = std::format("{}/{} Bamboo/{}", config.name, config.version, App::version());
 
@@ -93,23 +178,32 @@ App::create(int argc, char* argv[], AppConfig config) {
     int exitCode = CefExecuteProcess(mainArgs, subApp, nullptr);
     if (exitCode >= 0) std::exit(exitCode);
 
+    // Browser process only, before CEF opens the file: one rotation covers
+    // Chromium's log and ours.
+    logging::rotate(config.logPath, config.logFilesToKeep);
+    logging::start({ .path = config.logPath, .console = config.logToConsole,
+                     .keepFiles = config.logFilesToKeep, .level = config.logLevel });
+
     auto app = std::unique_ptr<App>(new App(config));
     app->cefApp_ = new BambooCefApp(config);
 
     CefSettings settings;
     settings.no_sandbox = 1;
+    settings.windowless_rendering_enabled = config.windowlessRendering;
     settings.log_severity = config.logToConsole ? LOGSEVERITY_INFO : LOGSEVERITY_DISABLE;
     settings.remote_debugging_port = config.remoteDebugging ? config.remoteDebugPort : 0;
     CefString(&settings.cache_path).FromString(config.cachePath);
     CefString(&settings.log_file).FromString(config.logPath);
     CefString(&settings.user_agent).FromString(config.userAgent);
 
-    if (!CefInitialize(mainArgs, settings, app->cefApp_, nullptr))
+    if (!CefInitialize(mainArgs, settings, app->cefApp_, nullptr)) {
+        BAMBOO_LOG_ERROR("CefInitialize failed (cache: {})", config.cachePath);
         return std::unexpected(AppError::InitFailed);
+    }
 
-    std::println("[Bamboo] v{} initialized.", App::version());
+    BAMBOO_LOG_INFO("v{} initialized.", App::version());
     if (config.remoteDebugging)
-        std::println("[Bamboo] DevTools: http://localhost:{}", config.remoteDebugPort);
+        BAMBOO_LOG_INFO("DevTools: http://localhost:{}", config.remoteDebugPort);
 
     return app;
 }
@@ -117,8 +211,44 @@ App::create(int argc, char* argv[], AppConfig config) {
 void App::run()   { CefRunMessageLoop(); }
 void App::quit()  { CefQuitMessageLoop(); }
 bool App::isUIThread() const { return CefCurrentlyOn(TID_UI); }
-void App::postUITask(std::function<void()> task) {
-    CefPostTask(TID_UI, CefCreateClosureTask(std::move(task)));
+
+BridgeStats App::bridgeStats() const { return Browser::aggregateBridgeStats(); }
+std::expected<void, TraceError> App::startTracing(std::string_view categories) {
+    CEF_REQUIRE_UI_THREAD();
+    if (tracing_) return std::unexpected(TraceError::AlreadyTracing);
+    if (!CefBeginTracing(std::string(categories), nullptr))
+        return std::unexpected(TraceError::BeginFailed);
+    // Keep spans from a trace::startRecording() made before App::create().
+    if (!trace::recording()) trace::startRecording();
+    tracing_ = true;
+    return {};
+}
+
+void App::stopTracing(std::string path,
+                      std::function<void(std::expected<void, TraceError>)> done) {
+    CEF_REQUIRE_UI_THREAD();
+    auto fail = [&](TraceError e) { if (done) done(std::unexpected(e)); };
+    if (!tracing_) return fail(TraceError::NotTracing);
+    tracing_ = false;
+
+    // Bamboo spans use steady_clock; Chromium stamps events with its own
+    // trace clock. Sample both once and shift the spans onto Chromium's.
+    const int64_t offset = CefNowFromSystemTraceTime() - static_cast<int64_t>(trace::nowUs());
+    CefRefPtr<TraceWriter> writer =
+        new TraceWriter(std::move(path), trace::stopRecording(), offset, std::move(done));
+    if (!CefEndTracing(CefString(), writer))
+        writer->OnEndTracingComplete(CefString());  // reports EndFailed via `done`
+}
+
+void App::enableProfilingTriggers(ProfilingTriggers triggers) {
+    profiling::enableTriggers(std::move(triggers));
+}
+
+void App::postUITask(std::function<void()> task, std::source_location where) {
+    CefPostTask(TID_UI, CefCreateClosureTask([task = std::move(task), where] {
+        watchdog::TaskScope scope("task", where.function_name(), where);
+        task();
+    }));
 }
 
 } // namespace bamboo
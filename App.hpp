@@ -6,7 +6,12 @@
 #include <functional>
 #include <memory>
 #include <expected>
+#include <source_location>
 #include <span>
+#include "bamboo/BridgeStats.hpp"
+#include "bamboo/Log.hpp"
+#include "bamboo/Profiling.hpp"
+#include "bamboo/Trace.hpp"
 #include "include/cef_app.h"
 #include "include/cef_base.h"
 
@@ -31,7 +36,8 @@ struct AppConfig {
 
     // Paths
     std::string cachePath       = "./bamboo_cache";
-    std::string logPath         = "./bamboo.log";
+    std::string logPath         = "./bamboo.log";   // shared by Chromium and Bamboo's logger
+    int         logFilesToKeep  = 3;                // logPath.1 … .N, rotated at startup
 
     // Chromium flags
     bool enableGPU              = true;
@@ -39,11 +45,15 @@ struct AppConfig {
     bool enableMedia            = true;   // audio/video/webcam
     bool enableNotifications    = false;
     bool ignoreCertificateErrors = false; // ⚠️ dev only
+    bool windowlessRendering    = false;  // required for WindowConfig::offscreen
+    bool nativeOverlayScrollbars = false; // enable Chromium's OverlayScrollbar feature
+                                          // (for ScrollbarStyle::NativeOverlay)
 
     // Debugging
     bool remoteDebugging        = false;
     int  remoteDebugPort        = 9222;
     bool logToConsole           = true;
+    LogLevel logLevel           = LogLevel::Info;   // Bamboo's runtime floor (see Log.hpp)
 
     // Extra Chromium command-line switches
     // e.g. { "--disable-web-security", "--allow-running-insecure-content" }
@@ -100,8 +110,11 @@ public:
 
     /**
      * @brief Post a callable to the CEF UI thread (thread-safe).
+     *
+     * `where` is the posting site; a UIWatchdog names it when the task stalls.
      */
-    void postUITask(std::function<void()> task);
+    void postUITask(std::function<void()> task,
+                    std::source_location where = std::source_location::current());
 
     /**
      * @brief Returns true if the caller is on the CEF UI thread.
@@ -118,11 +131,51 @@ public:
      */
     [[nodiscard]] static std::string_view version() { return "1.0.0"; }
 
+    /**
+     * @brief Bridge counters merged across every open window. UI thread only.
+     */
+    [[nodiscard]] BridgeStats bridgeStats() const;
+
+    // ── Tracing ───────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Start Chromium tracing plus Bamboo span recording. UI thread only.
+     *
+     * `categories` is Chromium's category filter ("" = Chromium defaults,
+     * e.g. "-*,blink,v8,cc,toplevel"). Bamboo spans come from the
+     * BAMBOO_TRACE_SCOPE macros (Trace.hpp), which only exist in builds with
+     * -DBAMBOO_ENABLE_TRACING=ON; other builds trace Chromium alone.
+     */
+    std::expected<void, TraceError> startTracing(std::string_view categories = "");
+
+    /**
+     * @brief Stop tracing and write one Chrome trace JSON file to `path`.
+     *
+     * Bamboo spans are merged into Chromium's events on a shared clock, so
+     * C++ handlers and renderer work sit on one timeline (open the file in
+     * chrome://tracing or ui.perfetto.dev). `done` runs on the UI thread.
+     */
+    void stopTracing(std::string path,
+                     std::function<void(std::expected<void, TraceError>)> done = {});
+
+    // ── Profiling ─────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Let a signal or hotkey capture CPU profiles / heap snapshots of
+     *        every open window, for investigating issues in field builds.
+     *
+     * Off until called; call again to change the config. Files land in
+     * triggers.directory; success or failure is logged. UI thread only.
+     * For captures from code, use Browser::captureCpuProfile/captureHeapSnapshot.
+     */
+    void enableProfilingTriggers(ProfilingTriggers triggers = {});
+
 private:
     explicit App(AppConfig config);
 
     AppConfig config_;
     CefRefPtr<BambooCefApp> cefApp_;
+    bool tracing_ = false;
 };
 
 } // namespace bamboo
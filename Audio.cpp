@@ -0,0 +1,482 @@
+// bamboo/Audio.cpp - see include/bamboo/Audio.hpp for API docs
+#include "bamboo/Audio.hpp"
+#include "bamboo/Browser.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace bamboo {
+
+namespace {
+
+constexpr size_t kSampleRingCapacity = size_t(1) << 18;  // ~1.3 s of 48 kHz stereo
+constexpr size_t kPacketRingCapacity = 1024;
+constexpr auto   kPumpInterval       = std::chrono::milliseconds(5);
+
+// Channel remap + linear resampling from whatever CEF delivers to a
+// consumer's format. Stateful so consecutive packets join seamlessly.
+struct Converter {
+    AudioFormat        out;
+    double             pos     = 0.0;  // read position relative to the current input
+    bool               hasPrev = false;
+    std::vector<float> prev;           // last remapped input frame
+    std::vector<float> remapped;
+
+    void reset() { pos = 0.0; hasPrev = false; }
+
+    void process(const float* in, int frames, int inChannels, int inRate, std::vector<float>& dst) {
+        if (frames <= 0) return;
+        const int outCh = out.channels;
+
+        // Generic up/down-mix: output channel c takes the average of every
+        // input channel i with i % outCh == c; upmixing repeats input channels.
+        remapped.assign(static_cast<size_t>(frames) * outCh, 0.0f);
+        for (int f = 0; f < frames; ++f) {
+            const float* src = in + static_cast<size_t>(f) * inChannels;
+            float*       d   = remapped.data() + static_cast<size_t>(f) * outCh;
+            if (inChannels == outCh) {
+                std::copy_n(src, outCh, d);
+            } else if (inChannels > outCh) {
+                for (int i = 0; i < inChannels; ++i) d[i % outCh] += src[i];
+                const float scale = static_cast<float>(outCh) / static_cast<float>(inChannels);
+                for (int c = 0; c < outCh; ++c) d[c] *= scale;
+            } else {
+                for (int c = 0; c < outCh; ++c) d[c] = src[c % inChannels];
+            }
+        }
+
+        if (inRate == out.sampleRate) {
+            dst.insert(dst.end(), remapped.begin(), remapped.end());
+            prev.assign(remapped.end() - outCh, remapped.end());
+            hasPrev = true;
+            return;
+        }
+
+        // Linear interpolation; index -1 refers to the last frame of the previous packet.
+        if (!hasPrev) { prev.assign(remapped.begin(), remapped.begin() + outCh); pos = 0.0; hasPrev = true; }
+        const double step = static_cast<double>(inRate) / out.sampleRate;
+        auto frameAt = [&](long i) -> const float* {
+            return i < 0 ? prev.data() : remapped.data() + static_cast<size_t>(i) * outCh;
+        };
+        while (pos < frames - 1) {
+            const long   i    = static_cast<long>(std::floor(pos));
+            const float  frac = static_cast<float>(pos - i);
+            const float* a    = frameAt(i);
+            const float* b    = frameAt(i + 1);
+            for (int c = 0; c < outCh; ++c) dst.push_back(a[c] + (b[c] - a[c]) * frac);
+            pos += step;
+        }
+        pos -= frames;
+        prev.assign(remapped.end() - outCh, remapped.end());
+    }
+};
+
+void encode(const std::vector<float>& in, SampleFormat fmt, std::vector<std::byte>& out) {
+    if (fmt == SampleFormat::Float32) {
+        out.resize(in.size() * sizeof(float));
+        std::memcpy(out.data(), in.data(), out.size());
+        return;
+    }
+    out.resize(in.size() * sizeof(int16_t));
+    auto* d = reinterpret_cast<int16_t*>(out.data());
+    for (size_t i = 0; i < in.size(); ++i)
+        d[i] = static_cast<int16_t>(std::lrint(std::clamp(in[i], -1.0f, 1.0f) * 32767.0f));
+}
+
+void putLE(std::ofstream& f, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) f.put(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+} // namespace
+
+// ─── Engine: the single Bamboo audio thread ───────────────────────────────────
+
+class AudioEngine {
+public:
+    static AudioEngine& instance() {
+        static AudioEngine engine;
+        return engine;
+    }
+
+    void setCallback(AudioTap* tap, AudioCallback cb, AudioFormat format) {
+        std::lock_guard lock(mutex_);
+        auto& e = entry(tap);
+        e.callback       = cb ? std::make_shared<const AudioCallback>(std::move(cb)) : nullptr;
+        e.converter      = Converter{ .out = format };
+        ensureRunning();
+    }
+
+    void forget(AudioTap* tap) {
+        std::lock_guard lock(mutex_);
+        std::erase_if(taps_, [&](const TapEntry& e) { return e.tap == tap; });
+        for (auto& m : mixers_)
+            std::erase_if(m.sources, [&](const MixSource& s) { return s.tap == tap; });
+    }
+
+    bool isSource(const AudioTap* tap) {
+        std::lock_guard lock(mutex_);
+        return std::ranges::any_of(mixers_, [&](const MixerState& m) {
+            return std::ranges::any_of(m.sources, [&](const MixSource& s) { return s.tap == tap; });
+        });
+    }
+
+    void addMixer(AudioMixer* mixer) {
+        std::lock_guard lock(mutex_);
+        MixerState m;
+        m.owner       = mixer;
+        m.format      = mixer->format_;
+        m.blockFrames = std::max<int>(1, static_cast<int>(mixer->format_.sampleRate * mixer->block_.count() / 1000));
+        m.maxLatency  = mixer->maxLatency_;
+        mixers_.push_back(std::move(m));
+    }
+
+    void removeMixer(AudioMixer* mixer) {
+        std::lock_guard lock(mutex_);
+        std::erase_if(mixers_, [&](const MixerState& m) { return m.owner == mixer; });
+    }
+
+    void addSource(AudioMixer* mixer, AudioTap* tap) {
+        std::lock_guard lock(mutex_);
+        entry(tap);
+        if (auto* m = find(mixer)) {
+            if (std::ranges::none_of(m->sources, [&](const MixSource& s) { return s.tap == tap; }))
+                m->sources.push_back({ .tap = tap, .converter = Converter{ .out = m->format } });
+        }
+        ensureRunning();
+    }
+
+    void removeSource(AudioMixer* mixer, AudioTap* tap) {
+        std::lock_guard lock(mutex_);
+        if (auto* m = find(mixer))
+            std::erase_if(m->sources, [&](const MixSource& s) { return s.tap == tap; });
+    }
+
+    void setMixCallback(AudioMixer* mixer, AudioCallback cb) {
+        std::lock_guard lock(mutex_);
+        if (auto* m = find(mixer))
+            m->callback = cb ? std::make_shared<const AudioCallback>(std::move(cb)) : nullptr;
+    }
+
+    void setMixRecorder(AudioMixer* mixer, std::unique_ptr<WavWriter> wav) {
+        std::unique_ptr<WavWriter> old;
+        {
+            std::lock_guard lock(mutex_);
+            if (auto* m = find(mixer)) { old = std::move(m->recorder); m->recorder = std::move(wav); }
+        }
+        if (old) old->close();
+    }
+
+    ~AudioEngine() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+    }
+
+private:
+    // Shared so the pump can hold one past the lock while the owner replaces it.
+    using CallbackRef = std::shared_ptr<const AudioCallback>;
+
+    struct TapEntry {
+        AudioTap*   tap;
+        CallbackRef callback;
+        Converter   converter;
+    };
+
+    struct MixSource {
+        AudioTap*                             tap;
+        Converter                             converter;
+        std::vector<float>                    fifo;        // mixer format, interleaved
+        int64_t                               headPtsMs = 0;
+        std::chrono::steady_clock::time_point lastData{};
+    };
+
+    // A chunk encoded under the lock, handed to its callback after unlocking.
+    struct Delivery {
+        CallbackRef            callback;
+        std::vector<std::byte> bytes;
+        int                    frames = 0;
+        AudioFormat            format;
+        int64_t                ptsMs  = 0;
+    };
+
+    struct MixerState {
+        AudioMixer*                owner = nullptr;
+        AudioFormat                format;
+        int                        blockFrames = 480;
+        std::chrono::milliseconds  maxLatency{100};
+        CallbackRef                callback;
+        std::unique_ptr<WavWriter> recorder;
+        std::vector<MixSource>     sources;
+    };
+
+    TapEntry& entry(AudioTap* tap) {
+        for (auto& e : taps_) if (e.tap == tap) return e;
+        return taps_.emplace_back(TapEntry{ .tap = tap });
+    }
+
+    MixerState* find(AudioMixer* mixer) {
+        for (auto& m : mixers_) if (m.owner == mixer) return &m;
+        return nullptr;
+    }
+
+    void ensureRunning() {
+        if (running_) return;
+        running_ = true;
+        thread_  = std::thread([this] {
+            while (running_) {
+                {
+                    std::lock_guard lock(mutex_);
+                    pump();
+                }
+                // Callbacks run unlocked: they may call back into the engine
+                // (or Browser::onAudio) without any lock held above them.
+                for (size_t i = 0; i < outboxUsed_; ++i) {
+                    auto& d = outbox_[i];
+                    (*d.callback)({ d.bytes, d.frames, d.format, d.ptsMs });
+                    d.callback.reset();
+                }
+                outboxUsed_ = 0;
+                std::this_thread::sleep_for(kPumpInterval);
+            }
+        });
+    }
+
+    void pump() {
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& e : taps_) {
+            AudioTap::Packet p;
+            while (e.tap->packets_.tryPop(p)) {
+                if (p.sampleRate == 0) {  // end of stream — next packet starts fresh
+                    e.converter.reset();
+                    for (auto& m : mixers_)
+                        for (auto& s : m.sources) if (s.tap == e.tap) s.converter.reset();
+                    continue;
+                }
+                scratch_.resize(static_cast<size_t>(p.frames) * p.channels);
+                e.tap->samples_.pop(scratch_.data(), scratch_.size());
+
+                if (e.callback) {
+                    converted_.clear();
+                    e.converter.process(scratch_.data(), p.frames, p.channels, p.sampleRate, converted_);
+                    deliver(e.callback, e.converter.out, converted_, p.ptsMs);
+                }
+                for (auto& m : mixers_) {
+                    for (auto& s : m.sources) {
+                        if (s.tap != e.tap) continue;
+                        if (s.fifo.empty()) s.headPtsMs = p.ptsMs;
+                        s.converter.process(scratch_.data(), p.frames, p.channels, p.sampleRate, s.fifo);
+                        s.lastData = now;
+                    }
+                }
+            }
+        }
+        for (auto& m : mixers_) mix(m, now);
+    }
+
+    void mix(MixerState& m, std::chrono::steady_clock::time_point now) {
+        const int    ch         = m.format.channels;
+        const size_t blockElems = static_cast<size_t>(m.blockFrames) * ch;
+        const double msPerFrame = 1000.0 / m.format.sampleRate;
+
+        for (;;) {
+            bool anyReady = false, allReady = true;
+            for (const auto& s : m.sources) {
+                const bool ready = s.fifo.size() >= blockElems;
+                const bool stale = now - s.lastData > m.maxLatency;
+                anyReady |= ready;
+                allReady &= ready || stale;
+            }
+            if (!anyReady || !allReady) return;
+
+            mixBuffer_.assign(blockElems, 0.0f);
+            std::optional<int64_t> pts;
+            for (auto& s : m.sources) {
+                const size_t n = std::min(blockElems, s.fifo.size());
+                if (n == 0) continue;
+                if (!pts) pts = s.headPtsMs;
+                for (size_t i = 0; i < n; ++i) mixBuffer_[i] += s.fifo[i];
+                s.fifo.erase(s.fifo.begin(), s.fifo.begin() + static_cast<ptrdiff_t>(n));
+                s.headPtsMs += static_cast<int64_t>(std::lround((n / ch) * msPerFrame));
+            }
+            for (auto& v : mixBuffer_) v = std::clamp(v, -1.0f, 1.0f);
+
+            if (m.callback) {
+                auto& d = post(m.callback, m.blockFrames, m.format, pts.value_or(0));
+                encode(mixBuffer_, m.format.sampleFormat, d.bytes);
+                if (m.recorder) m.recorder->write(d.bytes);
+            } else if (m.recorder) {
+                encode(mixBuffer_, m.format.sampleFormat, bytes_);
+                m.recorder->write(bytes_);
+            }
+        }
+    }
+
+    void deliver(const CallbackRef& cb, const AudioFormat& fmt, const std::vector<float>& pcm, int64_t pts) {
+        if (pcm.empty()) return;
+        auto& d = post(cb, static_cast<int>(pcm.size() / fmt.channels), fmt, pts);
+        encode(pcm, fmt.sampleFormat, d.bytes);
+    }
+
+    // Next outbox slot; slots keep their byte buffers across pumps.
+    Delivery& post(const CallbackRef& cb, int frames, const AudioFormat& fmt, int64_t pts) {
+        if (outboxUsed_ == outbox_.size()) outbox_.emplace_back();
+        auto& d    = outbox_[outboxUsed_++];
+        d.callback = cb;
+        d.frames   = frames;
+        d.format   = fmt;
+        d.ptsMs    = pts;
+        return d;
+    }
+
+    // Recursive because erasing an entry may drop the last reference to a
+    // callback whose captures own another tap, which then forgets itself.
+    std::recursive_mutex    mutex_;
+    std::vector<TapEntry>   taps_;
+    std::vector<MixerState> mixers_;
+    std::atomic<bool>       running_{false};
+    std::thread             thread_;
+
+    // Scratch buffers, reused across pumps.
+    std::vector<float>      scratch_;
+    std::vector<float>      converted_;
+    std::vector<float>      mixBuffer_;
+    std::vector<std::byte>  bytes_;
+
+    // Pump thread only: chunks queued by pump() for delivery after unlocking.
+    std::vector<Delivery>   outbox_;
+    size_t                  outboxUsed_ = 0;
+};
+
+// ─── AudioTap ─────────────────────────────────────────────────────────────────
+
+AudioTap::AudioTap()
+    : samples_(kSampleRingCapacity),
+      packets_(kPacketRingCapacity) {}
+
+AudioTap::~AudioTap() { AudioEngine::instance().forget(this); }
+
+void AudioTap::start(int sampleRate, int channels) {
+    sampleRate_ = sampleRate;
+    channels_   = std::clamp(channels, 1, kMaxChannels);
+    interleaved_.reserve(4096 * static_cast<size_t>(channels_));
+}
+
+void AudioTap::push(const float** planar, int frames, int64_t ptsMs) {
+    if (!planar || frames <= 0 || channels_ == 0 || closed_.load(std::memory_order_relaxed)) return;
+    const size_t n = static_cast<size_t>(frames) * channels_;
+    interleaved_.resize(n);
+    for (int f = 0; f < frames; ++f)
+        for (int c = 0; c < channels_; ++c)
+            interleaved_[static_cast<size_t>(f) * channels_ + c] = planar[c][f];
+
+    // All-or-nothing so packets and samples never drift apart.
+    if (samples_.capacity() - samples_.size() < n ||
+        packets_.capacity() - packets_.size() < 1) {
+        overruns_.fetch_add(static_cast<uint64_t>(frames), std::memory_order_relaxed);
+        return;
+    }
+    samples_.push(interleaved_.data(), n);
+    packets_.tryPush({ ptsMs, frames, sampleRate_, channels_ });
+}
+
+void AudioTap::stop() {
+    packets_.tryPush({ 0, 0, 0, 0 });
+    channels_ = 0;
+}
+
+void AudioTap::setCallback(AudioCallback cb, AudioFormat format) {
+    AudioEngine::instance().setCallback(this, std::move(cb), format);
+}
+
+bool AudioTap::mixed() const { return AudioEngine::instance().isSource(this); }
+
+void AudioTap::close() {
+    closed_.store(true, std::memory_order_relaxed);
+    AudioEngine::instance().forget(this);
+}
+
+// ─── AudioMixer ───────────────────────────────────────────────────────────────
+
+AudioMixer::AudioMixer(AudioFormat format, std::chrono::milliseconds block,
+                       std::chrono::milliseconds maxLatency)
+    : format_(format), block_(block), maxLatency_(maxLatency)
+{
+    AudioEngine::instance().addMixer(this);
+}
+
+AudioMixer::~AudioMixer() {
+    AudioEngine::instance().setMixRecorder(this, nullptr);
+    AudioEngine::instance().removeMixer(this);
+}
+
+void AudioMixer::add(const std::shared_ptr<Browser>& browser) {
+    if (browser) AudioEngine::instance().addSource(this, browser->audioTap().get());
+}
+
+void AudioMixer::remove(const std::shared_ptr<Browser>& browser) {
+    if (browser) AudioEngine::instance().removeSource(this, browser->audioTap().get());
+}
+
+void AudioMixer::onMix(AudioCallback cb) {
+    AudioEngine::instance().setMixCallback(this, std::move(cb));
+}
+
+std::expected<void, AudioError> AudioMixer::recordTo(const std::string& wavPath) {
+    auto wav = WavWriter::open(wavPath, format_);
+    if (!wav) return std::unexpected(wav.error());
+    AudioEngine::instance().setMixRecorder(this, std::move(*wav));
+    return {};
+}
+
+void AudioMixer::stopRecording() {
+    AudioEngine::instance().setMixRecorder(this, nullptr);
+}
+
+// ─── WavWriter ────────────────────────────────────────────────────────────────
+
+WavWriter::~WavWriter() { close(); }
+
+std::expected<std::unique_ptr<WavWriter>, AudioError>
+WavWriter::open(const std::string& path, AudioFormat format) {
+    auto wav = std::unique_ptr<WavWriter>(new WavWriter(format));
+    wav->file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!wav->file_) return std::unexpected(AudioError::OpenFailed);
+    wav->writeHeader();
+    return wav;
+}
+
+void WavWriter::writeHeader() {
+    const uint32_t dataBytes = static_cast<uint32_t>(std::min<uint64_t>(dataBytes_, 0xFFFFFFFFu - 36));
+    const bool     isFloat   = format_.sampleFormat == SampleFormat::Float32;
+    file_.seekp(0);
+    file_.write("RIFF", 4);
+    putLE(file_, 36 + dataBytes, 4);
+    file_.write("WAVEfmt ", 8);
+    putLE(file_, 16, 4);
+    putLE(file_, isFloat ? 3 : 1, 2);  // WAVE_FORMAT_IEEE_FLOAT / WAVE_FORMAT_PCM
+    putLE(file_, static_cast<uint32_t>(format_.channels), 2);
+    putLE(file_, static_cast<uint32_t>(format_.sampleRate), 4);
+    putLE(file_, static_cast<uint32_t>(format_.sampleRate * format_.bytesPerFrame()), 4);
+    putLE(file_, static_cast<uint32_t>(format_.bytesPerFrame()), 2);
+    putLE(file_, static_cast<uint32_t>(format_.bytesPerSample() * 8), 2);
+    file_.write("data", 4);
+    putLE(file_, dataBytes, 4);
+}
+
+std::expected<void, AudioError> WavWriter::write(std::span<const std::byte> interleaved) {
+    file_.write(reinterpret_cast<const char*>(interleaved.data()),
+                static_cast<std::streamsize>(interleaved.size()));
+    dataBytes_ += interleaved.size();
+    if (!file_) return std::unexpected(AudioError::WriteFailed);
+    return {};
+}
+
+void WavWriter::close() {
+    if (!file_.is_open()) return;
+    writeHeader();
+    file_.close();
+}
+
+} // namespace bamboo
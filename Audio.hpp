@@ -0,0 +1,194 @@
+#pragma once
+// bamboo/Audio.hpp
+// Page audio capture: CefAudioHandler → lock-free ring → Bamboo audio thread.
+//
+// CEF delivers planar float PCM on its own audio thread. Bamboo interleaves
+// it into a per-browser SPSC ring and returns immediately; a single
+// background thread drains every ring, converts to the requested format,
+// mixes across windows and writes WAV files. The UI thread is never involved.
+
+#include "bamboo/SpscRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bamboo {
+
+class Browser;
+
+// ─── Formats ──────────────────────────────────────────────────────────────────
+
+enum class SampleFormat {
+    Float32,  // [-1, 1]
+    Int16,
+};
+
+struct AudioFormat {
+    int          sampleRate   = 48000;
+    int          channels     = 2;
+    SampleFormat sampleFormat = SampleFormat::Float32;
+
+    [[nodiscard]] int bytesPerSample() const { return sampleFormat == SampleFormat::Int16 ? 2 : 4; }
+    [[nodiscard]] int bytesPerFrame()  const { return bytesPerSample() * channels; }
+};
+
+/**
+ * @brief A block of interleaved PCM in the consumer's requested format.
+ *
+ * `data` is only valid during the callback. `ptsMs` is the presentation
+ * timestamp of the first frame in milliseconds since the Unix epoch, as
+ * reported by Chromium — use it to line audio up with captured video.
+ */
+struct AudioChunk {
+    std::span<const std::byte> data;
+    int                        frames;
+    AudioFormat                format;
+    int64_t                    ptsMs;
+};
+
+using AudioCallback = std::function<void(const AudioChunk&)>;
+
+enum class AudioError {
+    OpenFailed,
+    WriteFailed,
+};
+
+// ─── WAV writer ───────────────────────────────────────────────────────────────
+
+/**
+ * @brief Streams PCM to a RIFF/WAVE file; sizes are patched in on close().
+ */
+class WavWriter {
+public:
+    ~WavWriter();
+
+    WavWriter(const WavWriter&)            = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    [[nodiscard]]
+    static std::expected<std::unique_ptr<WavWriter>, AudioError>
+    open(const std::string& path, AudioFormat format);
+
+    std::expected<void, AudioError> write(std::span<const std::byte> interleaved);
+    void close();
+
+    [[nodiscard]] const AudioFormat& format() const { return format_; }
+
+private:
+    explicit WavWriter(AudioFormat format) : format_(format) {}
+    void writeHeader();
+
+    std::ofstream file_;
+    AudioFormat   format_;
+    uint64_t      dataBytes_ = 0;
+};
+
+// ─── Per-browser tap (filled from CEF's audio thread) ────────────────────────
+
+/**
+ * @brief Lock-free landing zone for one browser's audio stream.
+ *
+ * start()/push()/stop() are called only from CEF's audio thread; everything
+ * else happens on the Bamboo audio thread. Owned by Browser.
+ */
+class AudioTap {
+public:
+    AudioTap();
+    ~AudioTap();
+
+    // Producer side (CEF audio thread).
+    void start(int sampleRate, int channels);
+    void push(const float** planar, int frames, int64_t ptsMs);
+    void stop();
+
+    /**
+     * Deliver this tap's stream, converted to `format`, on the Bamboo audio
+     * thread, outside any engine lock. Pass an empty callback to stop; a
+     * chunk already being delivered may still arrive. Safe from any thread.
+     */
+    void setCallback(AudioCallback cb, AudioFormat format);
+
+    /** True while an AudioMixer uses this tap as a source. */
+    [[nodiscard]] bool mixed() const;
+
+    /**
+     * Leave the audio thread and ignore any further packets. For a tap the
+     * browser has let go of while CEF's current stream still holds it.
+     */
+    void close();
+
+    /** Number of frames dropped because the consumer fell behind. */
+    [[nodiscard]] uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+
+private:
+    friend class AudioEngine;
+
+    struct Packet {
+        int64_t ptsMs;
+        int32_t frames;
+        int32_t sampleRate;  // 0 = end of stream
+        int32_t channels;
+    };
+
+    static constexpr int kMaxChannels = 8;
+
+    SpscRing<float>       samples_;
+    SpscRing<Packet>      packets_;
+    std::vector<float>    interleaved_;  // producer scratch
+    int                   sampleRate_ = 0;
+    int                   channels_   = 0;
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<bool>     closed_{false};
+};
+
+// ─── Mixer ────────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Mixes the audio of several browsers into one stream.
+ *
+ * Sources are aligned block by block; a source that has no data for longer
+ * than `maxLatency` (paused video, silent tab) is treated as silence so the
+ * others are not held back.
+ *
+ * Example:
+ *   bamboo::AudioMixer mix({ .sampleRate = 48000, .channels = 2 });
+ *   mix.add(win1); mix.add(win2);
+ *   mix.recordTo("screencast.wav");
+ */
+class AudioMixer {
+public:
+    explicit AudioMixer(AudioFormat format = {},
+                        std::chrono::milliseconds block      = std::chrono::milliseconds(10),
+                        std::chrono::milliseconds maxLatency = std::chrono::milliseconds(100));
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer&)            = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    void add(const std::shared_ptr<Browser>& browser);
+    void remove(const std::shared_ptr<Browser>& browser);
+
+    /** Receive mixed blocks on the Bamboo audio thread. */
+    void onMix(AudioCallback cb);
+
+    std::expected<void, AudioError> recordTo(const std::string& wavPath);
+    void stopRecording();
+
+    [[nodiscard]] const AudioFormat& format() const { return format_; }
+
+private:
+    friend class AudioEngine;
+    AudioFormat               format_;
+    std::chrono::milliseconds block_;
+    std::chrono::milliseconds maxLatency_;
+};
+
+} // namespace bamboo
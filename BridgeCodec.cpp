@@ -0,0 +1,106 @@
+// bamboo/BridgeCodec.cpp - see include/bamboo/BridgeCodec.hpp for API docs
+#include "bamboo/BridgeCodec.hpp"
+#include <nlohmann/json.hpp>
+#include <format>
+
+using json = nlohmann::json;
+
+namespace bamboo::bridge {
+
+json jsValueToJson(const JsValue& v) {
+    return std::visit([]<typename T>(const T& val) -> json {
+        if constexpr (std::is_same_v<T, std::monostate>) return nullptr;
+        else return val;
+    }, v);
+}
+
+JsValue jsonToJsValue(const json& j) {
+    if (j.is_null())    return std::monostate{};
+    if (j.is_boolean()) return j.get<bool>();
+    if (j.is_number())  return j.get<double>();
+    if (j.is_string())  return j.get<std::string>();
+    return std::monostate{};
+}
+
+std::string buildBridgeCSS(const WindowStyle& style) {
+    std::string css;
+    switch (style.scrollbar) {
+        case ScrollbarStyle::Hidden:
+            css += "::-webkit-scrollbar{display:none}*{-ms-overflow-style:none;scrollbar-width:none}";
+            break;
+        case ScrollbarStyle::Overlay:
+            css += "::-webkit-scrollbar{width:8px;height:8px}"
+                   "::-webkit-scrollbar-track{background:transparent}"
+                   "::-webkit-scrollbar-thumb{background:rgba(0,0,0,.3);border-radius:4px}";
+            break;
+        case ScrollbarStyle::NativeOverlay:  // compositor-drawn; see AppConfig::nativeOverlayScrollbars
+        default: break;
+    }
+    if (!style.allowTextSelection)
+        css += "*{user-select:none;-webkit-user-select:none}";
+    return css;
+}
+
+uint64_t hashCSS(std::string_view css) {
+    uint64_t h = 1469598103934665603ull;  // FNV-1a
+    for (unsigned char c : css) h = (h ^ c) * 1099511628211ull;
+    return h;
+}
+
+void mergeStyleJson(WindowStyle& s, const json& j) {
+    if (j.contains("cornerRadius"))      s.cornerRadius       = j["cornerRadius"].get<int>();
+    if (j.contains("transparent"))       s.transparent        = j["transparent"].get<bool>();
+    if (j.contains("backgroundOpacity")) s.backgroundOpacity  = j["backgroundOpacity"].get<float>();
+    if (j.contains("alwaysOnTop"))       s.alwaysOnTop        = j["alwaysOnTop"].get<bool>();
+}
+
+std::string dispatchScript(std::string_view event, std::string_view payload) {
+    return std::format("window.bamboo._dispatch({},{});", json(event).dump(), payload);
+}
+
+std::string evalScript(std::string_view script, int id) {
+    return std::format(R"js(
+        (async()=>{{try{{const r=await(async()=>{{return({});}})();
+        window.bamboo.send('__evalResult',{{id:{},value:r,error:null}})}}
+        catch(e){{window.bamboo.send('__evalResult',{{id:{},value:null,error:e.message}})}}}})();
+    )js", script, id, id);
+}
+
+std::string resolveCallScript(std::string_view id, const JsValue& result) {
+    return std::format("window.bamboo._resolveCall({},{},null);", json(id).dump(), jsValueToJson(result).dump());
+}
+
+std::string rejectCallScript(std::string_view id, std::string_view message) {
+    return std::format("window.bamboo._resolveCall({},null,{});", json(id).dump(), json(message).dump());
+}
+
+std::string rejectUnknownCallScript(std::string_view id, std::string_view name) {
+    return rejectCallScript(id, std::format("Unknown: {}", name));
+}
+
+std::optional<RoutedMessage> routeRequest(std::string_view request) {
+    auto j = json::parse(request, nullptr, false);
+    if (!j.is_object()) return std::nullopt;
+    auto type = j.find("type");
+    if (type == j.end() || !type->is_string()) return std::nullopt;
+    const auto& t = type->get_ref<const std::string&>();
+
+    auto field = [&](const char* key) -> std::string {
+        auto it = j.find(key);
+        return it == j.end() ? "null" : it->dump();
+    };
+    if (t == "message") {
+        auto event = j.find("event");
+        if (event == j.end() || !event->is_string()) return std::nullopt;
+        return RoutedMessage{ event->get<std::string>(), field("data") };
+    }
+    // These handlers read their fields from the request object itself.
+    if (t == "call")           return RoutedMessage{ "__call",           std::string(request) };
+    if (t == "animateStyle")   return RoutedMessage{ "__animateStyle",   std::string(request) };
+    if (t == "windowOp")       return RoutedMessage{ "__windowOp",       std::string(request) };
+    if (t == "setStyle")       return RoutedMessage{ "__setStyle",       field("style") };
+    if (t == "setDragRegions") return RoutedMessage{ "__setDragRegions", field("regions") };
+    return std::nullopt;
+}
+
+} // namespace bamboo::bridge
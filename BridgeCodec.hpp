@@ -0,0 +1,68 @@
+#pragma once
+// bamboo/BridgeCodec.hpp
+// The JS bridge's wire format: value conversion, style CSS and the scripts
+// the browser process sends to window.bamboo. No CEF — callable (and
+// benchmarkable) without a browser or a display.
+
+#include "bamboo/WindowStyle.hpp"
+#include <nlohmann/json_fwd.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace bamboo {
+
+// ─── JS value type ────────────────────────────────────────────────────────────
+
+using JsValue = std::variant<std::monostate, bool, double, std::string>;
+
+namespace bridge {
+
+/** null / bool / number / string; anything else becomes null. */
+[[nodiscard]] nlohmann::json jsValueToJson(const JsValue& v);
+[[nodiscard]] JsValue        jsonToJsValue(const nlohmann::json& j);
+
+/** The stylesheet the renderer attaches for `style` (scrollbars, selection). */
+[[nodiscard]] std::string buildBridgeCSS(const WindowStyle& style);
+
+/** FNV-1a of the stylesheet; equal hashes skip the IPC. */
+[[nodiscard]] uint64_t hashCSS(std::string_view css);
+
+/** Fields window.bamboo.setStyle / animateStyle may set from JS. */
+void mergeStyleJson(WindowStyle& style, const nlohmann::json& j);
+
+/** `window.bamboo._dispatch(event, payload)` — payload is JSON text, inserted as-is. */
+[[nodiscard]] std::string dispatchScript(std::string_view event, std::string_view payload);
+
+/** Runs `script` as an expression and posts its value back as `__evalResult` #id. */
+[[nodiscard]] std::string evalScript(std::string_view script, int id);
+
+/** Settles the bamboo.call() promise `id` with `result`. */
+[[nodiscard]] std::string resolveCallScript(std::string_view id, const JsValue& result);
+
+/** Rejects the bamboo.call() promise `id` with `message`. */
+[[nodiscard]] std::string rejectCallScript(std::string_view id, std::string_view message);
+
+/** Rejects the bamboo.call() promise `id` for a name nothing is bound to. */
+[[nodiscard]] std::string rejectUnknownCallScript(std::string_view id, std::string_view name);
+
+// ─── Renderer → browser ───────────────────────────────────────────────────────
+
+/** A window.bamboo request as the event/payload Browser::fireMessage takes. */
+struct RoutedMessage {
+    std::string event;
+    std::string data;   // JSON text
+};
+
+/**
+ * Maps a window.bamboo request — {type:'message'|'call'|'setStyle'|
+ * 'animateStyle'|'setDragRegions'|'windowOp', …}, as carried by
+ * kBridgeMessage — to its event: the user event for 'message', the
+ * internal "__call", "__setStyle", … otherwise. nullopt if malformed.
+ */
+[[nodiscard]] std::optional<RoutedMessage> routeRequest(std::string_view request);
+
+} // namespace bridge
+} // namespace bamboo
@@ -0,0 +1,219 @@
+// bamboo/BridgeRecorder.cpp - see include/bamboo/BridgeRecorder.hpp for API docs
+#include "bamboo/BridgeRecorder.hpp"
+#include "bamboo/Browser.hpp"
+#include <algorithm>
+
+namespace bamboo {
+
+namespace {
+
+constexpr char     kMagic[8]   = { 'B', 'M', 'B', 'R', 'L', 'O', 'G', '\0' };
+constexpr uint32_t kVersion    = 1;
+constexpr size_t   kHeaderSize = sizeof kMagic + 4 + 8;
+
+int64_t steadyUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t epochUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) { out += static_cast<char>(v | 0x80); v >>= 7; }
+    out += static_cast<char>(v);
+}
+
+void putLE(std::string& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out += static_cast<char>(v >> (8 * i));
+}
+
+uint64_t getLE(const char* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+    return v;
+}
+
+} // namespace
+
+// ─── Lifetime ─────────────────────────────────────────────────────────────────
+
+BridgeRecorder::BridgeRecorder(BridgeRecorderConfig config)
+    : config_(std::move(config)),
+      ring_(std::max(config_.ringBytes, RecordRing<RecordHeader>::frameBytes() + 4096)) {}
+
+BridgeRecorder::~BridgeRecorder() {
+    ring_.stop();
+}
+
+std::expected<std::shared_ptr<BridgeRecorder>, BridgeLogError>
+BridgeRecorder::open(BridgeRecorderConfig config) {
+    auto rec = std::shared_ptr<BridgeRecorder>(new BridgeRecorder(std::move(config)));
+    rec->file_.open(rec->config_.path, std::ios::binary | std::ios::trunc);
+    if (!rec->file_) return std::unexpected(BridgeLogError::OpenFailed);
+
+    std::string header(kMagic, sizeof kMagic);
+    putLE(header, kVersion, 4);
+    putLE(header, static_cast<uint64_t>(epochUs()), 8);
+    rec->file_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    rec->bytes_ = header.size();
+
+    rec->startUs_ = steadyUs();
+    rec->ring_.start(rec->config_.flushInterval,
+        [r = rec.get()](const RecordHeader& h, std::span<const std::byte> body) { r->write(h, body); },
+        [r = rec.get()](bool) { r->file_.flush(); });
+    return rec;
+}
+
+BridgeRecorder::Stats BridgeRecorder::stats() const {
+    return { records_.load(std::memory_order_relaxed), bytes_.load(std::memory_order_relaxed),
+             dropped_.load(std::memory_order_relaxed) };
+}
+
+// ─── Producer (UI thread) ─────────────────────────────────────────────────────
+
+bool BridgeRecorder::record(BridgeDirection direction, int window,
+                            std::string_view event, std::string_view data) {
+    const RecordHeader h{
+        .timeUs     = steadyUs() - startUs_,
+        .window     = window,
+        .eventBytes = static_cast<uint32_t>(event.size()),
+        .direction  = static_cast<uint8_t>(direction),
+        .reserved   = {},
+    };
+    if (!ring_.push(h, { recordBytes(event), recordBytes(data) })) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// ─── Writer thread ────────────────────────────────────────────────────────────
+
+void BridgeRecorder::write(const RecordHeader& h, std::span<const std::byte> body) {
+    const std::string_view event(reinterpret_cast<const char*>(body.data()), h.eventBytes);
+    const std::string_view data(event.data() + h.eventBytes, body.size() - h.eventBytes);
+
+    out_.clear();
+    out_ += static_cast<char>(h.direction);
+    putVarint(out_, static_cast<uint64_t>(std::max<int64_t>(0, h.timeUs - lastUs_)));
+    putVarint(out_, static_cast<uint32_t>(h.window));
+    lastUs_ = std::max(lastUs_, h.timeUs);
+
+    if (auto it = names_.find(event); it != names_.end()) {
+        putVarint(out_, it->second);
+    } else {
+        names_.emplace(std::string(event), static_cast<uint32_t>(names_.size() + 1));
+        putVarint(out_, 0);
+        putVarint(out_, event.size());
+        out_ += event;
+    }
+    putVarint(out_, data.size());
+    out_ += data;
+
+    file_.write(out_.data(), static_cast<std::streamsize>(out_.size()));
+    bytes_.fetch_add(out_.size(), std::memory_order_relaxed);
+    records_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ─── Reading ──────────────────────────────────────────────────────────────────
+
+std::expected<BridgeLog, BridgeLogError> BridgeLog::open(const std::string& path) {
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) return std::unexpected(BridgeLogError::OpenFailed);
+    BridgeLog log;
+    log.buffer_ = std::make_unique<std::string>(static_cast<size_t>(f.tellg()), '\0');
+    f.seekg(0);
+    if (!f.read(log.buffer_->data(), static_cast<std::streamsize>(log.buffer_->size())))
+        return std::unexpected(BridgeLogError::OpenFailed);
+
+    const std::string_view buf = *log.buffer_;
+    if (buf.size() < kHeaderSize || buf.substr(0, sizeof kMagic) != std::string_view(kMagic, sizeof kMagic) ||
+        getLE(buf.data() + sizeof kMagic, 4) != kVersion)
+        return std::unexpected(BridgeLogError::BadFormat);
+    log.startEpochUs_ = static_cast<int64_t>(getLE(buf.data() + sizeof kMagic + 4, 8));
+
+    size_t pos = kHeaderSize;
+    auto varint = [&](uint64_t& v) {
+        v = 0;
+        for (int shift = 0; pos < buf.size() && shift < 64; shift += 7) {
+            const auto b = static_cast<unsigned char>(buf[pos++]);
+            v |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    };
+    auto bytes = [&](std::string_view& out) {
+        uint64_t n = 0;
+        if (!varint(n) || n > buf.size() - pos) return false;
+        out = buf.substr(pos, n);
+        pos += n;
+        return true;
+    };
+
+    int64_t time = 0;
+    while (pos < buf.size()) {
+        const auto direction = static_cast<uint8_t>(buf[pos++]);
+        uint64_t dt = 0, window = 0, ref = 0;
+        BridgeRecord r{};
+        bool ok = direction >= 1 && direction <= 3 && varint(dt) && varint(window) && varint(ref);
+        if (ok && ref == 0) {
+            ok = bytes(r.event);
+            if (ok) log.names_.push_back(r.event);
+        } else if (ok) {
+            ok = ref <= log.names_.size();
+            if (ok) r.event = log.names_[ref - 1];
+        }
+        if (!ok || !bytes(r.data)) { log.truncated_ = true; break; }
+
+        time += static_cast<int64_t>(dt);
+        r.direction = static_cast<BridgeDirection>(direction);
+        r.timeUs    = time;
+        r.window    = static_cast<int>(window);
+        log.records_.push_back(r);
+    }
+    return log;
+}
+
+// ─── Replay ───────────────────────────────────────────────────────────────────
+
+BridgeReplayStats replayBridgeLog(const BridgeLog& log, Browser& target,
+                                  const BridgeReplayOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    auto replayed = [&](const BridgeRecord& r) {
+        return r.direction == BridgeDirection::Inbound && (!options.window || r.window == *options.window);
+    };
+    // The schedule starts at the first replayed record, not at recorder open.
+    auto first = std::ranges::find_if(log.records(), replayed);
+    if (first == log.records().end()) return {};
+    const int64_t originUs = first->timeUs;
+
+    BridgeReplayStats stats;
+    const auto begin = Clock::now();
+    for (int loop = 0; loop < std::max(1, options.loops); ++loop) {
+        const auto loopStart = Clock::now();
+        for (const auto& r : log.records()) {
+            if (!replayed(r)) continue;
+            if (options.speed > 0) {
+                const auto due = loopStart + std::chrono::microseconds(
+                    static_cast<int64_t>(static_cast<double>(r.timeUs - originUs) / options.speed));
+                const auto now = Clock::now();
+                if (now < due) std::this_thread::sleep_until(due);
+                else stats.maxLag = std::max(stats.maxLag,
+                                             std::chrono::duration_cast<std::chrono::microseconds>(now - due));
+            }
+            const auto t0 = Clock::now();
+            target.fireMessage(r.event, r.data);
+            const auto took = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0);
+            stats.handlerTime += took;
+            ++stats.dispatched;
+            if (options.onDispatched) options.onDispatched(r, took);
+        }
+    }
+    stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+    return stats;
+}
+
+} // namespace bamboo
@@ -0,0 +1,187 @@
+#pragma once
+// bamboo/BridgeRecorder.hpp
+// Bridge traffic recording to a compact binary log, and offline replay of
+// the recorded inbound traffic into a detached Browser (no CEF involved).
+//
+// Like ConsoleSink, the UI thread only copies each message into a byte
+// ring; event-name interning, varint encoding and file I/O happen on the
+// recorder's writer thread.
+
+#include "bamboo/RecordRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bamboo {
+
+class Browser;
+
+// ─── Records ──────────────────────────────────────────────────────────────────
+
+enum class BridgeDirection : uint8_t {
+    Inbound    = 1,  // fireMessage(event, data): bamboo.send, bamboo.call ("__call"), internals
+    CallResult = 2,  // a bound function's return value; event = function name, data = JSON
+    Outbound   = 3,  // sendMessage(event, payload)
+};
+
+struct BridgeRecord {
+    BridgeDirection  direction;
+    int64_t          timeUs;    // since the recording started
+    int              window;    // CEF browser id (0 for detached browsers)
+    std::string_view event;
+    std::string_view data;
+};
+
+enum class BridgeLogError {
+    OpenFailed,
+    BadFormat,      // not a bridge log, or an unsupported version
+};
+
+// ─── Recorder ─────────────────────────────────────────────────────────────────
+
+struct BridgeRecorderConfig {
+    std::string path;                                 // truncated on open
+    size_t      ringBytes = size_t(8) << 20;          // bigger messages are dropped
+    std::chrono::milliseconds flushInterval{50};
+};
+
+/**
+ * @brief Writes every bridge message of any number of windows to one file.
+ *
+ * File layout (little endian, varints are LEB128):
+ *   "BMBRLOG\0"  u32 version  u64 start (Unix µs)
+ *   per record:  u8 direction  varint Δt µs  varint window
+ *                varint event  [varint len + name, when event == 0]
+ *                varint len + data
+ * Event names are interned: 0 introduces a new name inline, n refers to
+ * the n-th one. A record cut short by a crash is ignored on reading.
+ *
+ * The record calls are wait-free and must come from one thread (Browser
+ * calls them on the CEF UI thread). Destroying the recorder drains and
+ * closes the file.
+ *
+ * Example:
+ *   auto rec = bamboo::BridgeRecorder::open({ .path = "bridge.bbr" }).value();
+ *   win->setBridgeRecorder(rec);
+ */
+class BridgeRecorder {
+public:
+    struct Stats {
+        uint64_t records;       // on disk
+        uint64_t bytes;
+        uint64_t dropped;       // ring full, or a message larger than the ring
+    };
+
+    ~BridgeRecorder();
+
+    BridgeRecorder(const BridgeRecorder&)            = delete;
+    BridgeRecorder& operator=(const BridgeRecorder&) = delete;
+
+    [[nodiscard]]
+    static std::expected<std::shared_ptr<BridgeRecorder>, BridgeLogError>
+    open(BridgeRecorderConfig config);
+
+    /** Enqueue one record. Returns false if it was dropped. */
+    bool record(BridgeDirection direction, int window, std::string_view event, std::string_view data);
+
+    [[nodiscard]] Stats stats() const;
+
+private:
+    // Fixed part of every record in the ring; event name + data follow.
+    struct RecordHeader {
+        int64_t  timeUs;
+        int32_t  window;
+        uint32_t eventBytes;
+        uint8_t  direction;
+        uint8_t  reserved[3];
+    };
+
+    explicit BridgeRecorder(BridgeRecorderConfig config);
+    void write(const RecordHeader& h, std::span<const std::byte> body);
+
+    BridgeRecorderConfig config_;
+
+    // Producer (UI thread) state
+    int64_t                startUs_ = 0;   // steady clock
+
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    // Writer thread state
+    std::ofstream          file_;
+    std::string            out_;
+    std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> names_;
+    int64_t                lastUs_ = 0;
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    RecordRing<RecordHeader> ring_;   // last: its writer thread uses the state above
+};
+
+// ─── Reading and replay ───────────────────────────────────────────────────────
+
+/**
+ * @brief A recorded log, loaded whole so replay never waits on the disk.
+ *
+ * Records are views into the log's own buffer; they live as long as it does.
+ */
+class BridgeLog {
+public:
+    [[nodiscard]] static std::expected<BridgeLog, BridgeLogError> open(const std::string& path);
+
+    [[nodiscard]] const std::vector<BridgeRecord>& records() const { return records_; }
+    [[nodiscard]] int64_t startEpochUs() const { return startEpochUs_; }
+    /** True if the file ended mid-record (the recording process died). */
+    [[nodiscard]] bool truncated() const { return truncated_; }
+
+private:
+    std::unique_ptr<std::string>  buffer_;   // stable address for the views
+    std::vector<std::string_view> names_;
+    std::vector<BridgeRecord>     records_;
+    int64_t                       startEpochUs_ = 0;
+    bool                          truncated_ = false;
+};
+
+struct BridgeReplayOptions {
+    double             speed  = 0;   // 0 = as fast as possible, 1 = recorded timing, 2 = twice as fast
+    std::optional<int> window;       // only this window's traffic; default all
+    int                loops  = 1;
+    /** Called after each dispatched record with the time fireMessage took. */
+    std::function<void(const BridgeRecord&, std::chrono::nanoseconds)> onDispatched;
+};
+
+struct BridgeReplayStats {
+    uint64_t                  dispatched = 0;
+    std::chrono::nanoseconds  elapsed{0};
+    std::chrono::nanoseconds  handlerTime{0};   // inside fireMessage
+    std::chrono::microseconds maxLag{0};        // worst lateness vs. the schedule (speed > 0)
+};
+
+/**
+ * @brief Feed the log's inbound records to `target` through fireMessage.
+ *
+ * Meant for a Browser::createDetached() window with the app's handlers
+ * (onMessage, bindFunction) registered, so handler code can be benchmarked
+ * and profiled against production traffic without a renderer. Runs on the
+ * calling thread; CallResult and Outbound records are not replayed.
+ */
+BridgeReplayStats replayBridgeLog(const BridgeLog& log, Browser& target,
+                                  const BridgeReplayOptions& options = {});
+
+} // namespace bamboo
@@ -0,0 +1,63 @@
+// bamboo/BridgeStats.cpp - see include/bamboo/BridgeStats.hpp for API docs
+#include "bamboo/BridgeStats.hpp"
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace bamboo {
+
+namespace {
+
+void mergeEvents(BridgeStats::EventMap& into, const BridgeStats::EventMap& from) {
+    for (const auto& [name, s] : from) {
+        auto& dst = into[name];
+        dst.count += s.count;
+        dst.bytes += s.bytes;
+    }
+}
+
+json eventsJson(const BridgeStats::EventMap& events) {
+    json out = json::object();
+    for (const auto& [name, s] : events)
+        out[name] = { {"count", s.count}, {"bytes", s.bytes} };
+    return out;
+}
+
+json histogramJson(const Histogram& h) {
+    return {
+        {"count", h.count()},
+        {"mean",  h.mean()},
+        {"p50",   h.percentile(0.50)},
+        {"p90",   h.percentile(0.90)},
+        {"p99",   h.percentile(0.99)},
+        {"p999",  h.percentile(0.999)},
+        {"max",   h.max()},
+    };
+}
+
+} // namespace
+
+void BridgeStats::merge(const BridgeStats& other) {
+    mergeEvents(inbound, other.inbound);
+    mergeEvents(outbound, other.outbound);
+    handlerUs.merge(other.handlerUs);
+    callUs.merge(other.callUs);
+    callRoundTripUs.merge(other.callRoundTripUs);
+    evalRoundTripUs.merge(other.evalRoundTripUs);
+}
+
+std::string BridgeStats::toJson() const {
+    json j = {
+        {"inbound",  eventsJson(inbound)},
+        {"outbound", eventsJson(outbound)},
+        {"latencyUs", {
+            {"handler",       histogramJson(handlerUs)},
+            {"call",          histogramJson(callUs)},
+            {"callRoundTrip", histogramJson(callRoundTripUs)},
+            {"evalRoundTrip", histogramJson(evalRoundTripUs)},
+        }},
+    };
+    return j.dump();
+}
+
+} // namespace bamboo
@@ -0,0 +1,58 @@
+#pragma once
+// bamboo/BridgeStats.hpp
+// Always-on counters for the JS ↔ C++ bridge: per-event traffic and latency
+// histograms. Recorded on the CEF UI thread; read via Browser::bridgeStats(),
+// App::bridgeStats() or window.bamboo.stats().
+
+#include "bamboo/Histogram.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace bamboo {
+
+struct EventStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;  // payload bytes (JSON text)
+};
+
+/**
+ * @brief Bridge traffic and latency for one window (or, merged, the whole app).
+ *
+ * All latencies are in microseconds.
+ */
+struct BridgeStats {
+    struct StringHash : std::hash<std::string_view> {
+        using is_transparent = void;
+    };
+    using EventMap = std::unordered_map<std::string, EventStats, StringHash, std::equal_to<>>;
+
+    EventMap inbound;    // JS → C++, keyed by event name (bound calls are "__call")
+    EventMap outbound;   // C++ → JS: sendMessage() events and "evalJS", plus "executeJS"
+                         // which totals every script sent, including those two
+
+    Histogram handlerUs;        // fireMessage dispatch time, all events
+    Histogram callUs;           // bound C++ function execution
+    Histogram callRoundTripUs;  // bamboo.call() as seen from JS (reported by the page)
+    Histogram evalRoundTripUs;  // evalJS() issue → result back on the UI thread
+
+    void recordInbound(std::string_view event, size_t bytes)  { bump(inbound, event, bytes); }
+    void recordOutbound(std::string_view event, size_t bytes) { bump(outbound, event, bytes); }
+
+    void merge(const BridgeStats& other);
+
+    /** Compact JSON: {"inbound":{ev:{count,bytes}},…,"latencyUs":{name:{count,p50,…}}} */
+    [[nodiscard]] std::string toJson() const;
+
+private:
+    static void bump(EventMap& map, std::string_view event, size_t bytes) {
+        auto it = map.find(event);
+        if (it == map.end()) it = map.emplace(std::string(event), EventStats{}).first;
+        ++it->second.count;
+        it->second.bytes += bytes;
+    }
+};
+
+} // namespace bamboo
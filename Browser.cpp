@@ -1,62 +1,87 @@
 // bamboo/Browser.cpp - see include/bamboo/Browser.hpp for API docs
 #include "bamboo/Browser.hpp"
+#include "bamboo/BridgeCodec.hpp"
+#include "bamboo/PngWriter.hpp"
+#include "bamboo/JsBridge.hpp"
+#include "bamboo/Trace.hpp"
+#include "bamboo/Watchdog.hpp"
 #include "bamboo/platform/StyleApplicator.hpp"
+#include "include/cef_process_message.h"
 #include "include/cef_task.h"
 #include "include/wrapper/cef_helpers.h"
 #include <nlohmann/json.hpp>
 #include <format>
 #include <print>
+#include <algorithm>
 #include <cmath>
+#include <filesystem>
 
 using json = nlohmann::json;
 
 namespace bamboo {
 
-namespace {
-
-json jsValueToJson(const JsValue& v) {
-    return std::visit([]<typename T>(const T& val) -> json {
-        if constexpr (std::is_same_v<T, std::monostate>) return nullptr;
-        else return val;
-    }, v);
-}
-
-JsValue jsonToJsValue(const json& j) {
-    if (j.is_null())   return std::monostate{};
-    if (j.is_bool())   return j.get<bool>();
-    if (j.is_number()) return j.get<double>();
-    if (j.is_string()) return j.get<std::string>();
-    return std::monostate{};
-}
-
-std::string buildBridgeCSS(const WindowStyle& style) {
-    std::string css;
-    switch (style.scrollbar) {
-        case ScrollbarStyle::Hidden:
-            css += "::-webkit-scrollbar{display:none}*{-ms-overflow-style:none;scrollbar-width:none}";
-            break;
-        case ScrollbarStyle::Overlay:
-            css += "::-webkit-scrollbar{width:8px;height:8px}"
-                   "::-webkit-scrollbar-track{background:transparent}"
-                   "::-webkit-scrollbar-thumb{background:rgba(0,0,0,.3);border-radius:4px}";
-            break;
-        default: break;
-    }
-    if (!style.allowTextSelection)
-        css += "*{user-select:none;-webkit-user-select:none}";
-    return css;
+// ─── Full-page capture state ──────────────────────────────────────────────────
+
+struct FullPageCapture {
+    std::unique_ptr<PngWriter>  png;
+    std::string                 path;
+    std::function<void(bool)>   done;
+    int  pageHeight    = 0;
+    int  nextRow       = 0;  // next page row to encode
+    int  tileScrollY   = 0;  // scroll offset of the tile being painted
+    int  restoreY      = 0;
+    bool awaitingPaint = false;
+};
+
+// ─── Native style animation state ─────────────────────────────────────────────
+
+struct StyleAnimationState {
+    WindowStyle                           from, to;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::milliseconds             duration;
+    Easing                                easing;
+    std::function<void(bool)>             done;
+    uint64_t                              generation;
+};
+
+// Live browsers, for app-wide snapshots. Touched only on the UI thread.
+static std::vector<Browser*>& browserRegistry() {
+    static std::vector<Browser*> live;
+    return live;
 }
 
-} // namespace
-
-Browser::Browser(WindowConfig config) : config_(std::move(config)) {}
+Browser::Browser(WindowConfig config) : config_(std::move(config)) {
+    browserRegistry().push_back(this);
+}
 
 Browser::~Browser() {
+    std::erase(browserRegistry(), this);
     if (cefBrowser_) cefBrowser_->GetHost()->CloseBrowser(true);
 }
 
+std::vector<std::shared_ptr<Browser>> Browser::openBrowsers() {
+    std::vector<std::shared_ptr<Browser>> out;
+    out.reserve(browserRegistry().size());
+    for (Browser* b : browserRegistry())
+        if (auto sp = b->weak_from_this().lock()) out.push_back(std::move(sp));
+    return out;
+}
+
+void Browser::requestHeapUsage() {
+    if (cefBrowser_)
+        cefBrowser_->GetMainFrame()->SendProcessMessage(
+            PID_RENDERER, CefProcessMessage::Create(kHeapQueryMessage));
+}
+
+BridgeStats Browser::aggregateBridgeStats() {
+    BridgeStats total;
+    for (const Browser* b : browserRegistry()) total.merge(b->bridgeStats_);
+    return total;
+}
+
 std::expected<std::shared_ptr<Browser>, BrowserError>
 Browser::create(WindowConfig config) {
+    BAMBOO_TRACE_SCOPE("Browser::create");
     CEF_REQUIRE_UI_THREAD();
 
     auto self   = std::shared_ptr<Browser>(new Browser(config));
@@ -64,29 +89,60 @@ Browser::create(WindowConfig config) {
     self->client_ = client;
 
     CefWindowInfo wi;
+    if (config.offscreen) {
+        wi.SetAsWindowless(0);
+    } else {
 #if defined(_WIN32)
-    wi.SetAsPopup(nullptr, config.title);
-    if (config.style.chromeMode == ChromeMode::Frameless) {
-        wi.style = WS_POPUP | WS_VISIBLE | (config.style.resizable ? WS_SIZEBOX : 0);
-    }
+        wi.SetAsPopup(nullptr, config.title);
+        if (config.style.chromeMode == ChromeMode::Frameless) {
+            wi.style = WS_POPUP | WS_VISIBLE | (config.style.resizable ? WS_SIZEBOX : 0);
+        }
 #elif defined(__APPLE__)
-    wi.SetAsPopup(nullptr, config.title);
+        wi.SetAsPopup(nullptr, config.title);
 #else
-    wi.SetAsChild(0, {0, 0, config.width, config.height});
+        wi.SetAsChild(0, {0, 0, config.width, config.height});
 #endif
+    }
 
     CefBrowserSettings bs;
     if (config.style.transparent)
         bs.background_color = CefColorSetARGB(0,0,0,0);
-
-    auto browser = CefBrowserHost::CreateBrowserSync(wi, client, config.url, bs, nullptr, nullptr);
+    if (config.offscreen)
+        bs.windowless_frame_rate = config.frameRate;
+
+    // Hand the initial style CSS to the renderer up front so the very first
+    // document gets it at document start (see BambooJsBridge).
+    const std::string css = bridge::buildBridgeCSS(config.style);
+    self->bridgeCSSHash_ = self->initialCSSHash_ = bridge::hashCSS(css);
+    auto extraInfo = CefDictionaryValue::Create();
+    extraInfo->SetString(kCSSHashKey, std::format("{:016x}", self->bridgeCSSHash_));
+    extraInfo->SetString(kCSSKey, css);
+
+    auto browser = CefBrowserHost::CreateBrowserSync(wi, client, config.url, bs, extraInfo, nullptr);
     if (!browser) return std::unexpected(BrowserError::CreateFailed);
 
     self->cefBrowser_ = browser;
-    platform::applyStyle(browser, config.style);
+    self->bindInternalFunctions();
+    if (!config.offscreen) platform::applyStyle(browser, config.style);
+    self->appliedStyle_ = config.style;
+    return self;
+}
+
+std::shared_ptr<Browser> Browser::createDetached(WindowConfig config) {
+    auto self = std::shared_ptr<Browser>(new Browser(std::move(config)));
+    self->bindInternalFunctions();
+    self->appliedStyle_ = self->config_.style;
     return self;
 }
 
+void Browser::bindInternalFunctions() {
+    // window.bamboo.stats() — returns JSON text.
+    bindFunction("__stats", [weak=weak_from_this()](std::vector<JsValue>) -> JsValue {
+        auto s = weak.lock();
+        return s ? s->bridgeStats_.toJson() : std::string("{}");
+    });
+}
+
 void Browser::setCefBrowser(CefRefPtr<CefBrowser> b) { cefBrowser_ = b; }
 
 void Browser::navigate(std::string_view url) {
@@ -108,6 +164,7 @@ bool Browser::canGoForward()const { return cefBrowser_ && cefBrowser_->CanGoForw
 
 void Browser::executeJS(std::string_view script) {
     if (!cefBrowser_) return;
+    bridgeStats_.recordOutbound("executeJS", script.size());
     cefBrowser_->GetMainFrame()->ExecuteJavaScript(
         std::string(script), cefBrowser_->GetMainFrame()->GetURL(), 0);
 }
@@ -115,12 +172,9 @@ void Browser::executeJS(std::string_view script) {
 void Browser::evalJS(std::string_view script,
                      std::function<void(std::expected<JsValue, BrowserError>)> cb) {
     int id = nextCallbackId_++;
-    pendingCallbacks_[id] = std::move(cb);
-    executeJS(std::format(R"js(
-        (async()=>{{try{{const r=await(async()=>{{return({});}})();
-        window.bamboo.send('__evalResult',{{id:{},value:r,error:null}})}}
-        catch(e){{window.bamboo.send('__evalResult',{{id:{},value:null,error:e.message}})}}}})();
-    )js", script, id, id));
+    pendingCallbacks_[id] = { std::move(cb), std::chrono::steady_clock::now() };
+    bridgeStats_.recordOutbound("evalJS", script.size());
+    executeJS(bridge::evalScript(script, id));
 }
 
 void Browser::bindFunction(std::string name, std::function<JsValue(std::vector<JsValue>)> h) {
@@ -128,43 +182,136 @@ void Browser::bindFunction(std::string name, std::function<JsValue(std::vector<J
 }
 
 void Browser::sendMessage(std::string_view event, std::string_view payload) {
-    executeJS(std::format("window.bamboo._dispatch({},{});", json(event).dump(), payload));
+    bridgeStats_.recordOutbound(event, payload.size());
+    if (bridgeRecorder_) bridgeRecorder_->record(BridgeDirection::Outbound, browserId(), event, payload);
+    executeJS(bridge::dispatchScript(event, payload));
 }
 
 void Browser::setStyle(const WindowStyle& style) {
+    cancelStyleAnimation();
     config_.style = style;
-    if (cefBrowser_) {
-        platform::applyStyle(cefBrowser_, style);
-        injectBridgeCSS();
-    }
+    applyStyleToPlatform(style, diffStyle(appliedStyle_, style));
     if (onStyleChange_) onStyleChange_(style);
 }
 
-void Browser::injectBridgeCSS() {
-    std::string css = buildBridgeCSS(config_.style);
-    if (css.empty()) return;
-    // Escape backticks for JS template literal
-    std::string escaped;
-    for (char c : css) {
-        if (c == '`') escaped += "\\`";
-        else escaped += c;
+void Browser::animateStyle(const WindowStyle& target, std::chrono::milliseconds duration,
+                           Easing easing, std::function<void(bool)> done) {
+    cancelStyleAnimation();
+    if (duration.count() <= 0 || !cefBrowser_) {
+        setStyle(target);
+        if (done) done(true);
+        return;
+    }
+    const uint64_t gen = ++animationGeneration_;
+    animation_ = std::make_unique<StyleAnimationState>(StyleAnimationState{
+        config_.style, target, std::chrono::steady_clock::now(),
+        duration, easing, std::move(done), gen,
+    });
+
+    if (config_.offscreen) {
+        // firePaint() steps the animation and asks for the next frame.
+        cefBrowser_->GetHost()->Invalidate(PET_VIEW);
+        return;
+    }
+    bool hooked = platform::addFrameCallback(cefBrowser_, [weak=weak_from_this(), gen] {
+        auto self = weak.lock();
+        if (!self || !self->animation_ || self->animation_->generation != gen) return false;
+        return self->stepStyleAnimation();
+    });
+    if (!hooked) pumpStyleAnimationTimer(gen);
+}
+
+void Browser::cancelStyleAnimation() {
+    if (!animation_) return;
+    auto a = std::move(animation_);
+    if (a->done) a->done(false);
+}
+
+void Browser::pumpStyleAnimationTimer(uint64_t gen) {
+    CefPostDelayedTask(TID_UI, CefCreateClosureTask([weak=weak_from_this(), gen] {
+        auto self = weak.lock();
+        if (!self || !self->animation_ || self->animation_->generation != gen) return;
+        if (self->stepStyleAnimation()) self->pumpStyleAnimationTimer(gen);
+    }), 16);
+}
+
+bool Browser::stepStyleAnimation() {
+    auto& a = *animation_;
+    const auto  elapsed = std::chrono::steady_clock::now() - a.start;
+    const float t = std::min(1.0f, std::chrono::duration<float>(elapsed) / a.duration);
+
+    WindowStyle frame = lerpStyle(a.from, a.to, ease(a.easing, t));
+    config_.style = frame;
+    applyStyleToPlatform(frame, diffStyle(appliedStyle_, frame));
+    if (t < 1.0f) return true;
+
+    auto finished = std::move(animation_);
+    if (onStyleChange_) onStyleChange_(config_.style);
+    if (finished->done) finished->done(true);
+    return false;
+}
+
+void Browser::applyStyleToPlatform(const WindowStyle& style, StyleField changed) {
+    if (!cefBrowser_ || changed == StyleField::None) return;
+    if (!config_.offscreen) {
+        platform::applyStyle(cefBrowser_, style, changed);
+        if (any(changed, StyleField::DragRegions))
+            applyDragRegions(style.dragRegions);
     }
-    executeJS(std::format(R"js(
-        (function(){{var id='__bamboo_s',el=document.getElementById(id);
-        if(!el){{el=document.createElement('style');el.id=id;document.head.appendChild(el)}}
-        el.textContent=`{}`;}})();
-    )js", escaped));
+    // Re-sending the stylesheet restyles the whole document; skip it unless
+    // a field that actually feeds buildBridgeCSS() moved.
+    if (any(changed, kCSSFields)) injectBridgeCSS();
+    appliedStyle_ = style;
+}
+
+void Browser::injectBridgeCSS() {
+    BAMBOO_TRACE_SCOPE("Browser::injectBridgeCSS");
+    std::string css  = bridge::buildBridgeCSS(config_.style);
+    uint64_t    hash = bridge::hashCSS(css);
+    if (hash == bridgeCSSHash_) return;
+    bridgeCSSHash_ = hash;
+    sendBridgeCSS(std::move(css), hash);
+}
+
+void Browser::sendBridgeCSS(std::string css, uint64_t hash) {
+    if (!cefBrowser_) return;
+    auto msg  = CefProcessMessage::Create(kSetCSSMessage);
+    auto args = msg->GetArgumentList();
+    args->SetString(0, std::format("{:016x}", hash));
+    args->SetString(1, css);
+    cefBrowser_->GetMainFrame()->SendProcessMessage(PID_RENDERER, msg);
 }
 
 void Browser::setDragRegions(std::vector<DragRegion> r) {
     config_.style.dragRegions = std::move(r);
-    if (cefBrowser_) platform::setDragRegions(cefBrowser_, config_.style.dragRegions);
+    if (!cefBrowser_ || config_.style.dragRegions == appliedStyle_.dragRegions) return;
+    appliedStyle_.dragRegions = config_.style.dragRegions;
+    applyDragRegions(config_.style.dragRegions);
 }
-void Browser::setMacOSVibrancy(MacOSVibrancy v)   { config_.style.macosVibrancy=v;   if(cefBrowser_) platform::setMacOSVibrancy(cefBrowser_,v); }
-void Browser::setWindowsMaterial(WindowsMaterial m){ config_.style.windowsMaterial=m; if(cefBrowser_) platform::setWindowsMaterial(cefBrowser_,m); }
-void Browser::setBackgroundColor(Color c)          { config_.style.backgroundColor=c; if(cefBrowser_) platform::setBackgroundColor(cefBrowser_,c); }
-void Browser::setCornerRadius(int r)               { config_.style.cornerRadius=r;    if(cefBrowser_) platform::setCornerRadius(cefBrowser_,r); }
-void Browser::setShadow(const Shadow& s)           { config_.style.shadow=s;          if(cefBrowser_) platform::setShadow(cefBrowser_,s); }
+
+void Browser::setCSSDragRegions(std::vector<DragRegion> r) {
+    if (r == cssDragRegions_) return;
+    cssDragRegions_ = std::move(r);
+    if (cefBrowser_ && !config_.offscreen) applyDragRegions(appliedStyle_.dragRegions);
+}
+
+void Browser::applyDragRegions(const std::vector<DragRegion>& appRegions) {
+    // Later regions win, so the page's no-drag buttons punch through an
+    // app-set title bar.
+    if (cssDragRegions_.empty()) { platform::setDragRegions(cefBrowser_, appRegions); return; }
+    std::vector<DragRegion> merged;
+    merged.reserve(appRegions.size() + cssDragRegions_.size());
+    merged.insert(merged.end(), appRegions.begin(), appRegions.end());
+    merged.insert(merged.end(), cssDragRegions_.begin(), cssDragRegions_.end());
+    platform::setDragRegions(cefBrowser_, merged);
+}
+// Single-property setters go straight to the platform call, but keep
+// appliedStyle_ in step so a later setStyle() diffs against the real window.
+void Browser::setMacOSVibrancy(MacOSVibrancy v)   { config_.style.macosVibrancy=v;   if(cefBrowser_){ appliedStyle_.macosVibrancy=v;   platform::setMacOSVibrancy(cefBrowser_,v); } }
+void Browser::setWindowsMaterial(WindowsMaterial m){ config_.style.windowsMaterial=m; if(cefBrowser_){ appliedStyle_.windowsMaterial=m; platform::setWindowsMaterial(cefBrowser_,m); } }
+void Browser::setBackgroundColor(Color c)          { config_.style.backgroundColor=c; if(cefBrowser_){ appliedStyle_.backgroundColor=c; platform::setBackgroundColor(cefBrowser_,c); } }
+void Browser::setCornerRadius(int r)               { config_.style.cornerRadius=r;    if(cefBrowser_){ appliedStyle_.cornerRadius=r;    platform::setCornerRadius(cefBrowser_,r); } }
+void Browser::setShadow(const Shadow& s)           { config_.style.shadow=s;          if(cefBrowser_){ appliedStyle_.shadow=s;          platform::setShadow(cefBrowser_,s); } }
 void Browser::setChromeMode(ChromeMode m)          { config_.style.chromeMode=m;      setStyle(config_.style); }
 void Browser::setTitlebarStyle(const TitlebarStyle& ts){ config_.style.titlebar=ts;   setStyle(config_.style); }
 
@@ -178,6 +325,11 @@ void Browser::restore()  { /* platform-specific */ }
 void Browser::center()   { /* platform-specific */ }
 
 void Browser::resize(int w, int h) {
+    if (config_.offscreen) {
+        config_.width = w; config_.height = h;
+        if (cefBrowser_) cefBrowser_->GetHost()->WasResized();
+        return;
+    }
 #if defined(_WIN32)
     if (cefBrowser_) SetWindowPos(cefBrowser_->GetHost()->GetWindowHandle(),nullptr,0,0,w,h,SWP_NOMOVE|SWP_NOZORDER);
 #endif
@@ -204,6 +356,92 @@ void Browser::openDevTools(bool docked) {
 }
 void Browser::closeDevTools() { if (cefBrowser_) cefBrowser_->GetHost()->CloseDevTools(); }
 
+std::expected<std::shared_ptr<DevToolsClient>, DevToolsError> Browser::devTools() {
+    if (devTools_ && devTools_->attached()) return devTools_;
+    auto client = DevToolsClient::attach(shared_from_this());
+    if (!client) return std::unexpected(client.error());
+    devTools_ = *client;
+    return devTools_;
+}
+
+void Browser::captureCpuProfile(std::chrono::milliseconds duration, std::string path,
+                                ProfileCallback done) {
+    CEF_REQUIRE_UI_THREAD();
+    auto fail = [&](ProfileError e) { if (done) done(std::unexpected(e)); };
+    if (cpuProfiling_) return fail(ProfileError::Busy);
+    auto dt = devTools();
+    if (!dt) return fail(ProfileError::NoDevTools);
+    cpuProfiling_ = true;
+    profiling::captureCpuProfile(*dt, duration, std::move(path),
+        [weak=weak_from_this(), done=std::move(done)](std::expected<void, ProfileError> r) {
+            if (auto self = weak.lock()) self->cpuProfiling_ = false;
+            if (done) done(r);
+        });
+}
+
+void Browser::captureHeapSnapshot(std::string path, ProfileCallback done) {
+    CEF_REQUIRE_UI_THREAD();
+    auto fail = [&](ProfileError e) { if (done) done(std::unexpected(e)); };
+    if (heapSnapshotting_) return fail(ProfileError::Busy);
+    auto dt = devTools();
+    if (!dt) return fail(ProfileError::NoDevTools);
+    heapSnapshotting_ = true;
+    profiling::captureHeapSnapshot(*dt, std::move(path),
+        [weak=weak_from_this(), done=std::move(done)](std::expected<void, ProfileError> r) {
+            if (auto self = weak.lock()) self->heapSnapshotting_ = false;
+            if (done) done(r);
+        });
+}
+
+void Browser::startInputRecording() {
+    CEF_REQUIRE_UI_THREAD();
+    inputRecording_.emplace();
+    inputRecordingOriginMs_ = std::chrono::duration<double, std::milli>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    executeJS(input::recorderScript());
+}
+
+void Browser::stopInputRecording(std::function<void(InputSequence)> done) {
+    CEF_REQUIRE_UI_THREAD();
+    if (!inputRecording_ || !cefBrowser_) {
+        InputSequence seq = inputRecording_ ? std::move(*inputRecording_) : InputSequence{};
+        inputRecording_.reset();
+        if (done) done(std::move(seq));
+        return;
+    }
+    // The final batch comes back as the evaluation result rather than over
+    // the bridge, so stopping never depends on a page-side send.
+    auto finish = [weak = weak_from_this(), done = std::move(done)](const std::string& batch) {
+        auto self = weak.lock();
+        if (!self || !self->inputRecording_) return;
+        input::appendRecorded(*self->inputRecording_, batch, self->inputRecordingOriginMs_);
+        InputSequence seq = std::move(*self->inputRecording_);
+        self->inputRecording_.reset();
+        if (done) done(std::move(seq));
+    };
+    constexpr std::string_view kNoBatch = R"({"events":[],"done":true})";
+    auto dt = devTools();
+    if (!dt) return finish(std::string(kNoBatch));
+    (*dt)->send(cdp::Runtime::evaluate{ .expression = std::string(input::stopRecorderScript()) },
+        [finish = std::move(finish), kNoBatch](std::expected<cdp::Runtime::evaluate::Result, CdpError> r) {
+            finish(r && r->result.value.is_object() ? r->result.value.dump() : std::string(kNoBatch));
+        });
+}
+
+void Browser::replayInput(InputSequence sequence, InputReplayOptions options,
+                          InputPlayer::DoneCallback done) {
+    CEF_REQUIRE_UI_THREAD();
+    if (inputPlayer_ && inputPlayer_->running()) {
+        if (done) done(std::unexpected(InputError::Busy));
+        return;
+    }
+    inputPlayer_ = InputPlayer::start(shared_from_this(), std::move(sequence), options, std::move(done));
+}
+
+void Browser::cancelInputReplay() {
+    if (inputPlayer_) inputPlayer_->cancel();
+}
+
 void Browser::setZoom(float f) {
     zoomLevel_ = f;
     if (cefBrowser_) cefBrowser_->GetHost()->SetZoomLevel(std::log(f) / std::log(1.2));
@@ -219,7 +457,168 @@ void Browser::findText(std::string_view text, bool forward, bool caseSensitive)
     cefBrowser_->GetHost()->Find(std::string(text), forward, fs, false);
 }
 void Browser::clearFind() { if (cefBrowser_) cefBrowser_->GetHost()->StopFinding(true); }
-void Browser::captureScreenshot(std::function<void(std::vector<uint8_t>)>) { /* windowless mode only */ }
+namespace {
+
+std::vector<uint8_t> decodeBase64(std::string_view in) {
+    std::vector<uint8_t> out;
+    out.reserve(in.size() / 4 * 3);
+    uint32_t bits = 0;
+    int      count = 0;
+    for (char ch : in) {
+        int v;
+        if      (ch >= 'A' && ch <= 'Z') v = ch - 'A';
+        else if (ch >= 'a' && ch <= 'z') v = ch - 'a' + 26;
+        else if (ch >= '0' && ch <= '9') v = ch - '0' + 52;
+        else if (ch == '+')              v = 62;
+        else if (ch == '/')              v = 63;
+        else continue;  // padding
+        bits = (bits << 6) | static_cast<uint32_t>(v);
+        if ((count += 6) >= 8) { count -= 8; out.push_back(static_cast<uint8_t>(bits >> count)); }
+    }
+    return out;
+}
+
+} // namespace
+
+void Browser::captureScreenshotBase64(std::function<void(std::optional<std::string>)> done) {
+    auto dt = devTools();
+    if (!dt) { done(std::nullopt); return; }
+    (*dt)->send(cdp::Page::captureScreenshot{},
+        [done = std::move(done)](std::expected<cdp::Page::captureScreenshot::Result, CdpError> r) {
+            if (r) done(std::move(r->data));
+            else   done(std::nullopt);
+        });
+}
+
+void Browser::captureScreenshot(std::function<void(std::vector<uint8_t>)> callback) {
+    captureScreenshotBase64([callback = std::move(callback)](std::optional<std::string> png) {
+        if (callback) callback(png ? decodeBase64(*png) : std::vector<uint8_t>{});
+    });
+}
+
+void Browser::captureFullPage(std::string_view pngPath, std::function<void(bool)> cb) {
+    if (!cefBrowser_ || !config_.offscreen || capture_) { if (cb) cb(false); return; }
+    capture_ = std::make_unique<FullPageCapture>();
+    capture_->done = std::move(cb);
+    capture_->path = pngPath;
+
+    evalJS("JSON.stringify([Math.max(document.documentElement.scrollHeight,"
+           "document.body?document.body.scrollHeight:0),window.scrollY])",
+        [weak=weak_from_this()](std::expected<JsValue, BrowserError> r) {
+            auto self = weak.lock();
+            if (!self || !self->capture_) return;
+            if (!r || !std::holds_alternative<std::string>(*r)) { self->finishCapture(false); return; }
+            auto dims = json::parse(std::get<std::string>(*r), nullptr, false);
+            if (!dims.is_array() || dims.size() != 2 || !dims[0].is_number() || !dims[1].is_number()) {
+                self->finishCapture(false);
+                return;
+            }
+
+            auto& c = *self->capture_;
+            c.pageHeight = std::max(dims[0].get<int>(), self->config_.height);
+            c.restoreY   = dims[1].get<int>();
+            auto png = PngWriter::open(c.path, static_cast<uint32_t>(self->config_.width),
+                                       static_cast<uint32_t>(c.pageHeight));
+            if (!png) { self->finishCapture(false); return; }
+            c.png = std::move(*png);
+            self->captureNextTile();
+        });
+}
+
+void Browser::captureNextTile() {
+    // Scroll so the next unencoded row is at the top of the viewport and wait
+    // two animation frames so the compositor has produced that scroll offset.
+    // Near the bottom the page clamps the scroll, which firePaint accounts for.
+    evalJS(std::format("(async()=>{{window.scrollTo(0,{});"
+                       "await new Promise(r=>requestAnimationFrame(()=>requestAnimationFrame(r)));"
+                       "return window.scrollY;}})()", capture_->nextRow),
+        [weak=weak_from_this()](std::expected<JsValue, BrowserError> r) {
+            auto self = weak.lock();
+            if (!self || !self->capture_) return;
+            if (!r || !std::holds_alternative<double>(*r) || !self->cefBrowser_) {
+                self->finishCapture(false);
+                return;
+            }
+            self->capture_->tileScrollY   = static_cast<int>(std::get<double>(*r));
+            self->capture_->awaitingPaint = true;
+            self->cefBrowser_->GetHost()->Invalidate(PET_VIEW);
+        });
+}
+
+void Browser::finishCapture(bool ok) {
+    auto c = std::move(capture_);
+    if (ok) ok = c->png && c->png->finish().has_value();
+    if (!ok && c->png) {  // do not leave a truncated PNG behind
+        c->png.reset();
+        std::error_code ec;
+        std::filesystem::remove(c->path, ec);
+    }
+    executeJS(std::format("window.scrollTo(0,{});", c->restoreY));
+    if (c->done) c->done(ok);
+}
+
+std::expected<void, BrowserError> Browser::exportFrames(FrameExportConfig cfg) {
+    if (!config_.offscreen) return std::unexpected(BrowserError::InvalidState);
+    cfg.maxWidth  = std::max(cfg.maxWidth,  config_.width);
+    cfg.maxHeight = std::max(cfg.maxHeight, config_.height);
+    auto exporter = FrameExporter::create(std::move(cfg));
+    if (!exporter) {
+        return std::unexpected(exporter.error() == FrameExportError::Unsupported
+                               ? BrowserError::Unsupported : BrowserError::CreateFailed);
+    }
+    frameExporter_ = std::move(*exporter);
+    pumpFrameExportAccept(++frameExportGeneration_);
+    if (cefBrowser_) cefBrowser_->GetHost()->Invalidate(PET_VIEW);  // first frame now
+    return {};
+}
+void Browser::stopFrameExport() { frameExporter_.reset(); ++frameExportGeneration_; }
+
+// Consumers are otherwise only accepted from publish(), which an idle page
+// never calls; the Hello must not wait for the next paint.
+void Browser::pumpFrameExportAccept(uint64_t gen) {
+    CefPostDelayedTask(TID_UI, CefCreateClosureTask([weak=weak_from_this(), gen] {
+        auto self = weak.lock();
+        if (!self || !self->frameExporter_ || self->frameExportGeneration_ != gen) return;
+        self->frameExporter_->acceptPending();
+        self->pumpFrameExportAccept(gen);
+    }), 100);
+}
+
+std::optional<FrameExportStats> Browser::frameExportStats() const {
+    if (!frameExporter_) return std::nullopt;
+    return frameExporter_->stats();
+}
+
+void Browser::onAudio(AudioCallback cb, AudioFormat format) {
+    if (cb) { audioTap()->setCallback(std::move(cb), format); return; }
+
+    // Unsubscribe. Unless a mixer still reads the tap, drop it, so the next
+    // stream is not captured (GetAudioParameters) and the one in flight
+    // stops being converted.
+    // audioMutex_ only guards the pointer; the engine is never called under it.
+    auto tap = activeAudioTap();
+    if (!tap) return;
+    tap->setCallback({}, format);
+    if (tap->mixed()) return;
+    {
+        std::lock_guard lock(audioMutex_);
+        if (audioTap_ != tap) return;
+        audioTap_.reset();
+    }
+    tap->close();
+}
+
+std::shared_ptr<AudioTap> Browser::audioTap() {
+    std::lock_guard lock(audioMutex_);
+    if (!audioTap_) audioTap_ = std::make_shared<AudioTap>();
+    return audioTap_;
+}
+
+std::shared_ptr<AudioTap> Browser::activeAudioTap() const {
+    std::lock_guard lock(audioMutex_);
+    return audioTap_;
+}
+
 void Browser::print()    { if (cefBrowser_) cefBrowser_->GetHost()->Print(); }
 void Browser::printToPDF(std::string_view path, std::function<void(bool)>) {
     if (cefBrowser_) cefBrowser_->GetHost()->PrintToPDF(std::string(path), {}, nullptr);
@@ -229,53 +628,173 @@ void Browser::onLoad(LoadCallback cb)              { onLoad_        = std::move(
 void Browser::onTitleChange(TitleCallback cb)      { onTitleChange_ = std::move(cb); }
 void Browser::onClose(CloseCallback cb)            { onClose_       = std::move(cb); }
 void Browser::onConsole(ConsoleCallback cb)        { onConsole_     = std::move(cb); }
+void Browser::setConsoleSink(std::shared_ptr<ConsoleSink> sink) { consoleSink_ = std::move(sink); }
+void Browser::setBridgeRecorder(std::shared_ptr<BridgeRecorder> r) { bridgeRecorder_ = std::move(r); }
 void Browser::onMessage(MessageCallback cb)        { onMessage_     = std::move(cb); }
 void Browser::onNavigation(NavigationCallback cb)  { onNavigation_  = std::move(cb); }
 void Browser::onFind(FindCallback cb)              { onFind_        = std::move(cb); }
 void Browser::onFocusChange(FocusCallback cb)      { onFocusChange_ = std::move(cb); }
 void Browser::onStyleChange(StyleChangeCallback cb){ onStyleChange_ = std::move(cb); }
+void Browser::onPaint(PaintCallback cb)            { onPaint_       = std::move(cb); }
+void Browser::onJank(JankCallback cb)              { onJank_        = std::move(cb); }
 
-void Browser::fireLoad(LoadEvent e)              { if(onLoad_)        onLoad_(e); }
+void Browser::fireLoad(LoadEvent e) {
+    // A new document has no recorder yet.
+    if (inputRecording_ && !e.isError) executeJS(input::recorderScript());
+    if (onLoad_) onLoad_(e);
+}
 void Browser::fireTitleChange(std::string title) { if(onTitleChange_) onTitleChange_(title); }
-void Browser::fireClose()                        { if(onClose_)       onClose_(); }
+void Browser::fireClose() {
+    if (capture_) finishCapture(false);  // no more paints will come
+    if (onClose_) onClose_();
+}
 void Browser::fireConsole(ConsoleEvent e)        { if(onConsole_)     onConsole_(e); }
 void Browser::fireFocus(bool gained)             { if(onFocusChange_) onFocusChange_(gained); }
 void Browser::fireNavigation(NavigationRequest& req) { if(onNavigation_) onNavigation_(req); }
 
+void Browser::firePaint(const PaintEvent& e) {
+    if (animation_ && stepStyleAnimation() && cefBrowser_)
+        cefBrowser_->GetHost()->Invalidate(PET_VIEW);
+    if (capture_ && capture_->awaitingPaint) {
+        auto& c = *capture_;
+        c.awaitingPaint = false;
+        // Rows of this tile that have not been encoded yet, clipped to the page.
+        int first = c.nextRow - c.tileScrollY;
+        int last  = std::min(e.height, c.pageHeight - c.tileScrollY);
+        if (e.width != static_cast<int>(c.png->width()) || first < 0 || first >= last) {
+            finishCapture(false);
+        } else {
+            const size_t stride = static_cast<size_t>(e.width) * 4;
+            bool ok = true;
+            for (int row = first; row < last && ok; ++row)
+                ok = c.png->writeRowBGRA({ e.bgra + row * stride, stride }).has_value();
+            c.nextRow = c.tileScrollY + last;
+            if (!ok)                          finishCapture(false);
+            else if (c.nextRow >= c.pageHeight) finishCapture(true);
+            else                              captureNextTile();
+        }
+    }
+    if (frameExporter_) {
+        CefRect dirty;
+        for (const auto& r : e.dirtyRects) {
+            if (dirty.IsEmpty()) dirty = r;
+            else                 dirty.Union(r);
+        }
+        frameExporter_->publish(e.bgra, e.width, e.height,
+                                { dirty.x, dirty.y, dirty.width, dirty.height });
+    }
+    if (onPaint_) onPaint_(e);
+}
+
+namespace {
+
+uint64_t microsSince(std::chrono::steady_clock::time_point t) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t).count());
+}
+
+} // namespace
+
 void Browser::fireMessage(std::string_view event, std::string_view data) {
+    BAMBOO_TRACE_SCOPE("Browser::fireMessage");
+    watchdog::TaskScope scope("bridge", event);
+    const auto start = std::chrono::steady_clock::now();
+    bridgeStats_.recordInbound(event, data.size());
+    if (bridgeRecorder_) bridgeRecorder_->record(BridgeDirection::Inbound, browserId(), event, data);
+    dispatchMessage(event, data);
+    bridgeStats_.handlerUs.record(microsSince(start));
+}
+
+void Browser::dispatchMessage(std::string_view event, std::string_view data) {
     if (event == "__evalResult") {
         auto j = json::parse(data, nullptr, false);
         if (j.is_discarded()) return;
         auto it = pendingCallbacks_.find(j["id"].get<int>());
         if (it == pendingCallbacks_.end()) return;
-        if (!j["error"].is_null()) it->second(std::unexpected(BrowserError::JSException));
-        else it->second(jsonToJsValue(j["value"]));
+        bridgeStats_.evalRoundTripUs.record(microsSince(it->second.issued));
+        auto cb = std::move(it->second.callback);
         pendingCallbacks_.erase(it);
+        if (!j["error"].is_null()) cb(std::unexpected(BrowserError::JSException));
+        else cb(bridge::jsonToJsValue(j["value"]));
         return;
     }
     if (event == "__call") {
         auto j = json::parse(data, nullptr, false); if(j.is_discarded()) return;
+        // Round trips of earlier bamboo.call()s, measured in the page (ms).
+        if (auto rtt = j.find("rtt"); rtt != j.end() && rtt->is_array())
+            for (const auto& ms : *rtt)
+                if (ms.is_number()) bridgeStats_.callRoundTripUs.record(static_cast<uint64_t>(ms.get<double>() * 1000.0));
         std::string name=j["name"], id=j["id"];
+        if (name == "__screenshot") {  // bamboo.captureScreenshot(): settles asynchronously
+            captureScreenshotBase64([weak=weak_from_this(), id](std::optional<std::string> png) {
+                auto self = weak.lock();
+                if (!self) return;
+                self->executeJS(png ? bridge::resolveCallScript(id, JsValue(std::move(*png)))
+                                    : bridge::rejectCallScript(id, "screenshot failed"));
+            });
+            return;
+        }
         auto it = boundFunctions_.find(name);
         if (it == boundFunctions_.end()) {
-            executeJS(std::format("window.bamboo._resolveCall({},null,'Unknown: {}');", json(id).dump(), name));
+            executeJS(bridge::rejectUnknownCallScript(id, name));
             return;
         }
         std::vector<JsValue> args;
-        for (const auto& a : j["args"]) args.push_back(jsonToJsValue(a));
+        for (const auto& a : j["args"]) args.push_back(bridge::jsonToJsValue(a));
+        const auto callStart = std::chrono::steady_clock::now();
+        watchdog::TaskScope scope("call", name);
         auto result = it->second(args);
-        executeJS(std::format("window.bamboo._resolveCall({},{},null);", json(id).dump(), jsValueToJson(result).dump()));
+        bridgeStats_.callUs.record(microsSince(callStart));
+        if (bridgeRecorder_)
+            bridgeRecorder_->record(BridgeDirection::CallResult, browserId(), name,
+                                    bridge::jsValueToJson(result).dump());
+        executeJS(bridge::resolveCallScript(id, result));
+        return;
+    }
+    if (event == "__inputRecord") {
+        if (!inputRecording_) return;
+        input::appendRecorded(*inputRecording_, data, inputRecordingOriginMs_);
         return;
     }
     if (event == "__setStyle") {
         auto j = json::parse(data, nullptr, false); if(j.is_discarded()) return;
-        auto& s = config_.style;
-        if (j.contains("cornerRadius"))      s.cornerRadius       = j["cornerRadius"].get<int>();
-        if (j.contains("transparent"))       s.transparent        = j["transparent"].get<bool>();
-        if (j.contains("backgroundOpacity")) s.backgroundOpacity  = j["backgroundOpacity"].get<float>();
-        if (j.contains("alwaysOnTop"))       s.alwaysOnTop        = j["alwaysOnTop"].get<bool>();
+        WindowStyle s = config_.style;
+        bridge::mergeStyleJson(s, j);
         setStyle(s); return;
     }
+    if (event == "__animateStyle") {
+        auto j = json::parse(data, nullptr, false); if(!j.is_object()) return;
+        WindowStyle s = config_.style;
+        if (j.contains("style")) bridge::mergeStyleJson(s, j["style"]);
+        auto duration = std::chrono::milliseconds(j.value("duration", 200));
+        auto easing   = parseEasing(j.value("easing", std::string("ease-in-out")));
+        animateStyle(s, duration, easing.value_or(Easing::EaseInOut)); return;
+    }
+    if (event == "__jank") {
+        if (!onJank_) return;
+        auto j = json::parse(data, nullptr, false); if(!j.is_object()) return;
+        auto tasks = [&](const char* key) {
+            JankReport::Tasks t;
+            if (auto it = j.find(key); it != j.end() && it->is_object()) {
+                t.count      = it->value("count", 0);
+                t.totalMs    = it->value("totalMs", 0.0);
+                t.maxMs      = it->value("maxMs", 0.0);
+                t.blockingMs = it->value("blockingMs", 0.0);
+            }
+            return t;
+        };
+        onJank_({
+            .url              = j.value("url", std::string{}),
+            .intervalMs       = j.value("intervalMs", 0.0),
+            .longTasks        = tasks("longTasks"),
+            .longFrames       = tasks("longFrames"),
+            .worstScript      = j.value("worstScript", std::string{}),
+            .layoutShifts     = j.value("layoutShifts", 0),
+            .layoutShiftScore = j.value("layoutShiftScore", 0.0),
+            .cls              = j.value("cls", 0.0),
+        });
+        return;
+    }
     if (event == "__setDragRegions") {
         auto j = json::parse(data, nullptr, false); if(!j.is_array()) return;
         std::vector<DragRegion> regions;
@@ -307,17 +826,21 @@ void BambooClient::OnAfterCreated(CefRefPtr<CefBrowser> b) {
     if (owner_) owner_->setCefBrowser(b);
 }
 bool BambooClient::DoClose(CefRefPtr<CefBrowser>) { return false; }
-void BambooClient::OnBeforeClose(CefRefPtr<CefBrowser>) {
+void BambooClient::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
     CEF_REQUIRE_UI_THREAD();
+    platform::forgetBrowser(browser);
     if (owner_) owner_->fireClose();
 }
+void BambooClient::OnLoadStart(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame> frame, TransitionType) {
+    // A cross-site navigation may land in a fresh renderer that only knows
+    // the creation-time CSS from extra_info. Re-send only if it has since
+    // changed; the renderer ignores a hash it already attached.
+    if (owner_ && frame->IsMain() && owner_->bridgeCSSHash_ != owner_->initialCSSHash_)
+        owner_->sendBridgeCSS(bridge::buildBridgeCSS(owner_->config_.style), owner_->bridgeCSSHash_);
+}
 void BambooClient::OnLoadEnd(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame> frame, int http) {
-    if (owner_ && frame->IsMain()) {
+    if (owner_ && frame->IsMain())
         owner_->fireLoad({ frame->GetURL().ToString(), http, false, {} });
-        CefPostTask(TID_UI, CefCreateClosureTask([weak=std::weak_ptr(owner_)](){
-            if (auto o=weak.lock()) o->injectBridgeCSS();
-        }));
-    }
 }
 void BambooClient::OnLoadError(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame> frame,
                                ErrorCode code, const CefString& err, const CefString& url) {
@@ -327,13 +850,22 @@ void BambooClient::OnLoadError(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame> frame,
 void BambooClient::OnTitleChange(CefRefPtr<CefBrowser>, const CefString& title) {
     if (owner_) owner_->fireTitleChange(title.ToString());
 }
-bool BambooClient::OnConsoleMessage(CefRefPtr<CefBrowser>, cef_log_severity_t lvl,
+bool BambooClient::OnConsoleMessage(CefRefPtr<CefBrowser> browser, cef_log_severity_t lvl,
                                     const CefString& msg, const CefString& src, int line) {
     if (!owner_) return false;
     ConsoleEvent::Level l = lvl >= LOGSEVERITY_ERROR ? ConsoleEvent::Level::Error
                           : lvl >= LOGSEVERITY_WARNING ? ConsoleEvent::Level::Warning
-                          : ConsoleEvent::Level::Info;
-    owner_->fireConsole({ l, msg.ToString(), src.ToString(), line });
+                          : lvl >= LOGSEVERITY_INFO ? ConsoleEvent::Level::Info
+                          : ConsoleEvent::Level::Debug;
+    // The sink takes CEF's UTF-16 as-is; conversion happens on its writer thread.
+    static_assert(sizeof(CefString::char_type) == sizeof(char16_t));
+    auto u16 = [](const CefString& s) {
+        return std::u16string_view(reinterpret_cast<const char16_t*>(s.c_str()), s.length());
+    };
+    if (owner_->consoleSink_)
+        owner_->consoleSink_->push(browser->GetIdentifier(), l, u16(msg), u16(src), line);
+    if (owner_->onConsole_)
+        owner_->fireConsole({ l, msg.ToString(), src.ToString(), line });
     return false;
 }
 void BambooClient::OnGotFocus(CefRefPtr<CefBrowser>) { if(owner_) owner_->fireFocus(true); }
@@ -352,9 +884,81 @@ bool BambooClient::OnBeforeBrowse(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame> fra
     owner_->fireNavigation(nr);
     return !nr.allow;
 }
+void BambooClient::OnDraggableRegionsChanged(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame> frame,
+                                             const std::vector<CefDraggableRegion>& regions) {
+    CEF_REQUIRE_UI_THREAD();
+    if (!owner_ || !frame->IsMain()) return;
+    std::vector<DragRegion> out;
+    out.reserve(regions.size());
+    for (const auto& r : regions)
+        out.push_back({ r.bounds.x, r.bounds.y, r.bounds.width, r.bounds.height, r.draggable != 0 });
+    owner_->setCSSDragRegions(std::move(out));
+}
+
+bool BambooClient::OnProcessMessageReceived(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame> frame,
+                                           CefProcessId, CefRefPtr<CefProcessMessage> message) {
+    CEF_REQUIRE_UI_THREAD();
+    // Main frame only: replies (call results, evalJS, sendMessage) all run
+    // in the main frame, so a subframe's request could settle the wrong call.
+    if (!owner_ || !frame->IsMain()) return false;
+    const std::string name = message->GetName();
+    auto args = message->GetArgumentList();
+    if (name == kBridgeMessage) {
+        if (auto routed = bridge::routeRequest(args->GetString(0).ToString()))
+            owner_->fireMessage(routed->event, routed->data);
+        return true;
+    }
+    if (name == kRendererInfoMessage) {
+        owner_->rendererPid_ = args->GetInt(0);
+        return true;
+    }
+    if (name == kHeapUsageMessage) {
+        owner_->resourceUsage_.jsHeapUsedBytes  = static_cast<uint64_t>(args->GetDouble(0));
+        owner_->resourceUsage_.jsHeapTotalBytes = static_cast<uint64_t>(args->GetDouble(1));
+        return true;
+    }
+    return false;
+}
+
+void BambooClient::GetViewRect(CefRefPtr<CefBrowser>, CefRect& rect) {
+    // Must never be empty, even before the owner is wired up.
+    if (owner_) rect = CefRect(0, 0, std::max(1, owner_->config().width), std::max(1, owner_->config().height));
+    else        rect = CefRect(0, 0, 1, 1);
+}
+void BambooClient::OnPaint(CefRefPtr<CefBrowser>, PaintElementType type,
+                           const RectList& dirty, const void* buffer, int w, int h) {
+    if (owner_ && type == PET_VIEW)
+        owner_->firePaint({ static_cast<const uint8_t*>(buffer), w, h, dirty });
+}
+bool BambooClient::GetAudioParameters(CefRefPtr<CefBrowser>, CefAudioParameters&) {
+    // Only capture browsers someone asked for; CEF's defaults are fine —
+    // conversion to the consumer's format happens on the Bamboo audio thread.
+    return owner_ && owner_->activeAudioTap() != nullptr;
+}
+void BambooClient::OnAudioStreamStarted(CefRefPtr<CefBrowser>, const CefAudioParameters& params,
+                                        int channels) {
+    audioStream_ = owner_ ? owner_->activeAudioTap() : nullptr;
+    if (audioStream_) audioStream_->start(params.sample_rate, channels);
+}
+void BambooClient::OnAudioStreamPacket(CefRefPtr<CefBrowser>, const float** data,
+                                       int frames, int64_t pts) {
+    if (audioStream_) audioStream_->push(data, frames, pts);
+}
+void BambooClient::OnAudioStreamStopped(CefRefPtr<CefBrowser>) {
+    if (audioStream_) audioStream_->stop();
+    audioStream_.reset();
+}
+void BambooClient::OnAudioStreamError(CefRefPtr<CefBrowser> b, const CefString&) {
+    OnAudioStreamStopped(b);
+}
 void BambooClient::OnFindResult(CefRefPtr<CefBrowser>, int id, int count,
                                 const CefRect&, int, bool final) {
     if (owner_ && owner_->onFind_) owner_->onFind_({ id, count, final });
 }
+bool BambooClient::OnPreKeyEvent(CefRefPtr<CefBrowser>, const CefKeyEvent& e,
+                                 CefEventHandle, bool*) {
+    const bool down = e.type == KEYEVENT_RAWKEYDOWN || e.type == KEYEVENT_KEYDOWN;
+    return owner_ && profiling::handleHotkey(owner_, down, e.windows_key_code, e.modifiers);
+}
 
 } // namespace bamboo
@@ -3,11 +3,27 @@
 // Browser window — the core of Bamboo.
 
 #include "bamboo/WindowStyle.hpp"
+#include "bamboo/BridgeCodec.hpp"
+#include "bamboo/StyleDiff.hpp"
+#include "bamboo/StyleAnimation.hpp"
+#include "bamboo/FrameExport.hpp"
+#include "bamboo/Audio.hpp"
+#include "bamboo/BridgeStats.hpp"
+#include "bamboo/ResourceUsage.hpp"
+#include "bamboo/ConsoleSink.hpp"
+#include "bamboo/BridgeRecorder.hpp"
+#include "bamboo/DevTools.hpp"
+#include "bamboo/Profiling.hpp"
+#include "bamboo/Input.hpp"
+#include <chrono>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 #include <functional>
 #include <memory>
 #include <expected>
+#include <mutex>
 #include <optional>
 #include <variant>
 #include <vector>
@@ -23,13 +39,11 @@
 #include "include/cef_drag_handler.h"
 #include "include/cef_keyboard_handler.h"
 #include "include/cef_find_handler.h"
+#include "include/cef_render_handler.h"
+#include "include/cef_audio_handler.h"
 
 namespace bamboo {
 
-// ─── JS value type ────────────────────────────────────────────────────────────
-
-using JsValue = std::variant<std::monostate, bool, double, std::string>;
-
 // ─── Window config ────────────────────────────────────────────────────────────
 
 struct WindowConfig {
@@ -47,6 +61,12 @@ struct WindowConfig {
     int  x              = -1;  // -1 = centered
     int  y              = -1;
 
+    // Off-screen (windowless) rendering: no native window is created and
+    // frames are delivered through Browser::onPaint() instead.
+    // Requires AppConfig::windowlessRendering.
+    bool offscreen      = false;
+    int  frameRate      = 60;  // off-screen only
+
     // Style (see WindowStyle.hpp for the full range of options)
     WindowStyle style;
 };
@@ -58,6 +78,7 @@ enum class BrowserError {
     InvalidState,
     JSException,
     NavigationBlocked,
+    Unsupported,
 };
 
 // ─── Event structs ────────────────────────────────────────────────────────────
@@ -69,20 +90,43 @@ struct LoadEvent {
     std::string errorText;
 };
 
-struct ConsoleEvent {
-    enum class Level { Debug, Info, Warning, Error };
-    Level       level;
-    std::string message;
-    std::string source;
-    int         line;
-};
-
 struct FindResult {
     int  identifier;
     int  count;
     bool finalUpdate;
 };
 
+struct PaintEvent {
+    // BGRA, premultiplied alpha, width*height*4 bytes.
+    // Only valid for the duration of the callback.
+    const uint8_t*           bgra;
+    int                      width;
+    int                      height;
+    std::span<const CefRect> dirtyRects;
+};
+
+/**
+ * One summary of renderer jank, sent at most every 5 s while the page has
+ * long tasks, long animation frames or layout shifts (and when it is hidden).
+ */
+struct JankReport {
+    struct Tasks {
+        int    count      = 0;
+        double totalMs    = 0;
+        double maxMs      = 0;
+        double blockingMs = 0;  // time beyond 50 ms (tasks) / LoAF blockingDuration
+    };
+
+    std::string url;
+    double      intervalMs = 0;   // period this report covers
+    Tasks       longTasks;        // PerformanceObserver 'longtask'
+    Tasks       longFrames;       // 'long-animation-frame' (Chromium 123+)
+    std::string worstScript;      // slowest script in the longest frame, if attributed
+    int         layoutShifts     = 0;
+    double      layoutShiftScore = 0;  // sum over this interval
+    double      cls              = 0;  // page lifetime CLS (largest session window)
+};
+
 struct NavigationRequest {
     std::string url;
     bool        isRedirect;
@@ -94,6 +138,8 @@ struct NavigationRequest {
 // ─── Forward declaration ──────────────────────────────────────────────────────
 
 class BambooClient;
+struct FullPageCapture;
+struct StyleAnimationState;
 
 /**
  * @brief A Bamboo browser window.
@@ -120,6 +166,16 @@ public:
     static std::expected<std::shared_ptr<Browser>, BrowserError>
     create(WindowConfig config = {});
 
+    /**
+     * @brief A Browser with no CEF browser or native window behind it.
+     *
+     * The browser-process half of the bridge works as usual: fireMessage()
+     * dispatch, bound functions, evalJS bookkeeping, style state and stats.
+     * Script execution and platform calls are no-ops. Needs neither
+     * CefInitialize nor a display (bamboo_bench uses it).
+     */
+    [[nodiscard]] static std::shared_ptr<Browser> createDetached(WindowConfig config = {});
+
     // ── Navigation ───────────────────────────────────────────────────────────
 
     void navigate(std::string_view url);
@@ -156,6 +212,32 @@ public:
      */
     void sendMessage(std::string_view event, std::string_view jsonPayload = "null");
 
+    // ── Bridge metrics ────────────────────────────────────────────────────────
+
+    /**
+     * @brief Traffic and latency counters for this window's JS bridge.
+     *
+     * Always on: per-event counts/bytes in both directions and log-linear
+     * histograms (µs) for message handling, bound-call execution, evalJS
+     * round trips and bamboo.call() round trips as measured by the page.
+     * UI thread only. JS: `await window.bamboo.stats()`.
+     */
+    [[nodiscard]] const BridgeStats& bridgeStats() const { return bridgeStats_; }
+    void resetBridgeStats() { bridgeStats_ = {}; }
+
+    /** Merged bridgeStats() of every live Browser. UI thread only. */
+    [[nodiscard]] static BridgeStats aggregateBridgeStats();
+
+    // ── Resource usage ────────────────────────────────────────────────────────
+
+    /**
+     * @brief Latest memory/CPU/JS-heap sample of this window's renderer.
+     *
+     * Filled in by a running ResourceSampler (Linux); all zeros otherwise.
+     * UI thread only.
+     */
+    [[nodiscard]] const ResourceUsage& resourceUsage() const { return resourceUsage_; }
+
     // ── GUI customization ─────────────────────────────────────────────────────
 
     /**
@@ -170,11 +252,34 @@ public:
     /** Access the current effective style. */
     [[nodiscard]] const WindowStyle& style() const { return config_.style; }
 
+    /**
+     * @brief Transition to `target` over `duration`, interpolated natively.
+     *
+     * Opacity, corner radius, background colour and shadow are interpolated
+     * once per display frame (the GTK frame clock on Linux, OnPaint for
+     * off-screen browsers, otherwise a ~60 Hz UI-thread timer). Each frame
+     * goes through the style diff, so only the properties that moved reach
+     * the OS. Non-animatable fields switch on the first frame.
+     *
+     * A new animateStyle() or setStyle() cancels the running animation;
+     * `done(false)` tells you it was superseded.
+     *
+     * JS: window.bamboo.animateStyle({ cornerRadius: 16 }, 250, 'ease-out')
+     */
+    void animateStyle(const WindowStyle& target,
+                      std::chrono::milliseconds duration,
+                      Easing easing = Easing::EaseInOut,
+                      std::function<void(bool finished)> done = {});
+
+    /** Stop a running animateStyle() where it is. */
+    void cancelStyleAnimation();
+
     /**
      * @brief Update individual drag regions (frameless windows).
      *
      * Replaces the current set. Regions are relative to the browser content area.
-     * Sending an empty vector clears all drag regions.
+     * Sending an empty vector clears all drag regions. Regions the page declares
+     * with CSS `app-region` are kept separately and applied after these.
      */
     void setDragRegions(std::vector<DragRegion> regions);
 
@@ -223,6 +328,59 @@ public:
     void openDevTools(bool docked = false);
     void closeDevTools();
 
+    /**
+     * DevTools Protocol client for this window's page, attached on first use
+     * (and again after the agent detaches). See DevTools.hpp.
+     */
+    [[nodiscard]] std::expected<std::shared_ptr<DevToolsClient>, DevToolsError> devTools();
+
+    // ── Profiling ────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Record a V8 CPU profile of the page for `duration` and write it
+     *        to `path` as a .cpuprofile (Chrome DevTools, speedscope).
+     *
+     * One at a time per window (ProfileError::Busy). `done` runs on the UI thread.
+     */
+    void captureCpuProfile(std::chrono::milliseconds duration, std::string path,
+                           ProfileCallback done = {});
+
+    /**
+     * @brief Write a .heapsnapshot of the page's JS heap to `path`.
+     *
+     * Chunks are unescaped straight to disk as V8 produces them, so a
+     * multi-GB snapshot costs no extra memory. The page is paused while V8
+     * walks the heap. Signals and hotkeys: see App::enableProfilingTriggers.
+     */
+    void captureHeapSnapshot(std::string path, ProfileCallback done = {});
+
+    // ── Input recording and replay ───────────────────────────────────────────
+
+    /**
+     * @brief Record trusted mouse, wheel and keyboard input in the page until
+     *        stopInputRecording(). Continues across navigations.
+     */
+    void startInputRecording();
+    /** `done` receives the recording once the page has sent its last batch. */
+    void stopInputRecording(std::function<void(InputSequence)> done);
+
+    /**
+     * @brief Replay `sequence` into this window through CEF's input events —
+     *        the same path as a real mouse and keyboard, off-screen included.
+     *
+     * Events keep their recorded timing (scaled by options.speed), and after
+     * each one the player waits for a rendered frame or for idle, so a slow
+     * page is measured rather than outrun. One replay at a time per window
+     * (InputError::Busy); `done` runs on the UI thread.
+     *
+     * Example: a typing benchmark without a display
+     *   win->replayInput(bamboo::InputSequence{}.click(120, 80).type("hello"),
+     *                    {}, [](auto r) { if (r) use(r->stepLatencyUs.percentile(0.95)); });
+     */
+    void replayInput(InputSequence sequence, InputReplayOptions options = {},
+                     InputPlayer::DoneCallback done = {});
+    void cancelInputReplay();
+
     // ── Zoom ─────────────────────────────────────────────────────────────────
 
     void setZoom(float factor);       // 1.0 = 100%
@@ -238,9 +396,47 @@ public:
 
     // ── Screenshot ───────────────────────────────────────────────────────────
 
-    /** Capture the current viewport as a PNG, returned as raw bytes. */
+    /** Capture the current viewport as a PNG, returned as raw bytes (empty on failure). */
     void captureScreenshot(std::function<void(std::vector<uint8_t> pngBytes)> callback);
 
+    /**
+     * @brief Capture the whole page — not just the viewport — to a PNG file.
+     *
+     * Off-screen browsers only. The page is scrolled one viewport-sized tile
+     * at a time and each tile's rows are streamed straight into the PNG
+     * encoder, so peak memory is bounded by the tile, not the page height.
+     * The original scroll position is restored afterwards.
+     */
+    void captureFullPage(std::string_view pngPath,
+                         std::function<void(bool success)> callback = {});
+
+    // ── Frame export ─────────────────────────────────────────────────────────
+
+    /**
+     * @brief Hand every off-screen frame to local processes via a memfd ring.
+     *
+     * Linux only (BrowserError::Unsupported elsewhere); requires an off-screen
+     * browser. Consumers connect to config.socketPath, receive the memfd once
+     * and are then notified per frame — no copy or encode on their side.
+     * See FrameExport.hpp for the wire protocol.
+     */
+    std::expected<void, BrowserError> exportFrames(FrameExportConfig config);
+    void stopFrameExport();
+
+    [[nodiscard]] std::optional<FrameExportStats> frameExportStats() const;
+
+    // ── Audio ────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Receive the page's audio as PCM, converted to `format`.
+     *
+     * Chunks arrive on Bamboo's audio thread — never the UI thread — and
+     * carry Chromium's presentation timestamp for A/V sync. Use AudioMixer
+     * to combine several windows or record to WAV. Pass an empty callback
+     * to stop receiving; capture ends too unless an AudioMixer uses the window.
+     */
+    void onAudio(AudioCallback cb, AudioFormat format = {});
+
     // ── Print ─────────────────────────────────────────────────────────────────
 
     void print();
@@ -259,11 +455,27 @@ public:
     using FindCallback         = std::function<void(const FindResult&)>;
     using FocusCallback        = std::function<void(bool gained)>;
     using StyleChangeCallback  = std::function<void(const WindowStyle&)>;
+    using PaintCallback        = std::function<void(const PaintEvent&)>;
+    using JankCallback         = std::function<void(const JankReport&)>;
 
     void onLoad(LoadCallback cb);
     void onTitleChange(TitleCallback cb);
     void onClose(CloseCallback cb);
     void onConsole(ConsoleCallback cb);
+
+    /**
+     * Send console output to a ConsoleSink (async JSON lines). The UI thread
+     * then only enqueues; onConsole() still runs if set, so leave it unset
+     * for chatty pages. Pass nullptr to detach.
+     */
+    void setConsoleSink(std::shared_ptr<ConsoleSink> sink);
+
+    /**
+     * Record this window's bridge traffic — fireMessage input, bound call
+     * results, sendMessage output — to a BridgeRecorder for offline replay
+     * (see replayBridgeLog). Pass nullptr to stop.
+     */
+    void setBridgeRecorder(std::shared_ptr<BridgeRecorder> recorder);
     void onMessage(MessageCallback cb);
 
     /**
@@ -281,6 +493,15 @@ public:
      */
     void onStyleChange(StyleChangeCallback cb);
 
+    /** Called for every rendered frame of an off-screen browser. */
+    void onPaint(PaintCallback cb);
+
+    /**
+     * Jank summaries observed in the page (long tasks, long animation
+     * frames, layout shifts). Always collected — wire this to telemetry.
+     */
+    void onJank(JankCallback cb);
+
     // ── Internals ─────────────────────────────────────────────────────────────
 
     [[nodiscard]] CefRefPtr<CefBrowser> cefBrowser() const { return cefBrowser_; }
@@ -293,16 +514,52 @@ public:
     void fireMessage(std::string_view event, std::string_view json);
     void fireNavigation(NavigationRequest& req);
     void fireFocus(bool gained);
+    void firePaint(const PaintEvent& e);
+
+    [[nodiscard]] const WindowConfig& config() const { return config_; }
+
+    /** Every live Browser, oldest first. UI thread only. */
+    [[nodiscard]] static std::vector<std::shared_ptr<Browser>> openBrowsers();
+
+    /** Renderer PID as last reported by the page (0 until the first load). */
+    [[nodiscard]] int rendererPid() const { return rendererPid_; }
+    /** Ask the renderer for performance.memory; lands in resourceUsage(). */
+    void requestHeapUsage();
+
+    /** The audio tap, created on first use. Capture starts with the next stream. */
+    std::shared_ptr<AudioTap> audioTap();
+    /** The audio tap if capture was requested, else null. Any thread. */
+    [[nodiscard]] std::shared_ptr<AudioTap> activeAudioTap() const;
 
 private:
+    friend class BambooClient;  // CEF callbacks reach into private state
+    friend class ResourceSampler;
+
     explicit Browser(WindowConfig config);
-    void applyStyleToPlatform(const WindowStyle& style);
+    void applyStyleToPlatform(const WindowStyle& style, StyleField changed);
+    void setCSSDragRegions(std::vector<DragRegion> regions);
+    void applyDragRegions(const std::vector<DragRegion>& appRegions);
     void injectBridgeCSS();
+    void sendBridgeCSS(std::string css, uint64_t hash);
+    void dispatchMessage(std::string_view event, std::string_view data);
+    void bindInternalFunctions();
+    [[nodiscard]] int browserId() const { return cefBrowser_ ? cefBrowser_->GetIdentifier() : 0; }
+    bool stepStyleAnimation();  // true while more frames are needed
+    void pumpStyleAnimationTimer(uint64_t generation);
+    void pumpFrameExportAccept(uint64_t generation);
+    void captureNextTile();
+    void finishCapture(bool ok);
+    /** Page.captureScreenshot; nullopt without DevTools or on a protocol error. */
+    void captureScreenshotBase64(std::function<void(std::optional<std::string>)> done);
 
     WindowConfig  config_;
     CefRefPtr<CefBrowser>     cefBrowser_;
     CefRefPtr<BambooClient>   client_;
     float                     zoomLevel_ = 1.0f;
+    WindowStyle               appliedStyle_;  // what the native window currently shows
+    std::vector<DragRegion>   cssDragRegions_;  // from -webkit-app-region; applied after the app's
+    uint64_t                  bridgeCSSHash_  = 0;  // last style CSS pushed to the renderer
+    uint64_t                  initialCSSHash_ = 0;  // the one baked into extra_info
 
     LoadCallback       onLoad_;
     TitleCallback      onTitleChange_;
@@ -313,13 +570,38 @@ private:
     FindCallback       onFind_;
     FocusCallback      onFocusChange_;
     StyleChangeCallback onStyleChange_;
-
-    std::unordered_map<int, std::function<void(std::expected<JsValue, BrowserError>)>>
-        pendingCallbacks_;
+    PaintCallback      onPaint_;
+    JankCallback       onJank_;
+    std::shared_ptr<ConsoleSink> consoleSink_;
+    std::shared_ptr<BridgeRecorder> bridgeRecorder_;
+
+    struct PendingEval {
+        std::function<void(std::expected<JsValue, BrowserError>)> callback;
+        std::chrono::steady_clock::time_point                     issued;
+    };
+    std::unordered_map<int, PendingEval> pendingCallbacks_;
     int nextCallbackId_ = 0;
 
     std::unordered_map<std::string, std::function<JsValue(std::vector<JsValue>)>>
         boundFunctions_;
+
+    BridgeStats bridgeStats_;
+    int           rendererPid_ = 0;
+    ResourceUsage resourceUsage_;
+    std::unique_ptr<FullPageCapture> capture_;
+    std::unique_ptr<StyleAnimationState> animation_;
+    uint64_t animationGeneration_ = 0;
+    std::unique_ptr<FrameExporter>   frameExporter_;
+    uint64_t                         frameExportGeneration_ = 0;
+    std::shared_ptr<DevToolsClient>  devTools_;
+    bool                             cpuProfiling_    = false;
+    bool                             heapSnapshotting_ = false;
+    std::optional<InputSequence>     inputRecording_;
+    double                           inputRecordingOriginMs_ = 0;  // epoch ms
+    std::shared_ptr<InputPlayer>     inputPlayer_;
+
+    mutable std::mutex        audioMutex_;  // guards audioTap_ (read from CEF's audio thread)
+    std::shared_ptr<AudioTap> audioTap_;
 };
 
 // ─── CEF client ───────────────────────────────────────────────────────────────
@@ -332,7 +614,10 @@ class BambooClient final
       public CefContextMenuHandler,
       public CefRequestHandler,
       public CefKeyboardHandler,
-      public CefFindHandler
+      public CefFindHandler,
+      public CefDragHandler,
+      public CefRenderHandler,
+      public CefAudioHandler
 {
 public:
     explicit BambooClient(std::shared_ptr<Browser> owner)
@@ -346,6 +631,9 @@ public:
     CefRefPtr<CefRequestHandler>     GetRequestHandler()      override { return this; }
     CefRefPtr<CefKeyboardHandler>    GetKeyboardHandler()     override { return this; }
     CefRefPtr<CefFindHandler>        GetFindHandler()         override { return this; }
+    CefRefPtr<CefDragHandler>        GetDragHandler()         override { return this; }
+    CefRefPtr<CefRenderHandler>      GetRenderHandler()       override { return this; }
+    CefRefPtr<CefAudioHandler>       GetAudioHandler()        override { return this; }
 
     // Lifespan
     void OnAfterCreated(CefRefPtr<CefBrowser> browser)                         override;
@@ -353,6 +641,7 @@ public:
     void OnBeforeClose(CefRefPtr<CefBrowser> browser)                          override;
 
     // Load
+    void OnLoadStart(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame>, TransitionType) override;
     void OnLoadEnd(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame>, int httpStatus) override;
     void OnLoadError(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame>, ErrorCode,
                      const CefString& errorText, const CefString& failedUrl)  override;
@@ -373,14 +662,42 @@ public:
     bool OnBeforeBrowse(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame>,
                         CefRefPtr<CefRequest>, bool isRedirect, bool isNav)    override;
 
+    // Keyboard
+    bool OnPreKeyEvent(CefRefPtr<CefBrowser>, const CefKeyEvent& event,
+                       CefEventHandle, bool* isKeyboardShortcut)               override;
+
     // Find
     void OnFindResult(CefRefPtr<CefBrowser>, int identifier,
                       int count, const CefRect&, int, bool finalUpdate)        override;
 
+    // Drag regions (-webkit-app-region / app-region in page CSS)
+    void OnDraggableRegionsChanged(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame>,
+                                   const std::vector<CefDraggableRegion>& regions) override;
+
+    // Renderer → browser process messages
+    bool OnProcessMessageReceived(CefRefPtr<CefBrowser>, CefRefPtr<CefFrame>,
+                                  CefProcessId, CefRefPtr<CefProcessMessage>) override;
+
+    // Off-screen rendering
+    void GetViewRect(CefRefPtr<CefBrowser>, CefRect& rect)                     override;
+    void OnPaint(CefRefPtr<CefBrowser>, PaintElementType type,
+                 const RectList& dirtyRects, const void* buffer,
+                 int width, int height)                                        override;
+
+    // Audio (CEF audio thread)
+    bool GetAudioParameters(CefRefPtr<CefBrowser>, CefAudioParameters& params) override;
+    void OnAudioStreamStarted(CefRefPtr<CefBrowser>, const CefAudioParameters& params,
+                              int channels)                                    override;
+    void OnAudioStreamPacket(CefRefPtr<CefBrowser>, const float** data,
+                             int frames, int64_t pts)                          override;
+    void OnAudioStreamStopped(CefRefPtr<CefBrowser>)                           override;
+    void OnAudioStreamError(CefRefPtr<CefBrowser>, const CefString& message)   override;
+
     IMPLEMENT_REFCOUNTING(BambooClient);
 
 private:
-    std::shared_ptr<Browser> owner_;
+    std::shared_ptr<Browser>  owner_;
+    std::shared_ptr<AudioTap> audioStream_;  // set for the duration of a stream
 };
 
 } // namespace bamboo
@@ -0,0 +1,221 @@
+// bamboo/ConsoleSink.cpp - see include/bamboo/ConsoleSink.hpp for API docs
+#include "bamboo/ConsoleSink.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+using json = nlohmann::json;
+
+namespace bamboo {
+
+namespace {
+
+constexpr size_t kRecentSlots      = 256;        // dedup cache entries (power of two)
+constexpr size_t kMaxMessageUnits  = 16 * 1024;  // longer messages are truncated
+constexpr size_t kMaxSourceUnits   = 2 * 1024;
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t h = 0xcbf29ce484222325ull) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 0x100000001b3ull; }
+    return h;
+}
+
+int64_t steadyUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t epochMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string hex(uint64_t v) {
+    char buf[16];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof buf, v, 16);
+    std::string out(16 - static_cast<size_t>(end - buf), '0');
+    out.append(buf, end);
+    return out;
+}
+
+const char* levelName(uint8_t level) {
+    switch (static_cast<ConsoleEvent::Level>(level)) {
+        case ConsoleEvent::Level::Debug:   return "debug";
+        case ConsoleEvent::Level::Info:    return "info";
+        case ConsoleEvent::Level::Warning: return "warning";
+        case ConsoleEvent::Level::Error:   return "error";
+    }
+    return "info";
+}
+
+// UTF-16 → UTF-8; unpaired surrogates become U+FFFD.
+void appendUtf8(std::string& out, const char16_t* s, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t c = s[i];
+        if (c >= 0xD800 && c <= 0xDBFF && i + 1 < n && s[i + 1] >= 0xDC00 && s[i + 1] <= 0xDFFF)
+            c = 0x10000 + ((c - 0xD800) << 10) + (s[++i] - 0xDC00);
+        else if (c >= 0xD800 && c <= 0xDFFF)
+            c = 0xFFFD;
+
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (c < 0x800) {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (c >> 18));
+            out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+}
+
+} // namespace
+
+// ─── Lifetime ─────────────────────────────────────────────────────────────────
+
+ConsoleSink::ConsoleSink(ConsoleSinkConfig config)
+    : config_(std::move(config)),
+      recent_(kRecentSlots),
+      tokens_(config_.burst),
+      ring_(std::max(config_.ringBytes, RecordRing<RecordHeader>::frameBytes() +
+                     (kMaxMessageUnits + kMaxSourceUnits) * sizeof(char16_t))) {}
+
+ConsoleSink::~ConsoleSink() {
+    ring_.stop();
+}
+
+std::expected<std::shared_ptr<ConsoleSink>, ConsoleSinkError>
+ConsoleSink::open(ConsoleSinkConfig config) {
+    auto sink = std::shared_ptr<ConsoleSink>(new ConsoleSink(std::move(config)));
+    sink->file_.open(sink->config_.path, std::ios::binary | std::ios::app);
+    if (!sink->file_) return std::unexpected(ConsoleSinkError::OpenFailed);
+    sink->lastRefillUs_ = steadyUs();
+    sink->lastSummary_  = std::chrono::steady_clock::now();
+    sink->ring_.start(sink->config_.flushInterval,
+        [s = sink.get()](const RecordHeader& h, std::span<const std::byte> body) { s->write(h, body); },
+        [s = sink.get()](bool final) { s->idle(final); });
+    return sink;
+}
+
+ConsoleSink::Stats ConsoleSink::stats() const {
+    return { written_.load(std::memory_order_relaxed), deduplicated_.load(std::memory_order_relaxed),
+             rateLimited_.load(std::memory_order_relaxed), overflowed_.load(std::memory_order_relaxed) };
+}
+
+// ─── Producer (UI thread) ─────────────────────────────────────────────────────
+
+bool ConsoleSink::push(int browserId, ConsoleEvent::Level level,
+                       std::u16string_view message, std::u16string_view source, int line) {
+    if (level < config_.minLevel) return false;
+
+    bool truncated = false;
+    if (message.size() > kMaxMessageUnits) { message = message.substr(0, kMaxMessageUnits); truncated = true; }
+    if (source.size()  > kMaxSourceUnits)  source  = source.substr(0, kMaxSourceUnits);
+
+    uint64_t hash = fnv1a(message.data(), message.size() * sizeof(char16_t));
+    hash = fnv1a(source.data(), source.size() * sizeof(char16_t), hash);
+    hash = fnv1a(&line, sizeof line, hash);
+
+    const int64_t now = steadyUs();
+    auto& recent = recent_[hash & (kRecentSlots - 1)];
+    const bool repeat = config_.dedupWindow.count() > 0 &&
+                        recent.hash == hash && recent.browserId == browserId &&
+                        now - recent.fullUs < config_.dedupWindow.count() * 1000;
+
+    if (!repeat && config_.ratePerSec > 0) {
+        tokens_ = std::min(config_.burst, tokens_ + (now - lastRefillUs_) * config_.ratePerSec / 1e6);
+        lastRefillUs_ = now;
+        if (tokens_ < 1.0) { rateLimited_.fetch_add(1, std::memory_order_relaxed); return false; }
+        tokens_ -= 1.0;
+    }
+
+    RecordHeader h{
+        .hash         = hash,
+        .timeMs       = epochMs(),
+        .browserId    = browserId,
+        .line         = line,
+        .messageUnits = repeat ? 0u : static_cast<uint32_t>(message.size()),
+        .sourceUnits  = repeat ? 0u : static_cast<uint32_t>(source.size()),
+        .level        = static_cast<uint8_t>(level),
+        .repeat       = repeat,
+        .truncated    = truncated,
+        .reserved     = 0,
+    };
+    if (repeat) { message = {}; source = {}; }
+    if (!ring_.push(h, { recordBytes(message), recordBytes(source) })) {
+        overflowed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (repeat) deduplicated_.fetch_add(1, std::memory_order_relaxed);
+    else        recent = { hash, browserId, now };
+    return true;
+}
+
+// ─── Writer thread ────────────────────────────────────────────────────────────
+
+void ConsoleSink::idle(bool final) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto summaryEvery = std::max(config_.dedupWindow, std::chrono::milliseconds(1000));
+    if (final || now - lastSummary_ >= summaryEvery) { writeSummaries(epochMs()); lastSummary_ = now; }
+    file_.flush();
+}
+
+void ConsoleSink::write(const RecordHeader& h, std::span<const std::byte> body) {
+    if (h.repeat) {
+        auto it = std::ranges::find_if(repeats_, [&](const Repeat& r) {
+            return r.hash == h.hash && r.browserId == h.browserId;
+        });
+        if (it == repeats_.end()) repeats_.push_back({ h.hash, h.browserId, 1 });
+        else                      ++it->count;
+        return;
+    }
+
+    std::u16string message(h.messageUnits, u'\0'), source(h.sourceUnits, u'\0');
+    std::memcpy(message.data(), body.data(), h.messageUnits * sizeof(char16_t));
+    std::memcpy(source.data(), body.data() + h.messageUnits * sizeof(char16_t),
+                h.sourceUnits * sizeof(char16_t));
+
+    json line = {
+        {"ts",      h.timeMs},
+        {"browser", h.browserId},
+        {"level",   levelName(h.level)},
+    };
+    utf8_.clear(); appendUtf8(utf8_, message.data(), message.size());
+    line["message"] = utf8_;
+    utf8_.clear(); appendUtf8(utf8_, source.data(), source.size());
+    line["source"] = utf8_;
+    line["line"]   = h.line;
+    line["hash"]   = hex(h.hash);
+    if (h.truncated) line["truncated"] = true;
+
+    file_ << line.dump(-1, ' ', false, json::error_handler_t::replace) << '\n';
+    written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConsoleSink::writeSummaries(int64_t nowMs) {
+    for (const auto& r : repeats_) {
+        file_ << json{ {"ts", nowMs}, {"browser", r.browserId}, {"hash", hex(r.hash)},
+                       {"repeated", r.count} }.dump() << '\n';
+    }
+    repeats_.clear();
+
+    const uint64_t limited  = rateLimited_.load(std::memory_order_relaxed);
+    const uint64_t overflow = overflowed_.load(std::memory_order_relaxed);
+    if (limited != reportedRateLimited_ || overflow != reportedOverflowed_) {
+        file_ << json{ {"ts", nowMs}, {"dropped", {
+                           {"rateLimited", limited - reportedRateLimited_},
+                           {"overflow",    overflow - reportedOverflowed_} }} }.dump() << '\n';
+        reportedRateLimited_ = limited;
+        reportedOverflowed_  = overflow;
+    }
+}
+
+} // namespace bamboo
@@ -0,0 +1,142 @@
+#pragma once
+// bamboo/ConsoleSink.hpp
+// Asynchronous console log pipeline: UI thread → lock-free ring → JSON lines.
+//
+// The UI thread only rate-limits, hashes and copies the raw UTF-16 message
+// into a byte ring; conversion, JSON encoding and file I/O happen on the
+// sink's own writer thread. Repeats of a message within the dedup window
+// are sent as a hash alone and written as one "repeated" line.
+
+#include "bamboo/RecordRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bamboo {
+
+struct ConsoleEvent {
+    enum class Level { Debug, Info, Warning, Error };
+    Level       level;
+    std::string message;
+    std::string source;
+    int         line;
+};
+
+enum class ConsoleSinkError {
+    OpenFailed,
+};
+
+struct ConsoleSinkConfig {
+    std::string path;                                 // JSON-lines file, appended to
+    size_t      ringBytes   = size_t(1) << 20;
+    double      ratePerSec  = 1000;                   // new lines/s; 0 = unlimited
+    double      burst       = 2000;                   // token-bucket depth
+    std::chrono::milliseconds dedupWindow{1000};      // 0 = write every line
+    std::chrono::milliseconds flushInterval{50};
+    ConsoleEvent::Level       minLevel = ConsoleEvent::Level::Debug;
+};
+
+/**
+ * @brief Structured, rate-limited console log file shared by any number of windows.
+ *
+ * Output, one JSON object per line:
+ *   {"ts":1718000000123,"browser":1,"level":"warning","message":"…",
+ *    "source":"https://…/app.js","line":42,"hash":"9f1c…"}
+ *   {"ts":…,"browser":1,"hash":"9f1c…","repeated":317}
+ *   {"ts":…,"dropped":{"rateLimited":1200,"overflow":0}}
+ *
+ * push() is wait-free and must only be called from one thread (Browser calls
+ * it from the CEF UI thread). Destroying the sink drains and closes the file.
+ *
+ * Example:
+ *   auto sink = bamboo::ConsoleSink::open({ .path = "console.jsonl" }).value();
+ *   win1->setConsoleSink(sink);
+ *   win2->setConsoleSink(sink);
+ */
+class ConsoleSink {
+public:
+    struct Stats {
+        uint64_t written;       // full lines on disk
+        uint64_t deduplicated;  // repeats folded into "repeated" lines
+        uint64_t rateLimited;
+        uint64_t overflowed;    // ring full (writer fell behind)
+    };
+
+    ~ConsoleSink();
+
+    ConsoleSink(const ConsoleSink&)            = delete;
+    ConsoleSink& operator=(const ConsoleSink&) = delete;
+
+    [[nodiscard]]
+    static std::expected<std::shared_ptr<ConsoleSink>, ConsoleSinkError>
+    open(ConsoleSinkConfig config);
+
+    /** Enqueue one console message. Returns false if it was dropped. */
+    bool push(int browserId, ConsoleEvent::Level level,
+              std::u16string_view message, std::u16string_view source, int line);
+
+    [[nodiscard]] Stats stats() const;
+
+private:
+    // Fixed part of every record in the ring; UTF-16 message + source follow.
+    struct RecordHeader {
+        uint64_t hash;
+        int64_t  timeMs;        // Unix epoch
+        int32_t  browserId;
+        int32_t  line;
+        uint32_t messageUnits;
+        uint32_t sourceUnits;
+        uint8_t  level;
+        uint8_t  repeat;        // hash only; no text follows
+        uint8_t  truncated;
+        uint8_t  reserved;
+    };
+
+    explicit ConsoleSink(ConsoleSinkConfig config);
+    void write(const RecordHeader& h, std::span<const std::byte> body);
+    void idle(bool final);
+    void writeSummaries(int64_t nowMs);
+
+    struct RecentHash {
+        uint64_t hash      = 0;
+        int32_t  browserId = 0;
+        int64_t  fullUs    = 0;  // when the full text was last enqueued
+    };
+    struct Repeat {
+        uint64_t hash;
+        int32_t  browserId;
+        uint64_t count;
+    };
+
+    ConsoleSinkConfig config_;
+
+    // Producer (UI thread) state
+    std::vector<RecentHash>      recent_;     // direct-mapped dedup cache
+    double                       tokens_;
+    int64_t                      lastRefillUs_ = 0;
+
+    // Writer thread state
+    std::ofstream                file_;
+    std::vector<Repeat>          repeats_;
+    std::string                  utf8_;
+    std::chrono::steady_clock::time_point lastSummary_;
+    uint64_t                     reportedRateLimited_ = 0;
+    uint64_t                     reportedOverflowed_  = 0;
+
+    std::atomic<uint64_t>        written_{0};
+    std::atomic<uint64_t>        deduplicated_{0};
+    std::atomic<uint64_t>        rateLimited_{0};
+    std::atomic<uint64_t>        overflowed_{0};
+
+    RecordRing<RecordHeader>     ring_;       // last: its writer thread uses the state above
+};
+
+} // namespace bamboo
@@ -0,0 +1,134 @@
+// bamboo/DevTools.cpp - see include/bamboo/DevTools.hpp for API docs
+#include "bamboo/DevTools.hpp"
+#include "bamboo/Browser.hpp"
+#include "include/cef_devtools_message_observer.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include <atomic>
+#include <format>
+
+using json = nlohmann::json;
+
+namespace bamboo {
+
+namespace {
+
+// Every observer on a browser sees every reply, so ids are unique per process.
+int nextMessageId() {
+    static std::atomic<int> id{1'000'000};
+    return id.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// ─── CEF observer ─────────────────────────────────────────────────────────────
+
+class DevToolsObserver final : public CefDevToolsMessageObserver {
+public:
+    explicit DevToolsObserver(std::weak_ptr<DevToolsClient> client) : client_(std::move(client)) {}
+
+    void OnDevToolsMethodResult(CefRefPtr<CefBrowser>, int id, bool success,
+                                const void* result, size_t size) override {
+        if (auto c = client_.lock()) c->onResult(id, success, { static_cast<const char*>(result), size });
+    }
+    void OnDevToolsEvent(CefRefPtr<CefBrowser>, const CefString& method,
+                         const void* params, size_t size) override {
+        if (auto c = client_.lock()) c->onEvent(method.ToString(), { static_cast<const char*>(params), size });
+    }
+    void OnDevToolsAgentDetached(CefRefPtr<CefBrowser>) override {
+        if (auto c = client_.lock()) c->onDetached();
+    }
+
+    IMPLEMENT_REFCOUNTING(DevToolsObserver);
+private:
+    std::weak_ptr<DevToolsClient> client_;
+};
+
+// ─── Client ───────────────────────────────────────────────────────────────────
+
+std::expected<std::shared_ptr<DevToolsClient>, DevToolsError>
+DevToolsClient::attach(const std::shared_ptr<Browser>& browser) {
+    CEF_REQUIRE_UI_THREAD();
+    auto cef = browser ? browser->cefBrowser() : nullptr;
+    if (!cef) return std::unexpected(DevToolsError::NoBrowser);
+
+    auto client = std::shared_ptr<DevToolsClient>(new DevToolsClient(browser));
+    client->registration_ = cef->GetHost()->AddDevToolsMessageObserver(new DevToolsObserver(client));
+    if (!client->registration_) return std::unexpected(DevToolsError::NoBrowser);
+    return client;
+}
+
+DevToolsClient::~DevToolsClient() {
+    registration_ = nullptr;  // unregisters the observer
+    auto pending = std::move(pending_);
+    for (auto& [id, cb] : pending) cb(std::unexpected(CdpError{ DevToolsError::Detached, 0, "client destroyed" }));
+}
+
+void DevToolsClient::send(std::string_view method, const json& params, ResultCallback cb) {
+    auto browser = browser_.lock();
+    auto cef     = browser ? browser->cefBrowser() : nullptr;
+    if (!cef || detached_) {
+        failLater(std::move(cb), { detached_ ? DevToolsError::Detached : DevToolsError::NoBrowser, 0, {} });
+        return;
+    }
+    const int id = nextMessageId();
+    const std::string message = std::format(R"({{"id":{},"method":{},"params":{}}})", id,
+                                            json(method).dump(), params.is_null() ? "{}" : params.dump());
+    pending_.emplace(id, std::move(cb));
+    if (!cef->GetHost()->SendDevToolsMessage(message.data(), message.size())) {
+        auto node = pending_.extract(id);
+        failLater(std::move(node.mapped()), { DevToolsError::SendFailed, 0, std::string(method) });
+    }
+}
+
+void DevToolsClient::failLater(ResultCallback cb, CdpError error) {
+    CefPostTask(TID_UI, CefCreateClosureTask([cb = std::move(cb), error = std::move(error)] {
+        cb(std::unexpected(error));
+    }));
+}
+
+DevToolsClient::SubscriptionId DevToolsClient::on(std::string event, EventCallback cb) {
+    const SubscriptionId id = nextSubscription_++;
+    subscriptions_[std::move(event)].push_back({ id, std::move(cb) });
+    return id;
+}
+
+void DevToolsClient::off(SubscriptionId id) {
+    for (auto it = subscriptions_.begin(); it != subscriptions_.end();) {
+        std::erase_if(it->second, [id](const Subscription& s) { return s.id == id; });
+        it = it->second.empty() ? subscriptions_.erase(it) : std::next(it);
+    }
+}
+
+void DevToolsClient::onResult(int id, bool success, std::string_view result) {
+    auto node = pending_.extract(id);
+    if (node.empty()) return;  // another client's command
+    if (success) {
+        node.mapped()(CdpMessage(result));
+        return;
+    }
+    // Failures carry {"code":…,"message":…}; small, so parse it.
+    auto j = json::parse(result, nullptr, false);
+    node.mapped()(std::unexpected(CdpError{
+        DevToolsError::Protocol,
+        j.is_object() ? j.value("code", 0) : 0,
+        j.is_object() ? j.value("message", std::string{}) : std::string(result),
+    }));
+}
+
+void DevToolsClient::onEvent(const std::string& method, std::string_view params) {
+    auto it = subscriptions_.find(method);
+    if (it == subscriptions_.end()) return;
+    // Copy: a callback may subscribe or unsubscribe.
+    const auto subs = it->second;
+    for (const auto& s : subs) s.callback(CdpMessage(params));
+}
+
+void DevToolsClient::onDetached() {
+    detached_ = true;
+    auto pending = std::move(pending_);
+    pending_.clear();
+    for (auto& [id, cb] : pending) cb(std::unexpected(CdpError{ DevToolsError::Detached, 0, {} }));
+}
+
+} // namespace bamboo
@@ -0,0 +1,391 @@
+#pragma once
+// bamboo/DevTools.hpp
+// In-process Chrome DevTools Protocol client: typed, awaitable commands and
+// event subscriptions over CefBrowserHost::SendDevToolsMessage — no remote
+// debugging port, no WebSocket.
+
+#include <nlohmann/json.hpp>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "include/cef_registration.h"
+
+namespace bamboo {
+
+class Browser;
+class DevToolsObserver;
+
+// ─── Messages and errors ──────────────────────────────────────────────────────
+
+enum class DevToolsError {
+    NoBrowser,      // the window has no CEF browser (yet, or any more)
+    SendFailed,
+    Detached,       // DevTools agent went away before the reply
+    Protocol,       // Chromium answered with an error; see CdpError::code/message
+    BadResult,      // the reply did not match the expected type
+};
+
+struct CdpError {
+    DevToolsError kind;
+    int           code = 0;   // CDP error code (Protocol only)
+    std::string   message;
+};
+
+/**
+ * @brief A CDP result or event payload, as the JSON text Chromium sent.
+ *
+ * A view into CEF's buffer: valid only for the duration of the callback.
+ * Large results (profiles, coverage, snapshot chunks) can be scanned or
+ * written out without a copy; parse() builds a DOM when that is easier.
+ */
+class CdpMessage {
+public:
+    explicit CdpMessage(std::string_view raw) : raw_(raw) {}
+
+    [[nodiscard]] std::string_view raw()   const { return raw_; }
+    [[nodiscard]] nlohmann::json   parse() const { return nlohmann::json::parse(raw_, nullptr, false); }
+
+private:
+    std::string_view raw_;
+};
+
+// ─── Typed commands ───────────────────────────────────────────────────────────
+// A command is a struct of its params with `method` and a `Result` type; an
+// event is a struct of its params with `event`. Both (de)serialize through
+// nlohmann::json, so adding one is a few lines here.
+
+namespace cdp {
+
+struct Empty {};
+inline void to_json(nlohmann::json& j, const Empty&) { j = nlohmann::json::object(); }
+inline void from_json(const nlohmann::json&, Empty&) {}
+
+template <class Command>
+nlohmann::json paramsOf(const Command& cmd) {
+    if constexpr (std::is_empty_v<Command>) return nlohmann::json::object();
+    else                                    return cmd;
+}
+
+template <class T>
+std::expected<T, CdpError> parseResult(std::string_view raw) {
+    auto j = nlohmann::json::parse(raw, nullptr, false);
+    if (j.is_discarded()) return std::unexpected(CdpError{ DevToolsError::BadResult, 0, "malformed JSON" });
+    if constexpr (std::is_same_v<T, nlohmann::json>) {
+        return j;
+    } else {
+        try { return j.get<T>(); }
+        catch (const nlohmann::json::exception& e) {
+            return std::unexpected(CdpError{ DevToolsError::BadResult, 0, e.what() });
+        }
+    }
+}
+
+namespace Runtime {
+/** Primitive results come back in `value` (returnByValue); `description` otherwise. */
+struct RemoteObject {
+    std::string    type;
+    nlohmann::json value;
+    std::string    description;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(RemoteObject, type, value, description)
+
+/** Runs in the main frame's page context; needs no Runtime.enable. */
+struct evaluate {
+    static constexpr std::string_view method = "Runtime.evaluate";
+    struct Result {
+        RemoteObject   result;
+        nlohmann::json exceptionDetails;   // null unless the expression threw
+    };
+    std::string expression;
+    bool        awaitPromise  = false;     // settle a returned promise first
+    bool        returnByValue = true;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(evaluate, expression, awaitPromise, returnByValue)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(evaluate::Result, result, exceptionDetails)
+} // namespace Runtime
+
+namespace Page {
+/** The visible viewport, encoded by the renderer. */
+struct captureScreenshot {
+    static constexpr std::string_view method = "Page.captureScreenshot";
+    struct Result { std::string data; };   // base64
+    std::string format = "png";
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(captureScreenshot, format)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(captureScreenshot::Result, data)
+} // namespace Page
+
+namespace Performance {
+struct Metric { std::string name; double value = 0; };
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(Metric, name, value)
+
+struct enable     { static constexpr std::string_view method = "Performance.enable";  using Result = Empty; };
+struct disable    { static constexpr std::string_view method = "Performance.disable"; using Result = Empty; };
+struct getMetrics {
+    static constexpr std::string_view method = "Performance.getMetrics";
+    struct Result { std::vector<Metric> metrics; };
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(getMetrics::Result, metrics)
+} // namespace Performance
+
+namespace Emulation {
+struct setCPUThrottlingRate {
+    static constexpr std::string_view method = "Emulation.setCPUThrottlingRate";
+    using Result = Empty;
+    double rate = 1;  // slowdown factor; 1 = none
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(setCPUThrottlingRate, rate)
+
+struct setDeviceMetricsOverride {
+    static constexpr std::string_view method = "Emulation.setDeviceMetricsOverride";
+    using Result = Empty;
+    int    width = 0, height = 0;   // 0 = no override
+    double deviceScaleFactor = 0;   // 0 = no override
+    bool   mobile = false;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(setDeviceMetricsOverride, width, height, deviceScaleFactor, mobile)
+
+struct clearDeviceMetricsOverride {
+    static constexpr std::string_view method = "Emulation.clearDeviceMetricsOverride";
+    using Result = Empty;
+};
+} // namespace Emulation
+
+namespace Network {
+struct enable { static constexpr std::string_view method = "Network.enable"; using Result = Empty; };
+struct emulateNetworkConditions {
+    static constexpr std::string_view method = "Network.emulateNetworkConditions";
+    using Result = Empty;
+    bool   offline = false;
+    double latency = 0;              // ms
+    double downloadThroughput = -1;  // bytes/s; -1 = unthrottled
+    double uploadThroughput   = -1;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(emulateNetworkConditions, offline, latency,
+                                                downloadThroughput, uploadThroughput)
+} // namespace Network
+
+namespace Profiler {
+struct enable  { static constexpr std::string_view method = "Profiler.enable";  using Result = Empty; };
+struct disable { static constexpr std::string_view method = "Profiler.disable"; using Result = Empty; };
+struct setSamplingInterval {
+    static constexpr std::string_view method = "Profiler.setSamplingInterval";
+    using Result = Empty;
+    int interval = 1000;  // µs
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(setSamplingInterval, interval)
+struct start { static constexpr std::string_view method = "Profiler.start"; using Result = Empty; };
+/** The result is a (large) .cpuprofile; take it raw with DevToolsClient::send(method, …). */
+struct stop  { static constexpr std::string_view method = "Profiler.stop";  using Result = nlohmann::json; };
+
+struct startPreciseCoverage {
+    static constexpr std::string_view method = "Profiler.startPreciseCoverage";
+    struct Result { double timestamp = 0; };
+    bool callCount = true;
+    bool detailed  = true;   // block-level, not just function-level
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(startPreciseCoverage, callCount, detailed)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(startPreciseCoverage::Result, timestamp)
+
+struct CoverageRange { int startOffset = 0, endOffset = 0, count = 0; };
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(CoverageRange, startOffset, endOffset, count)
+struct FunctionCoverage {
+    std::string                functionName;
+    std::vector<CoverageRange> ranges;
+    bool                       isBlockCoverage = false;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(FunctionCoverage, functionName, ranges, isBlockCoverage)
+struct ScriptCoverage {
+    std::string                   scriptId, url;
+    std::vector<FunctionCoverage> functions;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(ScriptCoverage, scriptId, url, functions)
+
+struct takePreciseCoverage {
+    static constexpr std::string_view method = "Profiler.takePreciseCoverage";
+    struct Result { std::vector<ScriptCoverage> result; double timestamp = 0; };
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(takePreciseCoverage::Result, result, timestamp)
+struct stopPreciseCoverage {
+    static constexpr std::string_view method = "Profiler.stopPreciseCoverage";
+    using Result = Empty;
+};
+} // namespace Profiler
+
+namespace HeapProfiler {
+struct enable         { static constexpr std::string_view method = "HeapProfiler.enable";         using Result = Empty; };
+struct collectGarbage { static constexpr std::string_view method = "HeapProfiler.collectGarbage"; using Result = Empty; };
+/** Chunks arrive as addHeapSnapshotChunk events before the result. */
+struct takeHeapSnapshot {
+    static constexpr std::string_view method = "HeapProfiler.takeHeapSnapshot";
+    using Result = Empty;
+    bool reportProgress = false;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(takeHeapSnapshot, reportProgress)
+
+struct reportHeapSnapshotProgress {
+    static constexpr std::string_view event = "HeapProfiler.reportHeapSnapshotProgress";
+    int  done = 0, total = 0;
+    bool finished = false;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(reportHeapSnapshotProgress, done, total, finished)
+
+/** One slice of snapshot JSON. Snapshots run to GBs: stream chunk.raw() rather than parse. */
+struct addHeapSnapshotChunk {
+    static constexpr std::string_view event = "HeapProfiler.addHeapSnapshotChunk";
+    std::string chunk;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(addHeapSnapshotChunk, chunk)
+} // namespace HeapProfiler
+
+} // namespace cdp
+
+// ─── Coroutine support ────────────────────────────────────────────────────────
+
+/**
+ * Fire-and-forget coroutine for driving DevTools from the UI thread:
+ *   bamboo::DetachedTask sample(std::shared_ptr<bamboo::DevToolsClient> dt) {
+ *       co_await dt->call(cdp::Performance::enable{});
+ *       auto m = co_await dt->call(cdp::Performance::getMetrics{});
+ *   }
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask        get_return_object() noexcept { return {}; }
+        std::suspend_never  initial_suspend() noexcept { return {}; }
+        std::suspend_never  final_suspend() noexcept { return {}; }
+        void                return_void() noexcept {}
+        void                unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+class DevToolsClient;
+
+/** co_await-able command; resumes on the UI thread with the typed result. */
+template <class T>
+class CdpAwaiter {
+public:
+    CdpAwaiter(std::shared_ptr<DevToolsClient> client, std::string_view method, nlohmann::json params)
+        : client_(std::move(client)), method_(method), params_(std::move(params)) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h);
+    std::expected<T, CdpError> await_resume() { return std::move(*result_); }
+
+private:
+    std::shared_ptr<DevToolsClient>           client_;
+    std::string_view                          method_;
+    nlohmann::json                            params_;
+    std::optional<std::expected<T, CdpError>> result_;
+};
+
+// ─── Client ───────────────────────────────────────────────────────────────────
+
+/**
+ * @brief DevTools Protocol session on one window's page target.
+ *
+ * Get one with Browser::devTools(). Commands go out with SendDevToolsMessage
+ * and every callback runs later on the CEF UI thread — errors included — so
+ * co_await never resumes inside the call. Results and events are handed over
+ * as CdpMessage views straight from CEF's buffer; the typed overloads parse
+ * them into the cdp:: structs. Domains still need their X.enable command.
+ *
+ * Pending commands fail with Detached if the agent detaches or the client
+ * is destroyed. UI thread only.
+ *
+ * Example:
+ *   auto dt = win->devTools().value();
+ *   dt->send(cdp::Emulation::setCPUThrottlingRate{ .rate = 4 }, [](auto r) { ... });
+ *   dt->on("Runtime.consoleAPICalled", [](bamboo::CdpMessage m) { ... });
+ */
+class DevToolsClient : public std::enable_shared_from_this<DevToolsClient> {
+public:
+    using ResultCallback = std::function<void(std::expected<CdpMessage, CdpError>)>;
+    using EventCallback  = std::function<void(CdpMessage params)>;
+    using SubscriptionId = uint64_t;
+
+    ~DevToolsClient();
+
+    DevToolsClient(const DevToolsClient&)            = delete;
+    DevToolsClient& operator=(const DevToolsClient&) = delete;
+
+    [[nodiscard]]
+    static std::expected<std::shared_ptr<DevToolsClient>, DevToolsError>
+    attach(const std::shared_ptr<Browser>& browser);
+
+    /** Untyped command; `params` may be null. The callback sees the raw "result" object. */
+    void send(std::string_view method, const nlohmann::json& params, ResultCallback cb);
+
+    template <class Command>
+    void send(const Command& cmd, std::function<void(std::expected<typename Command::Result, CdpError>)> cb) {
+        send(Command::method, cdp::paramsOf(cmd), [cb = std::move(cb)](std::expected<CdpMessage, CdpError> r) {
+            if (!r) cb(std::unexpected(std::move(r.error())));
+            else    cb(cdp::parseResult<typename Command::Result>(r->raw()));
+        });
+    }
+
+    /** co_await dt->call(cdp::Performance::getMetrics{}) → expected<Result, CdpError>. */
+    template <class Command>
+    [[nodiscard]] CdpAwaiter<typename Command::Result> call(const Command& cmd) {
+        return { shared_from_this(), Command::method, cdp::paramsOf(cmd) };
+    }
+    [[nodiscard]] CdpAwaiter<nlohmann::json> call(std::string_view method, nlohmann::json params = {}) {
+        return { shared_from_this(), method, std::move(params) };
+    }
+
+    /** Subscribe to a CDP event by name ("Network.requestWillBeSent"). */
+    SubscriptionId on(std::string event, EventCallback cb);
+
+    template <class Event>
+    SubscriptionId on(std::function<void(const Event&)> cb) {
+        return on(std::string(Event::event), [cb = std::move(cb)](CdpMessage m) {
+            if (auto e = cdp::parseResult<Event>(m.raw())) cb(*e);
+        });
+    }
+
+    void off(SubscriptionId id);
+
+    [[nodiscard]] bool attached() const { return !detached_; }
+
+private:
+    friend class DevToolsObserver;
+
+    explicit DevToolsClient(std::weak_ptr<Browser> browser) : browser_(std::move(browser)) {}
+
+    void onResult(int id, bool success, std::string_view result);
+    void onEvent(const std::string& method, std::string_view params);
+    void onDetached();
+    void failLater(ResultCallback cb, CdpError error);
+
+    struct Subscription {
+        SubscriptionId id;
+        EventCallback  callback;
+    };
+
+    std::weak_ptr<Browser>                                     browser_;
+    CefRefPtr<CefRegistration>                                 registration_;
+    std::unordered_map<int, ResultCallback>                    pending_;
+    std::unordered_map<std::string, std::vector<Subscription>> subscriptions_;
+    SubscriptionId                                             nextSubscription_ = 1;
+    bool                                                       detached_ = false;
+};
+
+template <class T>
+void CdpAwaiter<T>::await_suspend(std::coroutine_handle<> h) {
+    client_->send(method_, params_, [this, h](std::expected<CdpMessage, CdpError> r) {
+        if (r) result_ = cdp::parseResult<T>(r->raw());
+        else   result_ = std::unexpected(std::move(r.error()));
+        h.resume();
+    });
+}
+
+} // namespace bamboo
@@ -0,0 +1,108 @@
+// bamboo/DragRegionIndex.cpp - see include/bamboo/DragRegionIndex.hpp for API docs
+#include "bamboo/DragRegionIndex.hpp"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace bamboo {
+
+void DragRegionIndex::rebuild(std::span<const DragRegion> regions) {
+    slabX_.clear();
+    slabFirst_.clear();
+    segments_.clear();
+
+    std::vector<int> xs;
+    xs.reserve(regions.size() * 2);
+    for (const auto& r : regions) {
+        if (r.width <= 0 || r.height <= 0) continue;
+        xs.push_back(r.x);
+        xs.push_back(r.x + r.width);
+    }
+    std::ranges::sort(xs);
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+    if (xs.size() < 2) return;
+
+    std::vector<const DragRegion*> active;
+    std::vector<int>               ys;
+    std::vector<int8_t>            cell;  // -1 unresolved, 0 no-drag, 1 drag
+    std::vector<uint32_t>          next;  // union-find "next unresolved cell"
+
+    auto findNext = [&](uint32_t c) {
+        uint32_t root = c;
+        while (next[root] != root) root = next[root];
+        while (next[c] != root) c = std::exchange(next[c], root);
+        return root;
+    };
+
+    for (size_t s = 0; s + 1 < xs.size(); ++s) {
+        const int x0 = xs[s], x1 = xs[s + 1];
+
+        active.clear();
+        ys.clear();
+        for (const auto& r : regions) {
+            if (r.width <= 0 || r.height <= 0) continue;
+            if (r.x <= x0 && r.x + r.width >= x1) {
+                active.push_back(&r);
+                ys.push_back(r.y);
+                ys.push_back(r.y + r.height);
+            }
+        }
+        std::ranges::sort(ys);
+        ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+        // Resolve each elementary y-cell to the *last* region covering it:
+        // walk regions back to front and only fill cells nobody claimed yet.
+        const uint32_t cells = ys.empty() ? 0 : static_cast<uint32_t>(ys.size() - 1);
+        cell.assign(cells, -1);
+        next.resize(cells + 1);
+        std::iota(next.begin(), next.end(), 0u);
+        for (auto it = active.rbegin(); it != active.rend(); ++it) {
+            const auto* r = *it;
+            const auto a = static_cast<uint32_t>(std::ranges::lower_bound(ys, r->y) - ys.begin());
+            const auto b = static_cast<uint32_t>(std::ranges::lower_bound(ys, r->y + r->height) - ys.begin());
+            for (uint32_t c = findNext(a); c < b; c = findNext(c)) {
+                cell[c] = r->isDraggable ? 1 : 0;
+                next[c] = c + 1;
+            }
+        }
+
+        const auto first = static_cast<uint32_t>(segments_.size());
+        for (uint32_t c = 0; c < cells; ++c) {
+            if (cell[c] != 1) continue;
+            if (segments_.size() > first && segments_.back().y1 == ys[c])
+                segments_.back().y1 = ys[c + 1];
+            else
+                segments_.push_back({ ys[c], ys[c + 1] });
+        }
+
+        // Coalesce with the previous slab when nothing changed across x0.
+        if (!slabX_.empty()) {
+            const uint32_t prev = slabFirst_.back();
+            if (first - prev == segments_.size() - first &&
+                std::equal(segments_.begin() + prev, segments_.begin() + first,
+                           segments_.begin() + first,
+                           [](Segment l, Segment r) { return l.y0 == r.y0 && l.y1 == r.y1; })) {
+                segments_.resize(first);
+                continue;
+            }
+        }
+        slabX_.push_back(x0);
+        slabFirst_.push_back(first);
+    }
+    slabX_.push_back(xs.back());
+    slabFirst_.push_back(static_cast<uint32_t>(segments_.size()));
+}
+
+bool DragRegionIndex::isDraggable(int x, int y) const {
+    if (slabX_.size() < 2) return false;
+    auto sx = std::ranges::upper_bound(slabX_, x);
+    if (sx == slabX_.begin() || sx == slabX_.end()) return false;
+    const size_t slab = static_cast<size_t>(sx - slabX_.begin()) - 1;
+
+    const auto begin = segments_.begin() + slabFirst_[slab];
+    const auto end   = segments_.begin() + slabFirst_[slab + 1];
+    auto seg = std::upper_bound(begin, end, y, [](int v, const Segment& s) { return v < s.y0; });
+    return seg != begin && y < std::prev(seg)->y1;
+}
+
+} // namespace bamboo
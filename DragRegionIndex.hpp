@@ -0,0 +1,48 @@
+#pragma once
+// bamboo/DragRegionIndex.hpp
+// Point-in-drag-region lookup for frameless windows on platforms where
+// Bamboo does the hit testing itself (Linux/GTK).
+
+#include "bamboo/WindowStyle.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bamboo {
+
+/**
+ * @brief Static spatial index over a list of DragRegions.
+ *
+ * Regions are resolved in order — a later region overrides an earlier one
+ * where they overlap, so `isDraggable = false` holes punch through the drag
+ * rects listed before them (the order CEF reports -webkit-app-region in).
+ *
+ * The plane is cut into vertical slabs at every region x-edge; each slab
+ * stores the sorted, merged y-intervals that end up draggable. A query is
+ * two binary searches: O(log n) regardless of how many regions overlap.
+ * Adjacent slabs with identical intervals are coalesced.
+ *
+ * Example:
+ *   DragRegionIndex idx(regions);
+ *   if (idx.isDraggable(x, y)) beginMoveDrag();
+ */
+class DragRegionIndex {
+public:
+    DragRegionIndex() = default;
+    explicit DragRegionIndex(std::span<const DragRegion> regions) { rebuild(regions); }
+
+    /** Replace the indexed regions. O(n²) worst case; called only when the page changes them. */
+    void rebuild(std::span<const DragRegion> regions);
+
+    [[nodiscard]] bool isDraggable(int x, int y) const;
+    [[nodiscard]] bool empty() const { return segments_.empty(); }
+
+private:
+    struct Segment { int y0, y1; };  // [y0, y1)
+
+    std::vector<int>      slabX_;      // slab i covers [slabX_[i], slabX_[i+1])
+    std::vector<uint32_t> slabFirst_;  // slab i's segments: [slabFirst_[i], slabFirst_[i+1])
+    std::vector<Segment>  segments_;
+};
+
+} // namespace bamboo
@@ -0,0 +1,210 @@
+// bamboo/FrameExport.cpp - see include/bamboo/FrameExport.hpp for API docs
+#include "bamboo/FrameExport.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace bamboo {
+
+using namespace frame_export;
+
+FrameExporter::FrameExporter(FrameExportConfig config) : config_(std::move(config)) {}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr uint64_t alignUp(uint64_t v, uint64_t a) { return (v + a - 1) / a * a; }
+
+} // namespace
+
+FrameExporter::~FrameExporter() {
+    for (int c : clients_) ::close(c);
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(config_.socketPath.c_str());
+    }
+    if (mapping_) ::munmap(mapping_, mappingSize_);
+    if (memFd_ >= 0) ::close(memFd_);
+}
+
+std::expected<std::unique_ptr<FrameExporter>, FrameExportError>
+FrameExporter::create(FrameExportConfig config) {
+    sockaddr_un addr{};
+    if (config.socketPath.empty() || config.socketPath.size() >= sizeof(addr.sun_path))
+        return std::unexpected(FrameExportError::SocketFailed);
+    config.slots = std::max(config.slots, 2);
+
+    auto self = std::unique_ptr<FrameExporter>(new FrameExporter(std::move(config)));
+    if (!self->allocateRing(self->config_.maxWidth, self->config_.maxHeight))
+        return std::unexpected(FrameExportError::MemoryFailed);
+
+    self->listenFd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (self->listenFd_ < 0) return std::unexpected(FrameExportError::SocketFailed);
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, self->config_.socketPath.c_str(), self->config_.socketPath.size());
+    ::unlink(addr.sun_path);  // stale socket from a previous run
+    if (::bind(self->listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(self->listenFd_, 8) != 0) {
+        ::close(self->listenFd_);
+        self->listenFd_ = -1;
+        return std::unexpected(FrameExportError::SocketFailed);
+    }
+    return self;
+}
+
+bool FrameExporter::allocateRing(int maxWidth, int maxHeight) {
+    const uint64_t headerSize = alignUp(sizeof(RingHeader), 64);
+    const uint64_t slotStride = alignUp(sizeof(SlotHeader) +
+        static_cast<uint64_t>(maxWidth) * static_cast<uint64_t>(maxHeight) * 4, 4096);
+    const size_t   size       = headerSize + slotStride * static_cast<uint64_t>(config_.slots);
+
+    // A fresh memfd every time: consumers keep their old mapping valid until
+    // they switch to the new one announced by the next Hello.
+    int fd = ::memfd_create("bamboo-frames", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) return false;
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) { ::close(fd); return false; }
+    // Consumers must never SIGBUS on a truncated mapping.
+    ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) { ::close(fd); return false; }
+
+    if (mapping_) ::munmap(mapping_, mappingSize_);
+    if (memFd_ >= 0) ::close(memFd_);
+    memFd_       = fd;
+    mapping_     = static_cast<uint8_t*>(map);
+    mappingSize_ = size;
+    slotStride_  = slotStride;
+    config_.maxWidth  = maxWidth;
+    config_.maxHeight = maxHeight;
+
+    auto* ring = new (mapping_) RingHeader{
+        kMagic, kVersion, static_cast<uint32_t>(config_.slots),
+        static_cast<uint32_t>(maxWidth), static_cast<uint32_t>(maxHeight), 0,
+        slotStride, headerSize,
+    };
+    for (uint32_t i = 0; i < ring->slotCount; ++i)
+        new (mapping_ + headerSize + i * slotStride) SlotHeader{};
+    return true;
+}
+
+bool FrameExporter::sendHello(int client) {
+    HelloMessage hello{ .mappingSize = mappingSize_ };
+    iovec iov{ &hello, sizeof(hello) };
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr* cmsg   = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &memFd_, sizeof(int));
+
+    return ::sendmsg(client, &msg, MSG_DONTWAIT | MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(hello));
+}
+
+bool FrameExporter::dropClient(int client) {
+    ::close(client);
+    ++stats_.consumersDropped;
+    return true;
+}
+
+void FrameExporter::acceptPending() {
+    for (;;) {
+        int c = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (c < 0) return;
+        if (sendHello(c)) clients_.push_back(c);
+        else              dropClient(c);
+    }
+}
+
+void FrameExporter::publish(const uint8_t* bgra, int width, int height, Rect dirty) {
+    if (!bgra || width <= 0 || height <= 0) return;
+    acceptPending();
+
+    if (width > config_.maxWidth || height > config_.maxHeight) {
+        if (!allocateRing(std::max(width, config_.maxWidth), std::max(height, config_.maxHeight)))
+            return;
+        ++stats_.reallocations;
+        // A consumer that misses this Hello would read the new ring's slot
+        // numbers against the old mapping. Waiting for it would block the UI
+        // thread, so it is disconnected instead; reconnecting gets a fresh Hello.
+        std::erase_if(clients_, [&](int c) { return !sendHello(c) && dropClient(c); });
+    }
+
+    const auto*    ring   = reinterpret_cast<const RingHeader*>(mapping_);
+    const uint64_t id     = nextFrameId_++;
+    const uint32_t slot   = static_cast<uint32_t>(id % ring->slotCount);
+    uint8_t*       base   = mapping_ + ring->headerSize + slot * slotStride_;
+    auto*          header = reinterpret_cast<SlotHeader*>(base);
+
+    const uint64_t seq = header->seq.load(std::memory_order_relaxed);
+    header->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    header->frameId     = id;
+    header->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    header->width  = static_cast<uint32_t>(width);
+    header->height = static_cast<uint32_t>(height);
+    header->stride = static_cast<uint32_t>(width) * 4;
+    header->format = PixelFormat::BGRA8Premultiplied;
+    // The one unavoidable copy: CEF owns its paint buffer.
+    std::memcpy(base + sizeof(SlotHeader), bgra, static_cast<size_t>(width) * height * 4);
+
+    header->seq.store(seq + 2, std::memory_order_release);
+    ++stats_.framesPublished;
+
+    FrameReadyMessage ready{
+        .slot = slot, .frameId = id, .seq = seq + 2,
+        .dirtyX = dirty.x, .dirtyY = dirty.y, .dirtyWidth = dirty.width, .dirtyHeight = dirty.height,
+    };
+    std::erase_if(clients_, [&](int c) {
+        if (::send(c, &ready, sizeof(ready), MSG_DONTWAIT | MSG_NOSIGNAL) >= 0) return false;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) { ++stats_.notificationsDropped; return false; }
+        return dropClient(c);
+    });
+}
+
+FrameExportStats FrameExporter::stats() const {
+    auto s = stats_;
+    s.consumers = clients_.size();
+    return s;
+}
+
+#else // !__linux__
+
+FrameExporter::~FrameExporter() = default;
+
+std::expected<std::unique_ptr<FrameExporter>, FrameExportError>
+FrameExporter::create(FrameExportConfig) {
+    return std::unexpected(FrameExportError::Unsupported);
+}
+
+bool FrameExporter::allocateRing(int, int) { return false; }
+void FrameExporter::acceptPending() {}
+bool FrameExporter::sendHello(int) { return false; }
+bool FrameExporter::dropClient(int) { return true; }
+void FrameExporter::publish(const uint8_t*, int, int, Rect) {}
+FrameExportStats FrameExporter::stats() const { return stats_; }
+
+#endif
+
+} // namespace bamboo
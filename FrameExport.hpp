@@ -0,0 +1,161 @@
+#pragma once
+// bamboo/FrameExport.hpp
+// Zero-copy hand-off of off-screen frames to other local processes (Linux).
+//
+// Frames are written into a ring of slots inside a sealed memfd. Consumers
+// connect to a Unix SOCK_SEQPACKET socket, receive the memfd once via
+// SCM_RIGHTS, map it read-only and then get one small FrameReady message per
+// frame. Pixels are never copied or encoded on the consumer side.
+//
+// This header is free of CEF includes so consumers can use the wire
+// protocol without linking Bamboo (see examples/frame_consumer.cpp).
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bamboo {
+
+namespace frame_export {
+
+inline constexpr uint32_t kMagic   = 0x46424D42;  // "BMBF"
+inline constexpr uint32_t kVersion = 1;
+
+enum class PixelFormat : uint32_t {
+    BGRA8Premultiplied = 0,  // CEF's native off-screen format
+};
+
+// ─── Shared memory layout ─────────────────────────────────────────────────────
+//
+//   [RingHeader][SlotHeader | pixels ...][SlotHeader | pixels ...] ...
+//
+// Each slot starts at headerSize + i * slotStride.
+
+struct RingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t maxWidth;
+    uint32_t maxHeight;
+    uint32_t reserved;
+    uint64_t slotStride;   // bytes per slot, including its SlotHeader
+    uint64_t headerSize;   // offset of slot 0
+};
+
+struct alignas(64) SlotHeader {
+    // Seqlock: odd while the producer is writing the slot. A consumer reads
+    // `seq`, copies/uses the pixels, and re-reads `seq`; if it changed or
+    // differs from the FrameReady message, the slot was overwritten.
+    std::atomic<uint64_t> seq;
+    uint64_t    frameId;
+    int64_t     timestampNs;  // steady_clock (CLOCK_MONOTONIC) at publish
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    stride;       // bytes per row
+    PixelFormat format;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "SlotHeader::seq must be address-free to live in shared memory");
+
+// ─── Socket messages (SOCK_SEQPACKET, one message per packet) ────────────────
+
+enum class MessageType : uint32_t {
+    Hello      = 1,  // carries the memfd; re-sent whenever the ring is reallocated
+    FrameReady = 2,
+};
+
+struct HelloMessage {
+    MessageType type = MessageType::Hello;
+    uint32_t    version = kVersion;
+    uint64_t    mappingSize;  // total memfd size to mmap
+};
+
+struct FrameReadyMessage {
+    MessageType type = MessageType::FrameReady;
+    uint32_t    slot;
+    uint64_t    frameId;
+    uint64_t    seq;          // expected (even) SlotHeader::seq
+    // Union of the dirty rects for this frame, in pixels.
+    int32_t     dirtyX, dirtyY, dirtyWidth, dirtyHeight;
+};
+
+} // namespace frame_export
+
+// ─── Producer ─────────────────────────────────────────────────────────────────
+
+enum class FrameExportError {
+    Unsupported,
+    SocketFailed,
+    MemoryFailed,
+};
+
+struct FrameExportConfig {
+    std::string socketPath;          // e.g. "/run/user/1000/bamboo-frames.sock"
+    int         slots     = 3;       // ring depth; >= 2
+    int         maxWidth  = 1920;    // initial capacity; grows on demand
+    int         maxHeight = 1080;
+};
+
+struct FrameExportStats {
+    uint64_t framesPublished     = 0;
+    uint64_t notificationsDropped = 0;  // consumer socket was full
+    uint64_t reallocations       = 0;
+    uint64_t consumersDropped    = 0;  // a Hello could not be delivered
+    size_t   consumers           = 0;
+};
+
+/**
+ * @brief Publishes BGRA frames into a memfd ring and notifies local consumers.
+ *
+ * Not thread-safe: call publish() from the thread that delivers frames
+ * (the CEF UI thread for Browser::onPaint). Never blocks — a consumer that
+ * stops reading simply misses notifications, and one whose socket is too
+ * full to take a Hello is disconnected.
+ */
+class FrameExporter {
+public:
+    ~FrameExporter();
+
+    FrameExporter(const FrameExporter&)            = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+
+    [[nodiscard]]
+    static std::expected<std::unique_ptr<FrameExporter>, FrameExportError>
+    create(FrameExportConfig config);
+
+    struct Rect { int x, y, width, height; };
+
+    /** Copy one frame into the next ring slot and notify every consumer. */
+    void publish(const uint8_t* bgra, int width, int height, Rect dirty);
+
+    /**
+     * Accept waiting consumers and send them the Hello. publish() does this
+     * too; call it periodically so a consumer is greeted while the page is idle.
+     */
+    void acceptPending();
+
+    [[nodiscard]] FrameExportStats stats() const;
+
+private:
+    explicit FrameExporter(FrameExportConfig config);
+    bool allocateRing(int maxWidth, int maxHeight);
+    bool sendHello(int client);   // false if the whole message was not sent
+    bool dropClient(int client);  // closes it; always true, for erase_if
+
+    FrameExportConfig config_;
+    int               listenFd_ = -1;
+    int               memFd_    = -1;
+    uint8_t*          mapping_  = nullptr;
+    size_t            mappingSize_ = 0;
+    uint64_t          slotStride_  = 0;
+    uint64_t          nextFrameId_ = 0;
+    std::vector<int>  clients_;
+    FrameExportStats  stats_;
+};
+
+} // namespace bamboo
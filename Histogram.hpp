@@ -0,0 +1,91 @@
+#pragma once
+// bamboo/Histogram.hpp
+// Fixed-size log-linear latency histogram (HDR-style), cheap enough to leave
+// recording in production paths.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace bamboo {
+
+/**
+ * @brief Histogram of non-negative integer samples (Bamboo uses microseconds).
+ *
+ * Values below 16 get an exact bucket; above that every power of two is split
+ * into 16 linear sub-buckets, so any reported value is within 1/16 (≈6%) of
+ * the true one across the whole 64-bit range. record() is a bit_width, a shift
+ * and an increment — no allocation, no branches on the data beyond that.
+ *
+ * Not thread-safe: each histogram belongs to one thread (usually the UI thread).
+ * Combine them with merge().
+ */
+class Histogram {
+public:
+    static constexpr int kSubBits    = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kBuckets    = kSubBuckets + (64 - kSubBits) * kSubBuckets;
+
+    void record(uint64_t value) {
+        ++counts_[indexOf(value)];
+        ++count_;
+        sum_ += value;
+        min_  = std::min(min_, value);
+        max_  = std::max(max_, value);
+    }
+
+    void merge(const Histogram& other) {
+        for (int i = 0; i < kBuckets; ++i) counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_   += other.sum_;
+        min_    = std::min(min_, other.min_);
+        max_    = std::max(max_, other.max_);
+    }
+
+    void reset() { *this = Histogram{}; }
+
+    [[nodiscard]] uint64_t count() const { return count_; }
+    [[nodiscard]] uint64_t min()   const { return count_ ? min_ : 0; }
+    [[nodiscard]] uint64_t max()   const { return max_; }
+    [[nodiscard]] double   mean()  const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    /** Smallest recorded-bucket value v such that a fraction `q` of samples are ≤ v. */
+    [[nodiscard]] uint64_t percentile(double q) const {
+        if (count_ == 0) return 0;
+        const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(
+            std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_))));
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= target) return std::clamp(upperBound(i), min(), max_);
+        }
+        return max_;
+    }
+
+private:
+    static int indexOf(uint64_t v) {
+        if (v < kSubBuckets) return static_cast<int>(v);
+        const int msb   = std::bit_width(v) - 1;      // ≥ kSubBits
+        const int shift = msb - kSubBits;
+        return kSubBuckets + shift * kSubBuckets + static_cast<int>((v >> shift) - kSubBuckets);
+    }
+
+    static uint64_t upperBound(int index) {
+        if (index < kSubBuckets) return static_cast<uint64_t>(index);
+        const int shift = (index - kSubBuckets) / kSubBuckets;
+        const int sub   = (index - kSubBuckets) % kSubBuckets;
+        const uint64_t lower = static_cast<uint64_t>(kSubBuckets + sub) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+    std::array<uint64_t, kBuckets> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_   = 0;
+    uint64_t min_   = std::numeric_limits<uint64_t>::max();
+    uint64_t max_   = 0;
+};
+
+} // namespace bamboo
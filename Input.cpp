@@ -0,0 +1,469 @@
+// bamboo/Input.cpp - see include/bamboo/Input.hpp for API docs
+#include "bamboo/Input.hpp"
+#include "bamboo/Browser.hpp"
+#include "bamboo/DevTools.hpp"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+
+namespace bamboo {
+
+using json = nlohmann::json;
+
+namespace {
+
+// ─── JSON ─────────────────────────────────────────────────────────────────────
+// The same field names the recorder script sends.
+
+constexpr std::pair<InputType, std::string_view> kTypeNames[] = {
+    { InputType::MouseMove, "mousemove" }, { InputType::MouseDown, "mousedown" },
+    { InputType::MouseUp,   "mouseup" },   { InputType::Wheel,     "wheel" },
+    { InputType::KeyDown,   "keydown" },   { InputType::KeyUp,     "keyup" },
+    { InputType::Char,      "char" },
+};
+
+std::string_view typeName(InputType t) {
+    for (const auto& [type, name] : kTypeNames) if (type == t) return name;
+    return "";
+}
+
+double epochMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool isMouse(InputType t) {
+    return t == InputType::MouseMove || t == InputType::MouseDown || t == InputType::MouseUp;
+}
+
+json toJson(const InputEvent& e) {
+    json j = { {"type", typeName(e.type)}, {"t", e.atMs} };
+    if (isMouse(e.type) || e.type == InputType::Wheel) { j["x"] = e.x; j["y"] = e.y; }
+    if (e.type == InputType::MouseDown || e.type == InputType::MouseUp) {
+        j["b"] = static_cast<int>(e.button);
+        j["c"] = e.clickCount;
+    }
+    if (e.type == InputType::Wheel)   { j["dx"] = e.deltaX; j["dy"] = e.deltaY; }
+    if (e.type == InputType::KeyDown || e.type == InputType::KeyUp) j["k"] = e.keyCode;
+    if (e.type == InputType::Char)    j["ch"] = static_cast<int>(e.character);
+    if (e.modifiers) j["m"] = e.modifiers;
+    return j;
+}
+
+std::optional<InputEvent> fromJson(const json& j) {
+    if (!j.is_object()) return std::nullopt;
+    const auto name = j.value("type", std::string{});
+    auto it = std::ranges::find(kTypeNames, std::string_view(name),
+                                &std::pair<InputType, std::string_view>::second);
+    if (it == std::end(kTypeNames)) return std::nullopt;
+    InputEvent e{ .type = it->first };
+    e.atMs       = j.value("t", 0.0);
+    e.x          = j.value("x", 0);
+    e.y          = j.value("y", 0);
+    e.button     = static_cast<MouseButton>(std::clamp(j.value("b", 0), 0, 2));
+    e.clickCount = std::max(1, j.value("c", 1));
+    e.deltaX     = j.value("dx", 0);
+    e.deltaY     = j.value("dy", 0);
+    e.keyCode    = j.value("k", 0);
+    e.character  = static_cast<char16_t>(j.value("ch", 0));
+    e.modifiers  = j.value("m", 0u);
+    return e;
+}
+
+// ─── CEF events ───────────────────────────────────────────────────────────────
+
+uint32_t eventFlags(uint32_t modifiers) {
+    uint32_t f = 0;
+    if (modifiers & kShift)   f |= EVENTFLAG_SHIFT_DOWN;
+    if (modifiers & kControl) f |= EVENTFLAG_CONTROL_DOWN;
+    if (modifiers & kAlt)     f |= EVENTFLAG_ALT_DOWN;
+    if (modifiers & kMeta)    f |= EVENTFLAG_COMMAND_DOWN;
+    return f;
+}
+
+cef_mouse_button_type_t cefButton(MouseButton b) {
+    switch (b) {
+        case MouseButton::Middle: return MBT_MIDDLE;
+        case MouseButton::Right:  return MBT_RIGHT;
+        default:                  return MBT_LEFT;
+    }
+}
+
+uint32_t buttonFlag(MouseButton b) {
+    switch (b) {
+        case MouseButton::Middle: return EVENTFLAG_MIDDLE_MOUSE_BUTTON;
+        case MouseButton::Right:  return EVENTFLAG_RIGHT_MOUSE_BUTTON;
+        default:                  return EVENTFLAG_LEFT_MOUSE_BUTTON;
+    }
+}
+
+// `held`: buttons down before this event, so moves in between are drags.
+void send(const CefRefPtr<CefBrowserHost>& host, const InputEvent& e, uint32_t& held) {
+    CefMouseEvent m;
+    m.x = e.x;
+    m.y = e.y;
+    m.modifiers = eventFlags(e.modifiers) | held;
+
+    CefKeyEvent k;
+    k.modifiers = eventFlags(e.modifiers);
+    k.windows_key_code = e.keyCode;
+
+    switch (e.type) {
+        case InputType::MouseMove:
+            host->SendMouseMoveEvent(m, false);
+            break;
+        case InputType::MouseDown:
+            held |= buttonFlag(e.button);
+            m.modifiers |= buttonFlag(e.button);
+            host->SendMouseClickEvent(m, cefButton(e.button), false, e.clickCount);
+            break;
+        case InputType::MouseUp:
+            held &= ~buttonFlag(e.button);
+            host->SendMouseClickEvent(m, cefButton(e.button), true, e.clickCount);
+            break;
+        case InputType::Wheel:
+            // CEF deltas are in the wheel's sense: negative scrolls down.
+            host->SendMouseWheelEvent(m, -e.deltaX, -e.deltaY);
+            break;
+        case InputType::KeyDown:
+            k.type = KEYEVENT_RAWKEYDOWN;
+            host->SendKeyEvent(k);
+            break;
+        case InputType::KeyUp:
+            k.type = KEYEVENT_KEYUP;
+            host->SendKeyEvent(k);
+            break;
+        case InputType::Char:
+            k.type = KEYEVENT_CHAR;
+            k.windows_key_code     = e.character;
+            k.character            = e.character;
+            k.unmodified_character = e.character;
+            host->SendKeyEvent(k);
+            break;
+    }
+}
+
+// Resolves once the page has rendered (two rAFs) or has gone idle.
+constexpr std::string_view kWaitFrame =
+    "new Promise(r=>requestAnimationFrame(()=>requestAnimationFrame(()=>r(0))))";
+constexpr std::string_view kWaitIdle =
+    "new Promise(r=>requestIdleCallback(()=>r(0)))";
+
+// ─── Recorder ─────────────────────────────────────────────────────────────────
+// Capture-phase, passive listeners on window see every trusted event before
+// the page can stop it. Times are epoch ms (performance.timeOrigin-based) so
+// the recording continues across navigations; Browser makes them relative.
+
+constexpr std::string_view kRecorder = R"js(
+(() => {
+  if (window.__bambooInputRec) return;
+  const buf = [];
+  const now = () => performance.timeOrigin + performance.now();
+  const mods = e => (e.shiftKey ? 1 : 0) | (e.ctrlKey ? 2 : 0) | (e.altKey ? 4 : 0) | (e.metaKey ? 8 : 0);
+  const add = o => { o.t = now(); buf.push(o); };
+  const mouse = type => e => add({ type, x: e.clientX, y: e.clientY, b: e.button, c: e.detail || 1, m: mods(e) });
+  const on = {
+    mousemove: e => add({ type: 'mousemove', x: e.clientX, y: e.clientY, m: mods(e) }),
+    mousedown: mouse('mousedown'),
+    mouseup:   mouse('mouseup'),
+    wheel: e => {
+      const k = e.deltaMode === 1 ? 40 : e.deltaMode === 2 ? innerHeight : 1;
+      add({ type: 'wheel', x: e.clientX, y: e.clientY,
+            dx: Math.round(e.deltaX * k), dy: Math.round(e.deltaY * k), m: mods(e) });
+    },
+    keydown: e => {
+      add({ type: 'keydown', k: e.keyCode, m: mods(e) });
+      // The text a key produces; replay sends it as a separate char event.
+      if (e.ctrlKey || e.metaKey) return;
+      if (e.key.length === 1) add({ type: 'char', ch: e.key.charCodeAt(0), m: mods(e) });
+      else if (e.key === 'Enter') add({ type: 'char', ch: 13, m: mods(e) });
+    },
+    keyup: e => add({ type: 'keyup', k: e.keyCode, m: mods(e) }),
+  };
+  const opts = { capture: true, passive: true };
+  const handlers = Object.entries(on).map(([type, f]) => {
+    const h = e => { if (e.isTrusted) f(e); };
+    addEventListener(type, h, opts);
+    return [type, h];
+  });
+  const flush = () => {
+    if (buf.length) window.bamboo.send('__inputRecord', { events: buf.splice(0), done: false });
+  };
+  const timer = setInterval(flush, 250);
+  addEventListener('pagehide', flush);
+  window.__bambooInputRec = {
+    // The final batch is the return value; Browser reads it over DevTools.
+    stop() {
+      clearInterval(timer);
+      removeEventListener('pagehide', flush);
+      for (const [type, h] of handlers) removeEventListener(type, h, opts);
+      delete window.__bambooInputRec;
+      return { events: buf.splice(0), done: true };
+    },
+  };
+})();
+)js";
+
+// An expression: evaluates to the final batch.
+constexpr std::string_view kStopRecorder =
+    "window.__bambooInputRec ? window.__bambooInputRec.stop() : { events: [], done: true }";
+
+} // namespace
+
+// ─── InputSequence ────────────────────────────────────────────────────────────
+
+namespace {
+
+double nextAt(const InputSequence& s, std::chrono::milliseconds gap) {
+    return s.durationMs() + static_cast<double>(gap.count());
+}
+
+} // namespace
+
+InputSequence& InputSequence::move(int x, int y, ms gap) {
+    events.push_back({ .type = InputType::MouseMove, .atMs = nextAt(*this, gap), .x = x, .y = y });
+    return *this;
+}
+
+InputSequence& InputSequence::click(int x, int y, MouseButton button, ms gap) {
+    move(x, y, gap);
+    const double at = durationMs();
+    events.push_back({ .type = InputType::MouseDown, .atMs = at,      .x = x, .y = y, .button = button });
+    events.push_back({ .type = InputType::MouseUp,   .atMs = at + 50, .x = x, .y = y, .button = button });
+    return *this;
+}
+
+InputSequence& InputSequence::scroll(int x, int y, int deltaY, int steps, ms gap) {
+    steps = std::max(1, steps);
+    for (int i = 0; i < steps; ++i) {
+        // Spread the remainder so the steps add up to exactly deltaY.
+        const int d = deltaY * (i + 1) / steps - deltaY * i / steps;
+        events.push_back({ .type = InputType::Wheel, .atMs = nextAt(*this, gap),
+                           .x = x, .y = y, .deltaY = d });
+    }
+    return *this;
+}
+
+InputSequence& InputSequence::key(int keyCode, uint32_t modifiers, ms gap) {
+    const double at = nextAt(*this, gap);
+    events.push_back({ .type = InputType::KeyDown, .atMs = at,      .keyCode = keyCode, .modifiers = modifiers });
+    events.push_back({ .type = InputType::KeyUp,   .atMs = at + 10, .keyCode = keyCode, .modifiers = modifiers });
+    return *this;
+}
+
+InputSequence& InputSequence::type(std::string_view text, ms gap) {
+    for (size_t i = 0; i < text.size();) {
+        // UTF-8 → code point; invalid bytes become U+FFFD.
+        const auto c = static_cast<unsigned char>(text[i]);
+        const int len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        char32_t cp = 0xFFFD;
+        if (len && i + len <= text.size()) {
+            cp = len == 1 ? c : c & (0x7F >> len);
+            for (int b = 1; b < len; ++b) cp = (cp << 6) | (static_cast<unsigned char>(text[i + b]) & 0x3F);
+            i += len;
+        } else {
+            ++i;
+        }
+
+        // Letters, digits, space and Enter have virtual key codes equal to
+        // their (upper-case) ASCII; anything else is typed as text only.
+        int vk = 0;
+        uint32_t mods = 0;
+        if (cp == '\n') { vk = 0x0D; cp = '\r'; }
+        else if (cp == ' ' || (cp < 0x80 && std::isalnum(static_cast<int>(cp)))) {
+            vk = std::toupper(static_cast<int>(cp));
+            if (cp >= 'A' && cp <= 'Z') mods = kShift;
+        }
+
+        const double at = nextAt(*this, gap);
+        if (vk) events.push_back({ .type = InputType::KeyDown, .atMs = at, .keyCode = vk, .modifiers = mods });
+        auto chars = [&](char16_t ch) {
+            events.push_back({ .type = InputType::Char, .atMs = at, .character = ch, .modifiers = mods });
+        };
+        if (cp >= 0x10000) {
+            chars(static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10)));
+            chars(static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+        } else {
+            chars(static_cast<char16_t>(cp));
+        }
+        if (vk) events.push_back({ .type = InputType::KeyUp, .atMs = at + 10, .keyCode = vk, .modifiers = mods });
+    }
+    return *this;
+}
+
+InputSequence& InputSequence::wait(ms duration) {
+    endMs = durationMs() + static_cast<double>(duration.count());
+    return *this;
+}
+
+std::string InputSequence::toJson() const {
+    json arr = json::array();
+    for (const auto& e : events) arr.push_back(bamboo::toJson(e));
+    return json{ {"duration", durationMs()}, {"events", std::move(arr)} }.dump();
+}
+
+std::expected<InputSequence, InputError> InputSequence::fromJson(std::string_view text) {
+    auto j = json::parse(text, nullptr, false);
+    if (!j.is_object() || !j.contains("events") || !j["events"].is_array())
+        return std::unexpected(InputError::BadFormat);
+    InputSequence seq;
+    seq.events.reserve(j["events"].size());
+    for (const auto& item : j["events"]) {
+        auto e = bamboo::fromJson(item);
+        if (!e) return std::unexpected(InputError::BadFormat);
+        seq.events.push_back(*e);
+    }
+    std::ranges::stable_sort(seq.events, {}, &InputEvent::atMs);
+    seq.endMs = j.value("duration", 0.0);
+    return seq;
+}
+
+// ─── InputPlayer ──────────────────────────────────────────────────────────────
+
+InputPlayer::InputPlayer(std::weak_ptr<Browser> browser, InputSequence sequence,
+                         InputReplayOptions options, DoneCallback done)
+    : browser_(std::move(browser)), sequence_(std::move(sequence)),
+      options_(options), done_(std::move(done)) {}
+
+std::shared_ptr<InputPlayer> InputPlayer::start(const std::shared_ptr<Browser>& browser,
+                                                InputSequence sequence,
+                                                InputReplayOptions options, DoneCallback done) {
+    auto player = std::shared_ptr<InputPlayer>(
+        new InputPlayer(browser, std::move(sequence), options, std::move(done)));
+    if (!browser->cefBrowser()) {
+        player->finish(std::unexpected(InputError::NoBrowser));
+        return player;
+    }
+    // Off-screen browsers only route key events to a focused view.
+    browser->cefBrowser()->GetHost()->SetFocus(true);
+    player->start_ = std::chrono::steady_clock::now();
+    player->schedule();
+    return player;
+}
+
+void InputPlayer::cancel() {
+    if (running_) finish(std::unexpected(InputError::Cancelled));
+}
+
+void InputPlayer::schedule() {
+    if (!running_) return;
+    const bool last = next_ == sequence_.events.size();
+    if (last && (options_.speed <= 0 || std::chrono::steady_clock::now() >= dueAt(sequence_.durationMs())))
+        return finish(result_);
+
+    int64_t delayMs = 0;
+    if (options_.speed > 0) {
+        const auto due = dueAt(last ? sequence_.durationMs() : sequence_.events[next_].atMs);
+        delayMs = std::chrono::ceil<std::chrono::milliseconds>(
+            due - std::chrono::steady_clock::now()).count();
+    }
+    // Always a task, never a direct call: long sequences must not recurse.
+    // Past the last event this is the trailing wait; sendNext then finishes.
+    auto task = CefCreateClosureTask([weak = weak_from_this()] {
+        if (auto self = weak.lock()) self->sendNext();
+    });
+    if (delayMs > 0) CefPostDelayedTask(TID_UI, task, delayMs);
+    else             CefPostTask(TID_UI, task);
+}
+
+std::chrono::steady_clock::time_point InputPlayer::dueAt(double atMs) const {
+    return start_ + std::chrono::microseconds(static_cast<int64_t>(atMs * 1000.0 / options_.speed));
+}
+
+void InputPlayer::sendNext() {
+    if (!running_) return;
+    if (next_ == sequence_.events.size()) return finish(result_);
+    auto browser = browser_.lock();
+    if (!browser || !browser->cefBrowser()) return finish(std::unexpected(InputError::NoBrowser));
+
+    InputEvent e = sequence_.events[next_++];
+    if (e.type != InputType::KeyDown && e.type != InputType::KeyUp && e.type != InputType::Char) {
+        // Sequences are in CSS pixels; CEF takes view coordinates.
+        const float zoom = browser->zoom();
+        e.x = static_cast<int>(static_cast<float>(e.x) * zoom);
+        e.y = static_cast<int>(static_cast<float>(e.y) * zoom);
+    }
+    send(browser->cefBrowser()->GetHost(), e, heldButtons_);
+    if (isMouse(e.type) || e.type == InputType::Wheel) lastMouse_ = e;
+    ++result_.events;
+
+    if (options_.waitAfterEach == InputWait::None) return schedule();
+
+    const uint64_t token = ++token_;
+    sentAt_ = std::chrono::steady_clock::now();
+    // The promise is awaited through DevTools; without a client only the
+    // timeout below ends the wait.
+    if (auto dt = browser->devTools()) {
+        cdp::Runtime::evaluate wait{
+            .expression   = std::string(options_.waitAfterEach == InputWait::Idle ? kWaitIdle : kWaitFrame),
+            .awaitPromise = true,
+        };
+        (*dt)->send(wait, [weak = weak_from_this(), token](std::expected<cdp::Runtime::evaluate::Result, CdpError> r) {
+            if (auto self = weak.lock()) self->waited(token, !r);
+        });
+    }
+    CefPostDelayedTask(TID_UI, CefCreateClosureTask([weak = weak_from_this(), token] {
+        if (auto self = weak.lock()) self->waited(token, true);
+    }), options_.waitTimeout.count());
+}
+
+void InputPlayer::waited(uint64_t token, bool timedOut) {
+    if (!running_ || token != token_) return;   // the other half of the race already won
+    ++token_;
+    if (timedOut) {
+        ++result_.timeouts;
+    } else {
+        result_.stepLatencyUs.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - sentAt_).count()));
+    }
+    schedule();
+}
+
+void InputPlayer::finish(std::expected<InputReplayResult, InputError> result) {
+    running_ = false;
+    ++token_;
+    // Let go of anything still held so the page is not left mid-drag.
+    if (auto browser = browser_.lock(); browser && browser->cefBrowser() && heldButtons_) {
+        InputEvent up = lastMouse_;
+        up.type = InputType::MouseUp;
+        for (auto b : { MouseButton::Left, MouseButton::Middle, MouseButton::Right }) {
+            up.button = b;
+            if (heldButtons_ & buttonFlag(b)) send(browser->cefBrowser()->GetHost(), up, heldButtons_);
+        }
+    }
+    if (result) {
+        result->elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_);
+    }
+    if (auto done = std::move(done_)) done(std::move(result));
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+
+namespace input {
+
+std::string_view recorderScript()     { return kRecorder; }
+std::string_view stopRecorderScript() { return kStopRecorder; }
+
+bool appendRecorded(InputSequence& seq, std::string_view batch, double originMs) {
+    auto j = json::parse(batch, nullptr, false);
+    if (!j.is_object()) return false;
+    if (auto it = j.find("events"); it != j.end() && it->is_array()) {
+        for (const auto& item : *it) {
+            auto e = fromJson(item);
+            if (!e) continue;
+            e->atMs = std::max(0.0, e->atMs - originMs);
+            seq.events.push_back(*e);
+        }
+    }
+    const bool done = j.value("done", false);
+    if (done) seq.endMs = std::max(seq.durationMs(), epochMs() - originMs);
+    return done;
+}
+
+} // namespace input
+
+} // namespace bamboo
@@ -0,0 +1,167 @@
+#pragma once
+// bamboo/Input.hpp
+// Input sequences — mouse, wheel, keyboard — recorded from a page or built
+// in code, saved as JSON, and replayed into a browser through
+// CefBrowserHost::Send*Event for reproducible performance scenarios.
+
+#include "bamboo/Histogram.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bamboo {
+
+class Browser;
+
+// ─── Events ───────────────────────────────────────────────────────────────────
+
+enum class InputType { MouseMove, MouseDown, MouseUp, Wheel, KeyDown, KeyUp, Char };
+enum class MouseButton { Left, Middle, Right };
+
+/** InputEvent::modifiers bits (DOM order). */
+enum InputModifier : uint32_t {
+    kShift   = 1u << 0,
+    kControl = 1u << 1,
+    kAlt     = 1u << 2,
+    kMeta    = 1u << 3,
+};
+
+struct InputEvent {
+    InputType   type;
+    double      atMs       = 0;     // since the start of the sequence
+    int         x          = 0;     // CSS px in the viewport (clientX/Y): mouse and wheel
+    int         y          = 0;
+    MouseButton button     = MouseButton::Left;
+    int         clickCount = 1;
+    int         deltaX     = 0;     // wheel, px; positive = scroll right / down (DOM sense)
+    int         deltaY     = 0;
+    int         keyCode    = 0;     // Windows virtual key code (DOM keyCode)
+    char16_t    character  = 0;     // Char
+    uint32_t    modifiers  = 0;     // InputModifier bits
+};
+
+enum class InputError {
+    NoBrowser,      // no CEF browser, or it closed during replay
+    Busy,           // a replay is already running on the window
+    Cancelled,
+    BadFormat,      // InputSequence::fromJson
+};
+
+/**
+ * @brief An ordered input script. Build one in code, or get one from
+ *        Browser::stopInputRecording().
+ *
+ * The builders append after the last event, `gap` later:
+ *   auto seq = bamboo::InputSequence{}
+ *       .click(200, 140)
+ *       .type("hello world")
+ *       .scroll(400, 300, 3000, 30)     // 3000 px down in 30 wheel events
+ *       .wait(std::chrono::milliseconds(500));
+ */
+struct InputSequence {
+    using ms = std::chrono::milliseconds;
+
+    std::vector<InputEvent> events;
+    double                  endMs = 0;   // trailing wait() after the last event
+
+    InputSequence& move(int x, int y, ms gap = ms(16));
+    InputSequence& click(int x, int y, MouseButton button = MouseButton::Left, ms gap = ms(50));
+    InputSequence& scroll(int x, int y, int deltaY, int steps = 10, ms gap = ms(16));
+    /** Key down + up; add InputModifier bits for chords. */
+    InputSequence& key(int keyCode, uint32_t modifiers = 0, ms gap = ms(30));
+    /** UTF-8 text as key down / char / key up per character. */
+    InputSequence& type(std::string_view text, ms gap = ms(30));
+    InputSequence& wait(ms duration);
+
+    [[nodiscard]] double durationMs() const {
+        return std::max(endMs, events.empty() ? 0.0 : events.back().atMs);
+    }
+
+    /** {"duration":…,"events":[{"type":"mousedown","t":12.5,"x":…,"y":…,"b":0,"c":1}, …]} */
+    [[nodiscard]] std::string toJson() const;
+    [[nodiscard]] static std::expected<InputSequence, InputError> fromJson(std::string_view json);
+};
+
+// ─── Replay ───────────────────────────────────────────────────────────────────
+
+enum class InputWait {
+    None,
+    Frame,      // two requestAnimationFrame ticks: the input has been rendered
+    Idle,       // requestIdleCallback: the page has nothing left to do
+};
+
+struct InputReplayOptions {
+    double                    speed   = 1.0;   // 0 = no pauses beyond the waits
+    InputWait                 waitAfterEach = InputWait::Frame;
+    std::chrono::milliseconds waitTimeout{1000};
+};
+
+struct InputReplayResult {
+    size_t                    events   = 0;
+    std::chrono::milliseconds elapsed{0};
+    Histogram                 stepLatencyUs;   // event sent → frame / idle, per event
+    size_t                    timeouts = 0;    // waits that gave up after waitTimeout
+};
+
+/**
+ * @brief Drives one replay; owned by the Browser (see Browser::replayInput).
+ *
+ * Each event is sent when it is due (atMs / speed after the start) and not
+ * before the wait after the previous one has finished. UI thread only.
+ */
+class InputPlayer : public std::enable_shared_from_this<InputPlayer> {
+public:
+    using DoneCallback = std::function<void(std::expected<InputReplayResult, InputError>)>;
+
+    static std::shared_ptr<InputPlayer> start(const std::shared_ptr<Browser>& browser,
+                                              InputSequence sequence,
+                                              InputReplayOptions options, DoneCallback done);
+
+    void cancel();
+    [[nodiscard]] bool running() const { return running_; }
+
+private:
+    InputPlayer(std::weak_ptr<Browser> browser, InputSequence sequence,
+                InputReplayOptions options, DoneCallback done);
+    void schedule();
+    void sendNext();
+    void waited(uint64_t token, bool timedOut);
+    [[nodiscard]] std::chrono::steady_clock::time_point dueAt(double atMs) const;
+    void finish(std::expected<InputReplayResult, InputError> result);
+
+    std::weak_ptr<Browser>                browser_;
+    InputSequence                         sequence_;
+    InputReplayOptions                    options_;
+    DoneCallback                          done_;
+    InputReplayResult                     result_;
+    size_t                                next_ = 0;
+    uint32_t                              heldButtons_ = 0;   // EVENTFLAG_*_MOUSE_BUTTON
+    InputEvent                            lastMouse_{ .type = InputType::MouseMove };
+    uint64_t                              token_ = 0;         // current wait
+    std::chrono::steady_clock::time_point start_, sentAt_;
+    bool                                  running_ = true;
+};
+
+// ─── Recording (internals) ────────────────────────────────────────────────────
+
+namespace input {
+
+/** Page script that records trusted DOM input and sends it as '__inputRecord'. */
+[[nodiscard]] std::string_view recorderScript();
+/** Expression that stops the recorder and evaluates to the final batch (done:true). */
+[[nodiscard]] std::string_view stopRecorderScript();
+/**
+ * Appends one '__inputRecord' batch, times made relative to `originMs`
+ * (epoch ms at recording start). True for the final batch.
+ */
+bool appendRecorded(InputSequence& seq, std::string_view batch, double originMs);
+
+} // namespace input
+
+} // namespace bamboo
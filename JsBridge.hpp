@@ -3,10 +3,19 @@
 // Injects the window.bamboo JavaScript API into every Chromium frame.
 // Provides: send/on messaging, call/bind RPC, style control, and utility helpers.
 
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include "include/cef_render_process_handler.h"
+#include "include/cef_process_message.h"
 #include "include/cef_v8.h"
 
+#if defined(_WIN32)
+  #include <process.h>
+#else
+  #include <unistd.h>
+#endif
+
 namespace bamboo {
 
 /**
@@ -24,6 +33,7 @@ namespace bamboo {
  *
  *   // Window/style control
  *   window.bamboo.setStyle({ transparent: true, cornerRadius: 16 })
+ *   window.bamboo.animateStyle({ cornerRadius: 16 }, 250, 'ease-out')
  *   window.bamboo.setDragRegions([{ x, y, width, height }])
  *   window.bamboo.minimize()
  *   window.bamboo.maximize()
@@ -38,6 +48,7 @@ namespace bamboo {
  *   window.bamboo.openDevTools()
  *   window.bamboo.print()
  *   window.bamboo.captureScreenshot()     // returns Promise<string> (base64 PNG)
+ *   window.bamboo.stats()                 // returns Promise<object> (bridge counters)
  *   window.bamboo.version                 // "1.0.0"
  *   window.bamboo.platform                // "windows" | "macos" | "linux"
  */
@@ -48,17 +59,24 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
 
   const _listeners = new Map();
   const _pending   = new Map();
+  const _rtt       = [];   // call() round trips (ms) not yet reported to C++
+
+  // ── Internal transport ───────────────────────────────────────────────────
+  // __bambooPost is native (BambooJsBridge, installed just before this
+  // script) and sends the request to the browser process as kBridgeMessage.
+  // One-way: replies come back as script (_dispatch, _resolveCall), and
+  // only to the main frame, which is the only one given __bambooPost.
 
-  // ── Internal cefQuery wrapper ─────────────────────────────────────────────
+  const _post = window.__bambooPost;
 
   function _query(payload) {
-    return new Promise((resolve, reject) => {
-      window.cefQuery({
-        request:   JSON.stringify(payload),
-        onSuccess: resolve,
-        onFailure: (_code, msg) => reject(new Error(msg)),
-      });
-    });
+    if (!_post) return Promise.reject(new Error('window.bamboo is only available in the top frame'));
+    try {
+      _post(JSON.stringify(payload));
+      return Promise.resolve();
+    } catch (e) {
+      return Promise.reject(e);
+    }
   }
 
   // ── Internal: resolve a pending call (called by C++) ──────────────────────
@@ -67,10 +85,25 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
     const p = _pending.get(id);
     if (!p) return;
     _pending.delete(id);
+    if (_rtt.length < 64) _rtt.push(performance.now() - p.start);
     if (error) p.reject(new Error(error));
     else       p.resolve(value);
   }
 
+  // ── Style-derived CSS (called by the renderer handler) ────────────────────
+  // Attached at document start through adoptedStyleSheets, so there is no
+  // <style> element to insert and nothing renders before it applies.
+
+  let _sheet = null;
+
+  function _setCSS(css) {
+    if (!css && !_sheet) return;
+    if (!_sheet) _sheet = new CSSStyleSheet();
+    _sheet.replaceSync(css);
+    if (!document.adoptedStyleSheets.includes(_sheet))
+      document.adoptedStyleSheets = [...document.adoptedStyleSheets, _sheet];
+  }
+
   // ── Platform detection ───────────────────────────────────────────────────
 
   const _platform = (() => {
@@ -80,6 +113,84 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
     return 'linux';
   })();
 
+  // ── Jank monitoring ──────────────────────────────────────────────────────
+  // Long tasks, long animation frames and layout shifts are folded into one
+  // summary per window of activity and sent as '__jank' (→ Browser::onJank).
+  // Top-level document only; quiet pages send nothing.
+
+  const _JANK_FLUSH_MS = 5000;
+
+  function _jankStats() {
+    return { count: 0, totalMs: 0, maxMs: 0, blockingMs: 0 };
+  }
+
+  let _jank = null;
+  let _jankSince = performance.now();
+  let _cls = 0, _clsSession = 0, _clsFirst = 0, _clsLast = 0;
+
+  function _jankBucket() {
+    if (!_jank) _jank = { longTasks: _jankStats(), longFrames: _jankStats(),
+                          worstScript: '', layoutShifts: 0, layoutShiftScore: 0 };
+    return _jank;
+  }
+
+  function _addJank(stats, duration, blocking) {
+    stats.count++;
+    stats.totalMs += duration;
+    stats.blockingMs += blocking;
+    if (duration > stats.maxMs) { stats.maxMs = duration; return true; }
+    return false;
+  }
+
+  function _flushJank() {
+    const now = performance.now();
+    if (_jank) {
+      _query({ type: 'message', event: '__jank', data: {
+        ..._jank, url: location.href, intervalMs: now - _jankSince, cls: _cls,
+      } }).catch(() => {});
+    }
+    _jank = null;
+    _jankSince = now;
+  }
+
+  function _observe(type, onEntry) {
+    if (!PerformanceObserver.supportedEntryTypes?.includes(type)) return;
+    new PerformanceObserver(list => list.getEntries().forEach(onEntry))
+      .observe({ type, buffered: true });
+  }
+
+  if (window.top === window && typeof PerformanceObserver !== 'undefined') {
+    _observe('longtask', e => {
+      _addJank(_jankBucket().longTasks, e.duration, Math.max(0, e.duration - 50));
+    });
+    _observe('long-animation-frame', e => {
+      const j = _jankBucket();
+      if (_addJank(j.longFrames, e.duration, e.blockingDuration || 0)) {
+        const s = [...(e.scripts || [])].sort((a, b) => b.duration - a.duration)[0];
+        j.worstScript = s ? `${s.invoker || s.invokerType} ${s.sourceURL || ''}`.trim() : '';
+      }
+    });
+    _observe('layout-shift', e => {
+      if (e.hadRecentInput) return;
+      const j = _jankBucket();
+      j.layoutShifts++;
+      j.layoutShiftScore += e.value;
+      // CLS: largest session window (shifts < 1 s apart, session ≤ 5 s).
+      if (_clsSession && e.startTime - _clsLast < 1000 && e.startTime - _clsFirst < 5000) {
+        _clsSession += e.value;
+      } else {
+        _clsSession = e.value;
+        _clsFirst = e.startTime;
+      }
+      _clsLast = e.startTime;
+      _cls = Math.max(_cls, _clsSession);
+    });
+    setInterval(_flushJank, _JANK_FLUSH_MS);
+    addEventListener('visibilitychange', () => {
+      if (document.visibilityState === 'hidden') _flushJank();
+    });
+  }
+
   // ── Public API ────────────────────────────────────────────────────────────
 
   window.bamboo = Object.freeze({
@@ -109,7 +220,7 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
     call(name, ...args) {
       const id = crypto.randomUUID();
       const promise = new Promise((resolve, reject) => {
-        _pending.set(id, { resolve, reject });
+        _pending.set(id, { resolve, reject, start: performance.now() });
         // Timeout after 30 seconds
         setTimeout(() => {
           if (_pending.has(id)) {
@@ -118,9 +229,12 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
           }
         }, 30000);
       });
-      _query({ type: 'call', name, args, id }).catch(err => {
+      // Piggyback earlier round-trip samples for Browser::bridgeStats().
+      const rtt = _rtt.length ? _rtt.splice(0) : undefined;
+      // A request that cannot be posted fails the call now, not at the timeout.
+      _query({ type: 'call', name, args, id, rtt }).catch(err => {
+        _pending.get(id)?.reject(err);
         _pending.delete(id);
-        throw err;
       });
       return promise;
     },
@@ -131,6 +245,10 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
       return _query({ type: 'setStyle', style: styleObject });
     },
 
+    animateStyle(styleObject, duration = 200, easing = 'ease-in-out') {
+      return _query({ type: 'animateStyle', style: styleObject, duration, easing });
+    },
+
     setDragRegions(regions) {
       return _query({ type: 'setDragRegions', regions });
     },
@@ -157,8 +275,11 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
     },
 
     captureScreenshot() {
-      return _query({ type: 'windowOp', op: 'screenshot' })
-        .then(result => JSON.parse(result).data);  // base64 PNG string
+      return bamboo.call('__screenshot');  // base64 PNG string
+    },
+
+    stats() {
+      return bamboo.call('__stats').then(JSON.parse);
     },
 
     // ── Internal (called by C++) ───────────────────────────────────────────
@@ -173,32 +294,171 @@ inline constexpr std::string_view kBambooBridgeScript = R"js(
     },
 
     _resolveCall,
+    _setCSS,
   });
 
-  // ── CSS injection for custom chrome styles ────────────────────────────────
-  // Injected by C++ via Browser::injectBridgeCSS() on each load.
-  // (Placeholder — actual CSS is dynamically constructed from WindowStyle.)
-
 })();
 )js";
 
+// ─── Browser → renderer protocol for style CSS ───────────────────────────────
+
+/** Process message: args = [hash (string), css (string)]. */
+inline constexpr char kSetCSSMessage[] = "bamboo.setCSS";
+/** extra_info keys passed to OnBrowserCreated so the first page has its CSS. */
+inline constexpr char kCSSKey[]        = "bamboo.css";
+inline constexpr char kCSSHashKey[]    = "bamboo.cssHash";
+
+// ─── Renderer → browser bridge requests ──────────────────────────────────────
+
+/** Renderer → browser: args = [request (JSON text)]; see bridge::routeRequest. */
+inline constexpr char kBridgeMessage[] = "bamboo.bridge";
+
+/** window.__bambooPost(json): forwards one window.bamboo request to the browser. */
+class BridgePostHandler final : public CefV8Handler {
+public:
+    bool Execute(const CefString&, CefRefPtr<CefV8Value>, const CefV8ValueList& args,
+                 CefRefPtr<CefV8Value>&, CefString& exception) override
+    {
+        auto context = CefV8Context::GetCurrentContext();
+        if (args.size() != 1 || !args[0]->IsString() || !context) {
+            exception = "__bambooPost expects one JSON string";
+            return true;
+        }
+        auto msg = CefProcessMessage::Create(kBridgeMessage);
+        msg->GetArgumentList()->SetString(0, args[0]->GetStringValue());
+        context->GetFrame()->SendProcessMessage(PID_BROWSER, msg);
+        return true;
+    }
+
+    IMPLEMENT_REFCOUNTING(BridgePostHandler);
+};
+
+// ─── Renderer → browser resource reporting ───────────────────────────────────
+
+/** Renderer → browser on every main-frame context: args = [pid (int)]. */
+inline constexpr char kRendererInfoMessage[] = "bamboo.rendererInfo";
+/** Browser → renderer: report performance.memory for the main frame. */
+inline constexpr char kHeapQueryMessage[]    = "bamboo.heapQuery";
+/** Renderer → browser reply: args = [usedJSHeapSize, totalJSHeapSize] (double). */
+inline constexpr char kHeapUsageMessage[]    = "bamboo.heapUsage";
+
 /**
  * @brief Renderer-process handler that installs window.bamboo on every page.
+ *
+ * It also keeps the style-derived CSS for each browser, keyed by hash.
+ * The CSS is attached synchronously in OnContextCreated, which runs at
+ * document start. A navigation therefore costs one adoptedStyleSheets
+ * attach and no browser-process round trip.
  */
 class BambooJsBridge final : public CefRenderProcessHandler {
 public:
+    void OnBrowserCreated(CefRefPtr<CefBrowser>        browser,
+                          CefRefPtr<CefDictionaryValue> extraInfo) override
+    {
+        if (extraInfo && extraInfo->HasKey(kCSSHashKey))
+            remember(browser->GetIdentifier(),
+                     extraInfo->GetString(kCSSHashKey), extraInfo->GetString(kCSSKey));
+    }
+
+    void OnBrowserDestroyed(CefRefPtr<CefBrowser> browser) override {
+        current_.erase(browser->GetIdentifier());
+    }
+
     void OnContextCreated(CefRefPtr<CefBrowser>   browser,
                           CefRefPtr<CefFrame>     frame,
                           CefRefPtr<CefV8Context> context) override
     {
-        frame->ExecuteJavaScript(
-            std::string(kBambooBridgeScript),
-            frame->GetURL(),
-            0
-        );
+        // Subframes get window.bamboo without a transport; their requests
+        // reject at once (the browser only answers the main frame).
+        if (frame->IsMain() && context->Enter()) {
+            context->GetGlobal()->SetValue("__bambooPost",
+                CefV8Value::CreateFunction("__bambooPost", post_), V8_PROPERTY_ATTRIBUTE_DONTENUM);
+            context->Exit();
+        }
+        // Eval (not ExecuteJavaScript) so window.bamboo exists before the CSS attach.
+        CefRefPtr<CefV8Value>     retval;
+        CefRefPtr<CefV8Exception> exception;
+        context->Eval(std::string(kBambooBridgeScript), frame->GetURL(), 0, retval, exception);
+        if (!frame->IsMain()) return;
+        attachCSS(browser->GetIdentifier(), context);
+        // A navigation can move the browser to another renderer; say which.
+        auto info = CefProcessMessage::Create(kRendererInfoMessage);
+        info->GetArgumentList()->SetInt(0, currentPid());
+        frame->SendProcessMessage(PID_BROWSER, info);
+    }
+
+    bool OnProcessMessageReceived(CefRefPtr<CefBrowser>        browser,
+                                  CefRefPtr<CefFrame>          frame,
+                                  CefProcessId,
+                                  CefRefPtr<CefProcessMessage> message) override
+    {
+        if (message->GetName() == kHeapQueryMessage) {
+            if (auto context = frame->GetV8Context()) reportHeap(frame, context);
+            return true;
+        }
+        if (message->GetName() != kSetCSSMessage) return false;
+        auto args = message->GetArgumentList();
+        const int   id   = browser->GetIdentifier();
+        std::string hash = args->GetString(0);
+        if (auto it = current_.find(id); it != current_.end() && it->second == hash)
+            return true;  // already attached at document start
+        remember(id, std::move(hash), args->GetString(1));
+        if (auto context = frame->GetV8Context()) attachCSS(id, context);
+        return true;
     }
 
     IMPLEMENT_REFCOUNTING(BambooJsBridge);
+
+private:
+    void remember(int browserId, std::string hash, std::string css) {
+        cssByHash_.try_emplace(hash, std::move(css));
+        current_[browserId] = std::move(hash);
+    }
+
+    void attachCSS(int browserId, CefRefPtr<CefV8Context> context) {
+        auto cur = current_.find(browserId);
+        if (cur == current_.end() || !context->Enter()) return;
+        auto bamboo = context->GetGlobal()->GetValue("bamboo");
+        if (bamboo && bamboo->IsObject()) {
+            auto fn = bamboo->GetValue("_setCSS");
+            if (fn && fn->IsFunction())
+                fn->ExecuteFunction(bamboo, { CefV8Value::CreateString(cssByHash_[cur->second]) });
+        }
+        context->Exit();
+    }
+
+    static int currentPid() {
+#if defined(_WIN32)
+        return _getpid();
+#else
+        return static_cast<int>(getpid());
+#endif
+    }
+
+    static void reportHeap(CefRefPtr<CefFrame> frame, CefRefPtr<CefV8Context> context) {
+        if (!context->Enter()) return;
+        double used = 0, total = 0;
+        auto perf = context->GetGlobal()->GetValue("performance");
+        auto mem  = perf && perf->IsObject() ? perf->GetValue("memory") : nullptr;
+        auto number = [&](const char* key) {
+            auto v = mem->GetValue(key);  // small values arrive as int, large as double
+            return v && (v->IsInt() || v->IsUInt() || v->IsDouble()) ? v->GetDoubleValue() : 0.0;
+        };
+        if (mem && mem->IsObject()) {
+            used  = number("usedJSHeapSize");
+            total = number("totalJSHeapSize");
+        }
+        context->Exit();
+        auto reply = CefProcessMessage::Create(kHeapUsageMessage);
+        reply->GetArgumentList()->SetDouble(0, used);
+        reply->GetArgumentList()->SetDouble(1, total);
+        frame->SendProcessMessage(PID_BROWSER, reply);
+    }
+
+    CefRefPtr<BridgePostHandler>                 post_ = new BridgePostHandler();
+    std::unordered_map<int, std::string>         current_;    // browser id → CSS hash
+    // Only scrollbar × text-selection feed the CSS, so this stays tiny.
+    std::unordered_map<std::string, std::string> cssByHash_;  // hash → CSS text
 };
 
 } // namespace bamboo
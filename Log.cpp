@@ -0,0 +1,180 @@
+// bamboo/Log.cpp - see include/bamboo/Log.hpp for API docs
+#include "bamboo/Log.hpp"
+#include "bamboo/Trace.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+  #include <process.h>
+#else
+  #include <unistd.h>
+#endif
+
+namespace bamboo::logging {
+
+namespace {
+
+struct Entry {
+    LogLevel                              level;
+    std::chrono::system_clock::time_point time;
+    uint64_t                              threadId;
+    const char*                           file;
+    int                                   line;
+    std::string                           message;
+};
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:   return "TRACE";
+        case LogLevel::Debug:   return "DEBUG";
+        case LogLevel::Info:    return "INFO";
+        case LogLevel::Warning: return "WARNING";
+        case LogLevel::Error:   return "ERROR";
+        case LogLevel::Off:     break;
+    }
+    return "INFO";
+}
+
+std::string_view baseName(const char* path) {
+    std::string_view p = path;
+    if (auto slash = p.find_last_of("/\\"); slash != std::string_view::npos) p.remove_prefix(slash + 1);
+    return p;
+}
+
+int processId() {
+#if defined(_WIN32)
+    return _getpid();
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+// Chromium's layout, so Bamboo lines read naturally among CEF's own:
+//   [pid:tid:MMDD/HHMMSS.mmm:LEVEL:file.cpp(123)] message
+void appendLine(std::string& out, const Entry& e, int pid) {
+    const auto t  = std::chrono::system_clock::to_time_t(e.time);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        e.time.time_since_epoch()).count() % 1000;
+    std::tm tm{};
+#if defined(_WIN32)
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    std::format_to(std::back_inserter(out), "[{}:{}:{:02}{:02}/{:02}{:02}{:02}.{:03}:{}:{}({})] {}\n",
+                   pid, e.threadId, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, ms,
+                   levelName(e.level), baseName(e.file), e.line, e.message);
+}
+
+class Backend {
+public:
+    static Backend& instance() {
+        static Backend backend;
+        return backend;
+    }
+
+    void start(LogConfig config) {
+        std::lock_guard lock(mutex_);
+        if (running_) return;
+        console_ = config.console;
+        if (!config.path.empty()) file_.open(config.path, std::ios::binary | std::ios::app);
+        running_ = true;
+        thread_  = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard lock(mutex_);
+            if (!running_) return;
+            running_ = false;
+        }
+        wake_.notify_one();
+        thread_.join();
+        file_.close();
+    }
+
+    // False (leaving `e` untouched) if the backend is not running; the
+    // caller then writes synchronously.
+    bool enqueue(Entry&& e) {
+        {
+            std::lock_guard lock(mutex_);
+            if (!running_) return false;
+            queue_.push_back(std::move(e));
+        }
+        wake_.notify_one();
+        return true;
+    }
+
+    ~Backend() { stop(); }
+
+private:
+    void run() {
+        const int pid = processId();
+        std::vector<Entry> batch;
+        std::string        text;
+        for (;;) {
+            bool running;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return !queue_.empty() || !running_; });
+                batch.swap(queue_);
+                running = running_;
+            }
+            text.clear();
+            for (const auto& e : batch) appendLine(text, e, pid);
+            // One write per batch: the file is shared (O_APPEND) with
+            // Chromium's processes, so lines must not be split.
+            if (file_.is_open()) { file_.write(text.data(), static_cast<std::streamsize>(text.size())); file_.flush(); }
+            if (console_)
+                for (const auto& e : batch)
+                    std::fprintf(stderr, "[Bamboo:%s] %s\n", levelName(e.level), e.message.c_str());
+            batch.clear();
+            if (!running) return;
+        }
+    }
+
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    std::vector<Entry>      queue_;
+    std::thread             thread_;
+    std::ofstream           file_;
+    bool                    console_ = true;
+    bool                    running_ = false;
+};
+
+} // namespace
+
+void rotate(const std::string& path, int keep) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (path.empty() || !fs::exists(path, ec)) return;
+    if (keep <= 0) { fs::remove(path, ec); return; }
+    fs::remove(path + "." + std::to_string(keep), ec);
+    for (int i = keep - 1; i >= 1; --i)
+        fs::rename(path + "." + std::to_string(i), path + "." + std::to_string(i + 1), ec);
+    fs::rename(path, path + ".1", ec);
+}
+
+void start(LogConfig config) {
+    setLevel(config.level);
+    Backend::instance().start(std::move(config));
+}
+
+void stop() { Backend::instance().stop(); }
+
+void write(LogLevel level, const char* file, int line, std::string message) {
+    Entry e{ level, std::chrono::system_clock::now(), trace::currentThreadId(), file, line, std::move(message) };
+    if (Backend::instance().enqueue(std::move(e))) return;
+    std::fprintf(stderr, "[Bamboo:%s] %s\n", levelName(level), e.message.c_str());
+}
+
+} // namespace bamboo::logging
@@ -0,0 +1,91 @@
+#pragma once
+// bamboo/Log.hpp
+// Leveled logging for Bamboo internals (and apps that want it).
+//
+// BAMBOO_LOG_INFO("v{} initialized", version) formats only if the level is
+// enabled; levels below BAMBOO_LOG_MIN_LEVEL are compiled out entirely.
+// Lines are queued and written by a background thread into AppConfig::logPath
+// — the same file Chromium logs to, in the same line format — so one
+// rotation at startup covers both.
+
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <string>
+
+namespace bamboo {
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off,
+};
+
+// Compile-time floor (0 = Trace … 5 = Off). Set via -DBAMBOO_LOG_LEVEL=<name> in CMake.
+#ifndef BAMBOO_LOG_MIN_LEVEL
+  #define BAMBOO_LOG_MIN_LEVEL 1
+#endif
+
+namespace logging {
+
+inline constexpr LogLevel kMinLevel = static_cast<LogLevel>(BAMBOO_LOG_MIN_LEVEL);
+
+[[nodiscard]] constexpr bool compiledIn(LogLevel level) { return level >= kMinLevel; }
+
+namespace detail {
+inline std::atomic<LogLevel> level{LogLevel::Info};
+}
+
+/** Runtime check; one relaxed load. */
+[[nodiscard]] inline bool enabled(LogLevel level) {
+    return compiledIn(level) && level >= detail::level.load(std::memory_order_relaxed);
+}
+
+inline void setLevel(LogLevel level) { detail::level.store(level, std::memory_order_relaxed); }
+
+struct LogConfig {
+    std::string path;                  // "" = no file
+    bool        console   = true;      // also write to stderr
+    int         keepFiles = 3;         // path.1 … path.N kept by rotate()
+    LogLevel    level     = LogLevel::Info;
+};
+
+/**
+ * @brief Shift `path` → `path.1` → … → `path.keep`, dropping the oldest.
+ *
+ * Call before anything opens `path`. App::create does this for logPath
+ * before CEF starts, so Chromium and Bamboo share one fresh file.
+ */
+void rotate(const std::string& path, int keep);
+
+/** Start the background writer. Until then, lines go straight to stderr. */
+void start(LogConfig config);
+
+/** Write everything queued and stop the writer (App's destructor). */
+void stop();
+
+/** Queue one line. Prefer the macros, which skip formatting when disabled. */
+void write(LogLevel level, const char* file, int line, std::string message);
+
+} // namespace logging
+} // namespace bamboo
+
+// ─── Macros ───────────────────────────────────────────────────────────────────
+
+#define BAMBOO_LOG(level, ...)                                                        \
+    do {                                                                              \
+        if constexpr (::bamboo::logging::compiledIn(level)) {                         \
+            if (::bamboo::logging::enabled(level))                                    \
+                ::bamboo::logging::write(level, __FILE__, __LINE__,                   \
+                                         std::format(__VA_ARGS__));                   \
+        }                                                                             \
+    } while (0)
+
+#define BAMBOO_LOG_TRACE(...) BAMBOO_LOG(::bamboo::LogLevel::Trace,   __VA_ARGS__)
+#define BAMBOO_LOG_DEBUG(...) BAMBOO_LOG(::bamboo::LogLevel::Debug,   __VA_ARGS__)
+#define BAMBOO_LOG_INFO(...)  BAMBOO_LOG(::bamboo::LogLevel::Info,    __VA_ARGS__)
+#define BAMBOO_LOG_WARN(...)  BAMBOO_LOG(::bamboo::LogLevel::Warning, __VA_ARGS__)
+#define BAMBOO_LOG_ERROR(...) BAMBOO_LOG(::bamboo::LogLevel::Error,   __VA_ARGS__)
@@ -0,0 +1,154 @@
+// bamboo/PngWriter.cpp - see include/bamboo/PngWriter.hpp for API docs
+#include "bamboo/PngWriter.hpp"
+#include <zlib.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace bamboo {
+
+namespace {
+
+constexpr std::array<uint8_t, 8> kPngSignature = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+constexpr size_t kIdatChunkSize = 64 * 1024;
+
+void putU32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >>  8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+} // namespace
+
+struct PngWriter::Deflate {
+    z_stream strm{};
+    bool     initialized = false;
+    ~Deflate() { if (initialized) deflateEnd(&strm); }
+};
+
+PngWriter::PngWriter(uint32_t width, uint32_t height)
+    : z_(std::make_unique<Deflate>()),
+      width_(width),
+      height_(height),
+      row_(static_cast<size_t>(width) * 4),
+      filtered_(1 + static_cast<size_t>(width) * 4),
+      prev_(static_cast<size_t>(width) * 4, 0),
+      out_(kIdatChunkSize) {}
+
+PngWriter::~PngWriter() = default;
+
+std::expected<std::unique_ptr<PngWriter>, PngError>
+PngWriter::open(const std::string& path, uint32_t width, uint32_t height, int compressionLevel) {
+    // PNG dimensions are limited to 2^31-1; keep rows addressable too.
+    if (width == 0 || height == 0 || width > 0x7FFFFFFF / 4 || height > 0x7FFFFFFF)
+        return std::unexpected(PngError::InvalidSize);
+
+    auto png = std::unique_ptr<PngWriter>(new PngWriter(width, height));
+    png->file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!png->file_) return std::unexpected(PngError::OpenFailed);
+
+    auto& strm = png->z_->strm;
+    if (deflateInit(&strm, compressionLevel) != Z_OK)
+        return std::unexpected(PngError::CompressFailed);
+    png->z_->initialized = true;
+    strm.next_out  = png->out_.data();
+    strm.avail_out = static_cast<uInt>(png->out_.size());
+
+    png->file_.write(reinterpret_cast<const char*>(kPngSignature.data()), kPngSignature.size());
+
+    // IHDR: 8-bit RGBA, deflate, adaptive filtering, no interlace.
+    uint8_t ihdr[13];
+    putU32(ihdr + 0, width);
+    putU32(ihdr + 4, height);
+    ihdr[8]  = 8;
+    ihdr[9]  = 6;
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+    png->writeChunk("IHDR", ihdr, sizeof(ihdr));
+
+    if (!png->file_) return std::unexpected(PngError::WriteFailed);
+    return png;
+}
+
+std::expected<void, PngError> PngWriter::writeRow(std::span<const uint8_t> rgba) {
+    if (finished_ || rows_ >= height_)   return std::unexpected(PngError::TooManyRows);
+    if (rgba.size() != row_.size())      return std::unexpected(PngError::InvalidRow);
+
+    // "Up" filter: screenshots repeat vertically far more than horizontally,
+    // and it needs only the previous row.
+    filtered_[0] = 2;
+    for (size_t i = 0; i < rgba.size(); ++i)
+        filtered_[i + 1] = static_cast<uint8_t>(rgba[i] - prev_[i]);
+    std::memcpy(prev_.data(), rgba.data(), rgba.size());
+
+    ++rows_;
+    return deflateRow(rows_ == height_);
+}
+
+std::expected<void, PngError> PngWriter::writeRowBGRA(std::span<const uint8_t> bgra) {
+    if (bgra.size() != row_.size()) return std::unexpected(PngError::InvalidRow);
+    for (size_t i = 0; i < bgra.size(); i += 4) {
+        uint8_t b = bgra[i], g = bgra[i + 1], r = bgra[i + 2], a = bgra[i + 3];
+        if (a != 0 && a != 255) {
+            r = static_cast<uint8_t>(std::min(255u, (r * 255u + a / 2) / a));
+            g = static_cast<uint8_t>(std::min(255u, (g * 255u + a / 2) / a));
+            b = static_cast<uint8_t>(std::min(255u, (b * 255u + a / 2) / a));
+        }
+        row_[i]     = r;
+        row_[i + 1] = g;
+        row_[i + 2] = b;
+        row_[i + 3] = a;
+    }
+    return writeRow(row_);
+}
+
+std::expected<void, PngError> PngWriter::deflateRow(bool last) {
+    auto& strm = z_->strm;
+    strm.next_in  = filtered_.data();
+    strm.avail_in = static_cast<uInt>(filtered_.size());
+
+    int flush = last ? Z_FINISH : Z_NO_FLUSH;
+    for (;;) {
+        int rc = deflate(&strm, flush);
+        if (rc == Z_STREAM_ERROR) return std::unexpected(PngError::CompressFailed);
+
+        if (strm.avail_out == 0 || (rc == Z_STREAM_END && strm.avail_out < out_.size())) {
+            writeChunk("IDAT", out_.data(), out_.size() - strm.avail_out);
+            strm.next_out  = out_.data();
+            strm.avail_out = static_cast<uInt>(out_.size());
+        }
+        if (rc == Z_STREAM_END) break;
+        if (!last && strm.avail_in == 0 && strm.avail_out != 0) break;
+    }
+    if (!file_) return std::unexpected(PngError::WriteFailed);
+    return {};
+}
+
+std::expected<void, PngError> PngWriter::finish() {
+    if (finished_) return {};
+    if (rows_ != height_) return std::unexpected(PngError::InvalidRow);
+    writeChunk("IEND", nullptr, 0);
+    file_.flush();
+    finished_ = true;
+    if (!file_) return std::unexpected(PngError::WriteFailed);
+    return {};
+}
+
+void PngWriter::writeChunk(const char type[4], const uint8_t* data, size_t size) {
+    uint8_t header[8];
+    putU32(header, static_cast<uint32_t>(size));
+    std::memcpy(header + 4, type, 4);
+
+    uLong crc = crc32(0L, header + 4, 4);
+    if (size) crc = crc32(crc, data, static_cast<uInt>(size));
+    uint8_t trailer[4];
+    putU32(trailer, static_cast<uint32_t>(crc));
+
+    file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (size) file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    file_.write(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+}
+
+} // namespace bamboo
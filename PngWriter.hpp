@@ -0,0 +1,90 @@
+#pragma once
+// bamboo/PngWriter.hpp
+// Row-oriented streaming PNG encoder.
+// Rows are filtered, deflated and flushed to disk as they arrive, so peak
+// memory is one row plus the zlib window — independent of image height.
+
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bamboo {
+
+// ─── Error codes ──────────────────────────────────────────────────────────────
+
+enum class PngError {
+    OpenFailed,
+    InvalidSize,
+    InvalidRow,
+    TooManyRows,
+    CompressFailed,
+    WriteFailed,
+};
+
+/**
+ * @brief Streams an 8-bit RGBA PNG to disk one row at a time.
+ *
+ * Example:
+ *   auto png = bamboo::PngWriter::open("page.png", 1280, 50000).value();
+ *   for (...) png->writeRowBGRA(row);
+ *   png->finish();
+ */
+class PngWriter {
+public:
+    ~PngWriter();
+
+    PngWriter(const PngWriter&)            = delete;
+    PngWriter& operator=(const PngWriter&) = delete;
+
+    /**
+     * @brief Create the file and write the PNG signature + IHDR.
+     *
+     * @param compressionLevel zlib level 0–9 (6 = zlib default).
+     */
+    [[nodiscard]]
+    static std::expected<std::unique_ptr<PngWriter>, PngError>
+    open(const std::string& path, uint32_t width, uint32_t height, int compressionLevel = 6);
+
+    /** Append one row of straight (non-premultiplied) RGBA pixels, width*4 bytes. */
+    std::expected<void, PngError> writeRow(std::span<const uint8_t> rgba);
+
+    /**
+     * Append one row of BGRA pixels as delivered by CEF's off-screen renderer.
+     * Premultiplied alpha is converted to straight alpha.
+     */
+    std::expected<void, PngError> writeRowBGRA(std::span<const uint8_t> bgra);
+
+    /** Flush the deflate stream and write IEND. All rows must have been written. */
+    std::expected<void, PngError> finish();
+
+    [[nodiscard]] uint32_t width()       const { return width_; }
+    [[nodiscard]] uint32_t height()      const { return height_; }
+    [[nodiscard]] uint32_t rowsWritten() const { return rows_; }
+
+private:
+    struct Deflate;
+
+    PngWriter(uint32_t width, uint32_t height);
+    std::expected<void, PngError> deflateRow(bool last);
+    void writeChunk(const char type[4], const uint8_t* data, size_t size);
+
+    std::ofstream            file_;
+    std::unique_ptr<Deflate> z_;
+    uint32_t                 width_;
+    uint32_t                 height_;
+    uint32_t                 rows_     = 0;
+    bool                     finished_ = false;
+
+    // Filter byte + filtered scanline, and the previous unfiltered scanline
+    // for the PNG "Up" filter.
+    std::vector<uint8_t> row_;
+    std::vector<uint8_t> filtered_;
+    std::vector<uint8_t> prev_;
+    std::vector<uint8_t> out_;
+};
+
+} // namespace bamboo
@@ -0,0 +1,352 @@
+// bamboo/Profiling.cpp - see include/bamboo/Profiling.hpp for API docs
+#include "bamboo/Profiling.hpp"
+#include "bamboo/Browser.hpp"
+#include "bamboo/DevTools.hpp"
+#include "bamboo/Log.hpp"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <filesystem>
+#include <format>
+#include <thread>
+
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace bamboo::profiling {
+
+namespace {
+
+ProfileError toProfileError(const CdpError& e) {
+    return e.kind == DevToolsError::Protocol || e.kind == DevToolsError::BadResult
+        ? ProfileError::Protocol : ProfileError::NoDevTools;
+}
+
+// ─── Output file ──────────────────────────────────────────────────────────────
+
+// Written as "<path>.part" and renamed once complete, so a crash or a full
+// disk never leaves a truncated profile under the final name.
+class ProfileFile {
+public:
+    static std::unique_ptr<ProfileFile> open(std::string path) {
+        auto f = std::unique_ptr<ProfileFile>(new ProfileFile(std::move(path)));
+        f->file_ = std::fopen(f->part_.c_str(), "wb");
+        if (!f->file_) return nullptr;
+        std::setvbuf(f->file_, f->buffer_.get(), _IOFBF, kBufferSize);
+        return f;
+    }
+
+    ~ProfileFile() {
+        if (!file_) return;
+        std::fclose(file_);
+        std::error_code ec;
+        std::filesystem::remove(part_, ec);
+    }
+
+    [[nodiscard]] std::FILE* get() const { return file_; }
+
+    std::expected<void, ProfileError> commit() {
+        const bool ok = std::fflush(file_) == 0 && !std::ferror(file_);
+        const bool closed = std::fclose(file_) == 0;
+        file_ = nullptr;
+        std::error_code ec;
+        if (ok && closed) std::filesystem::rename(part_, path_, ec);
+        if (!ok || !closed || ec) {
+            std::filesystem::remove(part_, ec);
+            return std::unexpected(ProfileError::WriteFailed);
+        }
+        return {};
+    }
+
+private:
+    static constexpr size_t kBufferSize = 1 << 20;
+
+    explicit ProfileFile(std::string path)
+        : path_(std::move(path)), part_(path_ + ".part"),
+          buffer_(std::make_unique<char[]>(kBufferSize)) {}
+
+    std::string             path_, part_;
+    std::FILE*              file_ = nullptr;
+    std::unique_ptr<char[]> buffer_;
+};
+
+// Profiler.stop answers {"profile":{…}}; the value is written out verbatim.
+std::string_view profileValue(std::string_view raw) {
+    const size_t key   = raw.find("\"profile\"");
+    const size_t colon = key == raw.npos ? raw.npos : raw.find(':', key);
+    const size_t end   = raw.rfind('}');
+    if (colon == raw.npos || end == raw.npos || end <= colon) return {};
+    std::string_view v = raw.substr(colon + 1, end - colon - 1);
+    while (!v.empty() && std::isspace(static_cast<unsigned char>(v.front()))) v.remove_prefix(1);
+    while (!v.empty() && std::isspace(static_cast<unsigned char>(v.back())))  v.remove_suffix(1);
+    return v.starts_with('{') && v.ends_with('}') ? v : std::string_view{};
+}
+
+size_t encodeUtf8(uint32_t cp, char out[4]) {
+    if (cp < 0x80)    { out[0] = static_cast<char>(cp); return 1; }
+    if (cp < 0x800)   { out[0] = static_cast<char>(0xC0 | (cp >> 6));
+                        out[1] = static_cast<char>(0x80 | (cp & 0x3F)); return 2; }
+    if (cp < 0x10000) { out[0] = static_cast<char>(0xE0 | (cp >> 12));
+                        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                        out[2] = static_cast<char>(0x80 | (cp & 0x3F)); return 3; }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+} // namespace
+
+// ─── JSON string streaming ────────────────────────────────────────────────────
+
+bool writeJsonString(std::string_view raw, std::string_view key, std::FILE* out) {
+    const std::string quoted = std::format("\"{}\"", key);
+    size_t pos = raw.find(quoted);
+    if (pos == raw.npos) return false;
+    pos += quoted.size();
+
+    auto skipSpace = [&] { while (pos < raw.size() && std::isspace(static_cast<unsigned char>(raw[pos]))) ++pos; };
+    auto expect    = [&](char c) { skipSpace(); return pos < raw.size() && raw[pos++] == c; };
+    if (!expect(':') || !expect('"')) return false;
+
+    auto hex4 = [&](uint32_t& v) {
+        if (raw.size() - pos < 4) return false;
+        v = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char h = raw[pos++];
+            const char l = static_cast<char>(h | 0x20);
+            v <<= 4;
+            if (h >= '0' && h <= '9')      v |= static_cast<uint32_t>(h - '0');
+            else if (l >= 'a' && l <= 'f') v |= static_cast<uint32_t>(l - 'a' + 10);
+            else return false;
+        }
+        return true;
+    };
+
+    // Unescaped runs go to the FILE buffer straight from CEF's; only escapes
+    // are decoded byte by byte.
+    for (;;) {
+        const size_t stop = raw.find_first_of("\"\\", pos);
+        if (stop == raw.npos) return false;
+        if (stop > pos && std::fwrite(raw.data() + pos, 1, stop - pos, out) != stop - pos) return false;
+        pos = stop + 1;
+        if (raw[stop] == '"') return true;
+        if (pos >= raw.size()) return false;
+
+        char c = raw[pos++];
+        switch (c) {
+            case '"': case '\\': case '/': break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u': {
+                uint32_t cp = 0;
+                if (!hex4(cp)) return false;
+                if (cp >= 0xD800 && cp < 0xDC00 && raw.substr(pos, 2) == "\\u") {
+                    const size_t save = pos;
+                    pos += 2;
+                    uint32_t lo = 0;
+                    if (hex4(lo) && lo >= 0xDC00 && lo < 0xE000)
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    else
+                        pos = save;  // lone surrogate: kept as is
+                }
+                char utf8[4];
+                const size_t n = encodeUtf8(cp, utf8);
+                if (std::fwrite(utf8, 1, n, out) != n) return false;
+                continue;
+            }
+            default: return false;
+        }
+        if (std::fputc(c, out) == EOF) return false;
+    }
+}
+
+// ─── CPU profile ──────────────────────────────────────────────────────────────
+
+void captureCpuProfile(std::shared_ptr<DevToolsClient> dt, std::chrono::milliseconds duration,
+                       std::string path, ProfileCallback done) {
+    CEF_REQUIRE_UI_THREAD();
+    auto stop = [weak = std::weak_ptr<DevToolsClient>(dt), path = std::move(path), done] {
+        auto dt = weak.lock();
+        if (!dt) return done(std::unexpected(ProfileError::NoDevTools));
+        // Raw: a .cpuprofile is tens of MB, and it only needs copying to disk.
+        dt->send(cdp::Profiler::stop::method, nullptr,
+            [dt, path, done](std::expected<CdpMessage, CdpError> r) {
+                dt->send(cdp::Profiler::disable{}, [](auto) {});
+                if (!r) return done(std::unexpected(toProfileError(r.error())));
+                const std::string_view profile = profileValue(r->raw());
+                if (profile.empty()) return done(std::unexpected(ProfileError::Protocol));
+                auto file = ProfileFile::open(path);
+                if (!file) return done(std::unexpected(ProfileError::OpenFailed));
+                if (std::fwrite(profile.data(), 1, profile.size(), file->get()) != profile.size())
+                    return done(std::unexpected(ProfileError::WriteFailed));
+                done(file->commit());
+            });
+    };
+
+    dt->send(cdp::Profiler::enable{}, [dt, duration, stop, done](auto r) {
+        if (!r) return done(std::unexpected(toProfileError(r.error())));
+        dt->send(cdp::Profiler::start{}, [duration, stop, done](auto r) {
+            if (!r) return done(std::unexpected(toProfileError(r.error())));
+            CefPostDelayedTask(TID_UI, CefCreateClosureTask(stop), duration.count());
+        });
+    });
+}
+
+// ─── Heap snapshot ────────────────────────────────────────────────────────────
+
+void captureHeapSnapshot(std::shared_ptr<DevToolsClient> dt, std::string path, ProfileCallback done) {
+    CEF_REQUIRE_UI_THREAD();
+    // Opened up front so a bad path fails before V8 spends seconds walking the heap.
+    std::shared_ptr<ProfileFile> file = ProfileFile::open(std::move(path));
+    if (!file) return done(std::unexpected(ProfileError::OpenFailed));
+
+    // Chunks are written on the UI thread as they arrive: each is ~100 KB and
+    // goes through a 1 MB stdio buffer into the page cache, so memory stays
+    // flat however big the heap is.
+    auto failed = std::make_shared<bool>(false);
+    const auto sub = dt->on(std::string(cdp::HeapProfiler::addHeapSnapshotChunk::event),
+        [file, failed](CdpMessage m) {
+            if (!*failed && !writeJsonString(m.raw(), "chunk", file->get())) *failed = true;
+        });
+
+    dt->send(cdp::HeapProfiler::enable{}, [dt, file, failed, sub, done](auto r) {
+        if (!r) {
+            dt->off(sub);
+            return done(std::unexpected(toProfileError(r.error())));
+        }
+        // Every chunk event precedes this reply.
+        dt->send(cdp::HeapProfiler::takeHeapSnapshot{}, [dt, file, failed, sub, done](auto r) {
+            dt->off(sub);
+            if (!r)      return done(std::unexpected(toProfileError(r.error())));
+            if (*failed) return done(std::unexpected(ProfileError::WriteFailed));
+            done(file->commit());
+        });
+    });
+}
+
+// ─── Triggers ─────────────────────────────────────────────────────────────────
+
+namespace {
+
+enum class Capture { Cpu, Heap };
+
+ProfilingTriggers& triggerConfig() {
+    static ProfilingTriggers config;
+    return config;
+}
+bool& hotkeysEnabled() {
+    static bool enabled = false;
+    return enabled;
+}
+
+std::string outputPath(const Browser& browser, Capture kind) {
+    const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+#if defined(_WIN32)
+    const int pid = static_cast<int>(::GetCurrentProcessId());
+#else
+    const int pid = static_cast<int>(::getpid());
+#endif
+    const int id  = browser.cefBrowser() ? browser.cefBrowser()->GetIdentifier() : 0;
+    return (std::filesystem::path(triggerConfig().directory) /
+            std::format("bamboo-{}-{}-{:%Y%m%d-%H%M%S}.{}", pid, id, now,
+                        kind == Capture::Cpu ? "cpuprofile" : "heapsnapshot")).string();
+}
+
+void capture(const std::shared_ptr<Browser>& browser, Capture kind) {
+    std::string path = outputPath(*browser, kind);
+    auto report = [path, kind](std::expected<void, ProfileError> r) {
+        const char* what = kind == Capture::Cpu ? "CPU profile" : "Heap snapshot";
+        if (r) BAMBOO_LOG_INFO("{} written to {}", what, path);
+        else   BAMBOO_LOG_WARN("{} failed (error {})", what, static_cast<int>(r.error()));
+    };
+    if (kind == Capture::Cpu) browser->captureCpuProfile(triggerConfig().cpuDuration, std::move(path), report);
+    else                      browser->captureHeapSnapshot(std::move(path), report);
+}
+
+void captureAll(Capture kind) {
+    for (const auto& b : Browser::openBrowsers())
+        if (b->cefBrowser()) capture(b, kind);
+}
+
+#if !defined(_WIN32)
+// The handler only writes one byte to a pipe (async-signal-safe); a thread
+// blocked on the other end posts the capture to the UI thread.
+// Both are set before the handler is installed.
+int gSignalPipe[2] = { -1, -1 };
+std::atomic<int> gCpuSignal{0};
+static_assert(std::atomic<int>::is_always_lock_free, "read from a signal handler");
+
+void onProfilingSignal(int sig) {
+    const int saved = errno;
+    const char c = sig == gCpuSignal.load(std::memory_order_relaxed) ? 'c' : 'h';
+    [[maybe_unused]] auto n = ::write(gSignalPipe[1], &c, 1);
+    errno = saved;
+}
+
+void signalThread(int fd) {
+    for (char c; ;) {
+        const ssize_t n = ::read(fd, &c, 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        const Capture kind = c == 'c' ? Capture::Cpu : Capture::Heap;
+        CefPostTask(TID_UI, CefCreateClosureTask([kind] { captureAll(kind); }));
+    }
+}
+
+bool installSignal(int sig) {
+    struct sigaction sa {};
+    sa.sa_handler = onProfilingSignal;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    return ::sigaction(sig, &sa, nullptr) == 0;
+}
+#endif
+
+} // namespace
+
+void enableTriggers(ProfilingTriggers config) {
+    CEF_REQUIRE_UI_THREAD();
+    triggerConfig() = std::move(config);
+    hotkeysEnabled() = triggerConfig().hotkeys;
+    const auto& c = triggerConfig();
+#if !defined(_WIN32)
+    if ((c.cpuSignal || c.heapSignal) && gSignalPipe[0] < 0) {
+        if (::pipe(gSignalPipe) != 0) {
+            BAMBOO_LOG_WARN("Profiling triggers: pipe() failed, signals disabled");
+            return;
+        }
+        for (int fd : gSignalPipe) ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        ::fcntl(gSignalPipe[1], F_SETFL, O_NONBLOCK);  // a burst of signals must never block the handler
+        std::thread(signalThread, gSignalPipe[0]).detach();
+    }
+    gCpuSignal.store(c.cpuSignal, std::memory_order_relaxed);
+    for (int sig : { c.cpuSignal, c.heapSignal })
+        if (sig && !installSignal(sig)) BAMBOO_LOG_WARN("Profiling triggers: cannot handle signal {}", sig);
+#else
+    if (c.cpuSignal || c.heapSignal) BAMBOO_LOG_WARN("Profiling triggers: signals are not supported on Windows");
+#endif
+    BAMBOO_LOG_INFO("Profiling triggers enabled; output in {}", c.directory);
+}
+
+bool handleHotkey(const std::shared_ptr<Browser>& browser, bool keyDown,
+                  int windowsKeyCode, uint32_t modifiers) {
+    constexpr uint32_t kChord = EVENTFLAG_CONTROL_DOWN | EVENTFLAG_ALT_DOWN | EVENTFLAG_SHIFT_DOWN;
+    if (!hotkeysEnabled() || !keyDown || (modifiers & kChord) != kChord) return false;
+    if (windowsKeyCode == 'P') { capture(browser, Capture::Cpu);  return true; }
+    if (windowsKeyCode == 'H') { capture(browser, Capture::Heap); return true; }
+    return false;
+}
+
+} // namespace bamboo::profiling
@@ -0,0 +1,85 @@
+#pragma once
+// bamboo/Profiling.hpp
+// V8 CPU profiles and heap snapshots written straight to disk — from C++
+// (Browser::captureCpuProfile / captureHeapSnapshot) or, in the field, from
+// a signal or hotkey (App::enableProfilingTriggers).
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace bamboo {
+
+class Browser;
+class DevToolsClient;
+
+// ─── Errors ───────────────────────────────────────────────────────────────────
+
+enum class ProfileError {
+    NoDevTools,     // no CEF browser, or the DevTools agent is unavailable
+    Busy,           // a capture of this kind is already running on the window
+    OpenFailed,     // could not create the output file
+    WriteFailed,    // I/O error or disk full; the partial file is removed
+    Protocol,       // the profiler command failed or returned something unexpected
+};
+
+using ProfileCallback = std::function<void(std::expected<void, ProfileError>)>;
+
+// ─── Triggers ─────────────────────────────────────────────────────────────────
+
+/**
+ * Out-of-process triggers for field builds. Every open window is captured
+ * to `directory` as bamboo-<pid>-<window>-<UTC time>.cpuprofile/.heapsnapshot.
+ *
+ *   kill -USR1 <pid>      CPU profile for `cpuDuration`
+ *   kill -USR2 <pid>      heap snapshot
+ *   Ctrl+Alt+Shift+P / H  the same, for the focused window only
+ */
+struct ProfilingTriggers {
+    std::string               directory   = ".";
+    std::chrono::milliseconds cpuDuration { 10'000 };
+#if defined(_WIN32)
+    int                       cpuSignal   = 0;         // no SIGUSR on Windows; use hotkeys
+    int                       heapSignal  = 0;
+#else
+    int                       cpuSignal   = SIGUSR1;   // 0 = none
+    int                       heapSignal  = SIGUSR2;
+#endif
+    bool                      hotkeys     = true;
+};
+
+// ─── Internals ────────────────────────────────────────────────────────────────
+// Browser and App wrap these; they exist separately so the capture logic
+// does not need Browser's private state. UI thread only.
+
+namespace profiling {
+
+/** Profiler.start, wait `duration`, Profiler.stop; the profile goes to `path`. */
+void captureCpuProfile(std::shared_ptr<DevToolsClient> dt, std::chrono::milliseconds duration,
+                       std::string path, ProfileCallback done);
+
+/** HeapProfiler.takeHeapSnapshot, each chunk unescaped into `path` as it arrives. */
+void captureHeapSnapshot(std::shared_ptr<DevToolsClient> dt, std::string path, ProfileCallback done);
+
+/**
+ * Decode the JSON string under `key` in `raw` (an object's text) and append
+ * it to `out` without building a DOM. False if the key is missing, the
+ * string is malformed or the write fails.
+ */
+bool writeJsonString(std::string_view raw, std::string_view key, std::FILE* out);
+
+void enableTriggers(ProfilingTriggers config);
+
+/** Called for every key event; true if it was a profiling hotkey (consumed). */
+bool handleHotkey(const std::shared_ptr<Browser>& browser, bool keyDown,
+                  int windowsKeyCode, uint32_t modifiers);
+
+} // namespace profiling
+
+} // namespace bamboo
@@ -0,0 +1,126 @@
+#pragma once
+// bamboo/RecordRing.hpp
+// Framed records over an SpscRing, drained by a writer thread.
+// The common core of ConsoleSink and BridgeRecorder: the hot thread copies a
+// fixed header plus variable-length parts into the ring in one push, and a
+// background thread pops whole records and hands them to the owner.
+
+#include "bamboo/SpscRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace bamboo {
+
+/**
+ * @brief SPSC byte ring of `Header` + body records with a writer thread.
+ *
+ * push() is wait-free and must come from one thread. start() runs the
+ * writer: every `interval` it passes each queued record to `onRecord`, then
+ * calls `onIdle(false)`; stop() (or destruction) drains what is left, calls
+ * `onIdle(true)` and joins. Both callbacks run on the writer thread only.
+ */
+template <class Header>
+class RecordRing {
+    static_assert(std::is_trivially_copyable_v<Header>, "headers are copied through the ring as bytes");
+
+public:
+    using RecordFn = std::function<void(const Header&, std::span<const std::byte> body)>;
+    using IdleFn   = std::function<void(bool final)>;
+
+    /** `capacity` in bytes; a record larger than the ring can never be pushed. */
+    explicit RecordRing(size_t capacity) : ring_(capacity) {}
+    ~RecordRing() { stop(); }
+
+    RecordRing(const RecordRing&)            = delete;
+    RecordRing& operator=(const RecordRing&) = delete;
+
+    [[nodiscard]] size_t capacity() const { return ring_.capacity(); }
+    /** Ring bytes a record takes beyond its body. */
+    static constexpr size_t frameBytes() { return sizeof(Frame); }
+
+    // ── Producer ─────────────────────────────────────────────────────────────
+
+    /** Enqueue `header` followed by `parts` as one record; false if it does not fit. */
+    bool push(const Header& header, std::initializer_list<std::span<const std::byte>> parts) {
+        size_t body = 0;
+        for (auto p : parts) body += p.size();
+        const Frame frame{ header, static_cast<uint32_t>(body) };
+        const size_t bytes = sizeof frame + body;
+        if (ring_.capacity() - ring_.size() < bytes) return false;
+
+        // One push per record so the writer never sees half of one.
+        record_.resize(bytes);
+        std::byte* out = record_.data();
+        std::memcpy(out, &frame, sizeof frame);            out += sizeof frame;
+        for (auto p : parts) {
+            if (p.empty()) continue;   // memcpy must not see a null source
+            std::memcpy(out, p.data(), p.size());
+            out += p.size();
+        }
+        ring_.push(record_.data(), bytes);
+        return true;
+    }
+
+    // ── Writer ───────────────────────────────────────────────────────────────
+
+    void start(std::chrono::milliseconds interval, RecordFn onRecord, IdleFn onIdle) {
+        onRecord_ = std::move(onRecord);
+        onIdle_   = std::move(onIdle);
+        running_  = true;
+        writer_   = std::thread([this, interval] {
+            while (running_.load(std::memory_order_relaxed)) {
+                drain();
+                onIdle_(false);
+                std::this_thread::sleep_for(interval);
+            }
+            drain();
+            onIdle_(true);
+        });
+    }
+
+    void stop() {
+        running_ = false;
+        if (writer_.joinable()) writer_.join();
+    }
+
+private:
+    struct Frame {
+        Header   header;
+        uint32_t bodyBytes;
+    };
+
+    void drain() {
+        Frame frame;
+        while (ring_.pop(reinterpret_cast<std::byte*>(&frame), sizeof frame) == sizeof frame) {
+            body_.resize(frame.bodyBytes);
+            ring_.pop(body_.data(), body_.size());
+            onRecord_(frame.header, body_);
+        }
+    }
+
+    SpscRing<std::byte>    ring_;
+    std::vector<std::byte> record_;   // producer scratch
+    std::vector<std::byte> body_;     // writer scratch
+    RecordFn               onRecord_;
+    IdleFn                 onIdle_;
+    std::atomic<bool>      running_{false};
+    std::thread            writer_;
+};
+
+/** Raw bytes of a string for RecordRing::push. */
+template <class Char>
+std::span<const std::byte> recordBytes(std::basic_string_view<Char> s) {
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+} // namespace bamboo
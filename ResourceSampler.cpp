@@ -0,0 +1,150 @@
+// bamboo/ResourceSampler.cpp - see include/bamboo/ResourceSampler.hpp for API docs
+#include "bamboo/ResourceSampler.hpp"
+#include "bamboo/Browser.hpp"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include <algorithm>
+
+namespace bamboo {
+
+namespace {
+
+// Hysteresis: a metric that went over budget must fall below this fraction
+// of the limit before "back under" fires, so values hovering at the limit
+// don't produce an event every tick.
+constexpr double kRecoverFraction = 0.9;
+
+} // namespace
+
+std::expected<std::shared_ptr<ResourceSampler>, ResourceError>
+ResourceSampler::create(ResourceSamplerConfig config) {
+    CEF_REQUIRE_UI_THREAD();
+#if defined(__linux__)
+    auto self = std::shared_ptr<ResourceSampler>(new ResourceSampler(config));
+    self->sampleNow();
+    self->scheduleTick();
+    return self;
+#else
+    (void)config;
+    return std::unexpected(ResourceError::Unsupported);
+#endif
+}
+
+void ResourceSampler::scheduleTick() {
+    CefPostDelayedTask(TID_UI, CefCreateClosureTask([weak = weak_from_this()] {
+        if (auto self = weak.lock()) {
+            self->sampleNow();
+            self->scheduleTick();
+        }
+    }), config_.interval.count());
+}
+
+void ResourceSampler::sampleNow() {
+    CEF_REQUIRE_UI_THREAD();
+    if (inFlight_) return;
+
+    std::vector<int> pids;
+    for (const auto& b : Browser::openBrowsers()) {
+        const int pid = b->rendererPid();
+        if (pid <= 0) continue;
+        b->requestHeapUsage();
+        if (std::ranges::find(pids, pid) == pids.end()) pids.push_back(pid);
+    }
+
+    // smaps_rollup walks the process's page tables; keep it off the UI thread.
+    inFlight_ = true;
+    CefPostTask(TID_FILE_BACKGROUND, CefCreateClosureTask(
+        [weak = weak_from_this(), pids = std::move(pids)] {
+            std::vector<ProcessUsage> read;
+            read.reserve(pids.size());
+            for (int pid : pids)
+                if (auto u = readProcessUsage(pid)) read.push_back(*u);
+            const auto at = std::chrono::steady_clock::now();
+            CefPostTask(TID_UI, CefCreateClosureTask([weak, read = std::move(read), at]() mutable {
+                if (auto self = weak.lock()) self->apply(std::move(read), at);
+            }));
+        }));
+}
+
+void ResourceSampler::apply(std::vector<ProcessUsage> processes,
+                            std::chrono::steady_clock::time_point at) {
+    inFlight_ = false;
+
+    std::unordered_map<int, ResourceUsage> byPid;
+    for (const auto& p : processes) {
+        ResourceUsage u{ .rendererPid = p.pid, .rssBytes = p.rssBytes, .pssBytes = p.pssBytes,
+                         .cpuSeconds = p.cpuSeconds, .sampledAt = at };
+        if (auto it = lastCpu_.find(p.pid); it != lastCpu_.end()) {
+            const double wall = std::chrono::duration<double>(at - it->second.at).count();
+            if (wall > 0) u.cpuPercent = 100.0 * (p.cpuSeconds - it->second.cpuSeconds) / wall;
+        }
+        byPid.emplace(p.pid, u);
+    }
+    lastCpu_.clear();  // also forgets renderers that exited
+    for (const auto& p : processes) lastCpu_[p.pid] = { p.cpuSeconds, at };
+
+    auto browsers = Browser::openBrowsers();
+    std::unordered_map<int, int> windowsPerPid;
+    for (const auto& b : browsers)
+        if (byPid.contains(b->rendererPid_)) ++windowsPerPid[b->rendererPid_];
+
+    // One V8 isolate per renderer: windows sharing a process report the same
+    // heap, so count it once per PID.
+    std::unordered_map<int, std::pair<uint64_t, uint64_t>> heapPerPid;
+    for (const auto& b : browsers) {
+        auto it = byPid.find(b->rendererPid_);
+        if (it == byPid.end()) continue;
+        auto& usage = b->resourceUsage_;
+        const uint64_t heapUsed = usage.jsHeapUsedBytes, heapTotal = usage.jsHeapTotalBytes;
+        usage = it->second;
+        usage.jsHeapUsedBytes  = heapUsed;
+        usage.jsHeapTotalBytes = heapTotal;
+        usage.sharedWith       = windowsPerPid[b->rendererPid_] - 1;
+        auto& heap  = heapPerPid[b->rendererPid_];
+        heap.first  = std::max(heap.first, heapUsed);
+        heap.second = std::max(heap.second, heapTotal);
+    }
+
+    ResourceUsage total{ .sampledAt = at };
+    for (const auto& [pid, u] : byPid) {
+        total.rssBytes   += u.rssBytes;
+        total.pssBytes   += u.pssBytes;
+        total.cpuSeconds += u.cpuSeconds;
+        total.cpuPercent += u.cpuPercent;
+    }
+    for (const auto& [pid, heap] : heapPerPid) {
+        total.jsHeapUsedBytes  += heap.first;
+        total.jsHeapTotalBytes += heap.second;
+    }
+    total_ = total;
+
+    using Metric = BudgetEvent::Metric;
+    const auto& w = config_.perWindow;
+    for (const auto& b : browsers) {
+        if (!byPid.contains(b->rendererPid_) || !b->cefBrowser()) continue;
+        const int id = b->cefBrowser()->GetIdentifier();
+        const auto& u = b->resourceUsage_;
+        check(Metric::Pss,    b, id, static_cast<double>(u.pssBytes),        static_cast<double>(w.pssBytes));
+        check(Metric::Cpu,    b, id, u.cpuPercent,                           w.cpuPercent);
+        check(Metric::JsHeap, b, id, static_cast<double>(u.jsHeapUsedBytes), static_cast<double>(w.jsHeapBytes));
+    }
+    const auto& t = config_.total;
+    check(Metric::Pss,    nullptr, 0, static_cast<double>(total_.pssBytes),        static_cast<double>(t.pssBytes));
+    check(Metric::Cpu,    nullptr, 0, total_.cpuPercent,                           t.cpuPercent);
+    check(Metric::JsHeap, nullptr, 0, static_cast<double>(total_.jsHeapUsedBytes), static_cast<double>(t.jsHeapBytes));
+
+    if (onSample_) onSample_();
+}
+
+void ResourceSampler::check(BudgetEvent::Metric metric, const std::shared_ptr<Browser>& browser,
+                            int key, double value, double limit) {
+    if (limit <= 0) return;
+    bool& over = over_[(static_cast<uint64_t>(key) << 2) | static_cast<uint64_t>(metric)];
+    if (!over && value > limit)                          over = true;
+    else if (over && value < limit * kRecoverFraction)   over = false;
+    else return;
+    if (onBudget_) onBudget_({ metric, browser, value, limit, over });
+}
+
+} // namespace bamboo
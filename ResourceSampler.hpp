@@ -0,0 +1,105 @@
+#pragma once
+// bamboo/ResourceSampler.hpp
+// App-wide periodic sampling of renderer memory/CPU with budget events.
+
+#include "bamboo/ResourceUsage.hpp"
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace bamboo {
+
+class Browser;
+
+/** Limits; 0 = no limit. */
+struct ResourceBudget {
+    uint64_t pssBytes    = 0;
+    double   cpuPercent  = 0;   // of one core, averaged over one interval
+    uint64_t jsHeapBytes = 0;   // usedJSHeapSize
+};
+
+struct ResourceSamplerConfig {
+    std::chrono::milliseconds interval{2000};
+    ResourceBudget perWindow;   // checked against each window's renderer
+    ResourceBudget total;       // checked against the sum over renderers
+};
+
+struct BudgetEvent {
+    enum class Metric { Pss, Cpu, JsHeap };
+
+    Metric                   metric;
+    std::shared_ptr<Browser> browser;   // null for the app-wide total
+    double                   value;     // bytes or percent
+    double                   limit;
+    bool                     exceeded;  // false = back under budget
+};
+
+/**
+ * @brief Samples every open window's renderer on an interval (Linux).
+ *
+ * Each tick reads /proc for each distinct renderer PID on a CEF file thread.
+ * It then updates Browser::resourceUsage() on the UI thread. Budget events
+ * are edge-triggered: one when a value goes over its limit, and one when it
+ * drops back under 90% of it.
+ * JS heap figures arrive by process message and trail by one interval.
+ * Chromium reports them rounded unless --enable-precise-memory-info is set.
+ *
+ * Sampling stops when the sampler is destroyed. UI thread only.
+ *
+ * Example:
+ *   auto sampler = bamboo::ResourceSampler::create({
+ *       .perWindow = { .pssBytes = 500u << 20 },
+ *       .total     = { .pssBytes = 4ull << 30 },
+ *   }).value();
+ *   sampler->onBudget([](const bamboo::BudgetEvent& e) { ... });
+ */
+class ResourceSampler : public std::enable_shared_from_this<ResourceSampler> {
+public:
+    using BudgetCallback = std::function<void(const BudgetEvent&)>;
+    using SampleCallback = std::function<void()>;
+
+    [[nodiscard]]
+    static std::expected<std::shared_ptr<ResourceSampler>, ResourceError>
+    create(ResourceSamplerConfig config = {});
+
+    ResourceSampler(const ResourceSampler&)            = delete;
+    ResourceSampler& operator=(const ResourceSampler&) = delete;
+
+    void onBudget(BudgetCallback cb) { onBudget_ = std::move(cb); }
+    /** Called after every completed tick, once resourceUsage() is current. */
+    void onSample(SampleCallback cb) { onSample_ = std::move(cb); }
+
+    /** Sum over distinct renderer processes, as of the last tick. */
+    [[nodiscard]] const ResourceUsage& total() const { return total_; }
+
+    /** Take a sample now instead of waiting for the next tick. */
+    void sampleNow();
+
+private:
+    explicit ResourceSampler(ResourceSamplerConfig config) : config_(config) {}
+
+    struct CpuMark {
+        double                                cpuSeconds;
+        std::chrono::steady_clock::time_point at;
+    };
+
+    void scheduleTick();
+    void apply(std::vector<ProcessUsage> processes, std::chrono::steady_clock::time_point at);
+    void check(BudgetEvent::Metric metric, const std::shared_ptr<Browser>& browser,
+               int key, double value, double limit);
+
+    ResourceSamplerConfig config_;
+    BudgetCallback        onBudget_;
+    SampleCallback        onSample_;
+    ResourceUsage         total_;
+    bool                  inFlight_ = false;  // a /proc read is on the file thread
+
+    std::unordered_map<int, CpuMark>   lastCpu_;  // pid → previous reading
+    std::unordered_map<uint64_t, bool> over_;     // (browser id | 0, metric) → over budget
+};
+
+} // namespace bamboo
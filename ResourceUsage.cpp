@@ -0,0 +1,100 @@
+// bamboo/ResourceUsage.cpp - see include/bamboo/ResourceUsage.hpp for API docs
+#include "bamboo/ResourceUsage.hpp"
+#include <algorithm>
+#include <charconv>
+#include <string>
+
+#if defined(__linux__)
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace bamboo {
+
+namespace {
+
+// Value of a "Key:   1234 kB" line, in bytes.
+bool kbField(std::string_view text, std::string_view key, uint64_t& bytes) {
+    for (size_t pos = 0; pos < text.size();) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+        if (!line.starts_with(key) || line.size() <= key.size() || line[key.size()] != ':') continue;
+        line.remove_prefix(key.size() + 1);
+        while (!line.empty() && line.front() == ' ') line.remove_prefix(1);
+        uint64_t kb = 0;
+        if (std::from_chars(line.data(), line.data() + line.size(), kb).ec != std::errc{}) return false;
+        bytes = kb * 1024;
+        return true;
+    }
+    return false;
+}
+
+#if defined(__linux__)
+// /proc files report size 0, so read until EOF. One read() is usually enough.
+bool slurp(const std::string& path, std::string& out) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    out.clear();
+    char buf[4096];
+    for (;;) {
+        ssize_t n = ::read(fd, buf, sizeof buf);
+        if (n < 0) { ::close(fd); return false; }
+        if (n == 0) break;
+        out.append(buf, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return true;
+}
+#endif
+
+} // namespace
+
+bool parseSmapsRollup(std::string_view text, ProcessUsage& out) {
+    return kbField(text, "Rss", out.rssBytes) && kbField(text, "Pss", out.pssBytes);
+}
+
+bool parseStatCpuTicks(std::string_view text, uint64_t& ticks) {
+    // "pid (comm) state ppid ..." — comm may contain spaces and ')', so
+    // fields are counted from the last ')'. utime/stime are fields 14/15.
+    const size_t close = text.rfind(')');
+    if (close == std::string_view::npos) return false;
+    std::string_view rest = text.substr(close + 1);
+    uint64_t utime = 0, stime = 0;
+    for (int field = 3; field <= 15; ++field) {
+        while (!rest.empty() && rest.front() == ' ') rest.remove_prefix(1);
+        const size_t end = std::min(rest.find(' '), rest.size());
+        if (field == 14 || field == 15) {
+            uint64_t& dst = field == 14 ? utime : stime;
+            if (std::from_chars(rest.data(), rest.data() + end, dst).ec != std::errc{}) return false;
+        }
+        rest.remove_prefix(end);
+    }
+    ticks = utime + stime;
+    return true;
+}
+
+std::expected<ProcessUsage, ResourceError> readProcessUsage(int pid) {
+#if defined(__linux__)
+    if (pid <= 0) return std::unexpected(ResourceError::NoRenderer);
+    ProcessUsage usage{ .pid = pid };
+    const std::string dir = "/proc/" + std::to_string(pid);
+    std::string text;
+
+    if (!slurp(dir + "/smaps_rollup", text) || !parseSmapsRollup(text, usage))
+        return std::unexpected(ResourceError::ReadFailed);
+
+    uint64_t ticks = 0;
+    if (!slurp(dir + "/stat", text) || !parseStatCpuTicks(text, ticks))
+        return std::unexpected(ResourceError::ReadFailed);
+    static const long hz = sysconf(_SC_CLK_TCK);
+    usage.cpuSeconds = static_cast<double>(ticks) / static_cast<double>(hz > 0 ? hz : 100);
+    return usage;
+#else
+    (void)pid;
+    return std::unexpected(ResourceError::Unsupported);
+#endif
+}
+
+} // namespace bamboo
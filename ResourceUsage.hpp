@@ -0,0 +1,62 @@
+#pragma once
+// bamboo/ResourceUsage.hpp
+// Memory / CPU / JS-heap figures for a browser's renderer process, read from
+// /proc on Linux. Sampled app-wide by ResourceSampler; see Browser::resourceUsage().
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <string_view>
+
+namespace bamboo {
+
+// ─── Error codes ──────────────────────────────────────────────────────────────
+
+enum class ResourceError {
+    Unsupported,   // not Linux
+    NoRenderer,    // renderer PID not reported yet
+    ReadFailed,    // /proc entry missing (process exited) or unreadable
+};
+
+// ─── Types ────────────────────────────────────────────────────────────────────
+
+/** One process as read from /proc/<pid>/{smaps_rollup,stat}. */
+struct ProcessUsage {
+    int      pid        = 0;
+    uint64_t rssBytes   = 0;
+    uint64_t pssBytes   = 0;   // shared pages split between their users
+    double   cpuSeconds = 0;   // user + system, since process start
+};
+
+/**
+ * @brief What one window costs.
+ *
+ * Windows that share a renderer process (same site, or process limits) all
+ * report that process; `sharedWith` says how many other windows are in it.
+ * PSS is the figure to budget on — summed over processes it does not count
+ * shared libraries and zygote pages twice the way RSS does.
+ */
+struct ResourceUsage {
+    int      rendererPid      = 0;
+    int      sharedWith       = 0;
+    uint64_t rssBytes         = 0;
+    uint64_t pssBytes         = 0;
+    double   cpuSeconds       = 0;
+    double   cpuPercent       = 0;  // of one core, since the previous sample
+    uint64_t jsHeapUsedBytes  = 0;  // performance.memory, main frame
+    uint64_t jsHeapTotalBytes = 0;
+    std::chrono::steady_clock::time_point sampledAt{};
+};
+
+// ─── /proc readers ────────────────────────────────────────────────────────────
+
+/** Read RSS, PSS and CPU time of `pid`. Linux only. */
+[[nodiscard]] std::expected<ProcessUsage, ResourceError> readProcessUsage(int pid);
+
+/** Rss/Pss (kB lines) from /proc/<pid>/smaps_rollup text. */
+bool parseSmapsRollup(std::string_view text, ProcessUsage& out);
+
+/** utime + stime from /proc/<pid>/stat text, in clock ticks. */
+bool parseStatCpuTicks(std::string_view text, uint64_t& ticks);
+
+} // namespace bamboo
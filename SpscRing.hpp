@@ -0,0 +1,86 @@
+#pragma once
+// bamboo/SpscRing.hpp
+// Bounded lock-free single-producer / single-consumer ring buffer.
+// Used wherever a realtime or hot thread hands data to a background thread
+// without taking a lock (audio packets, console records, ...).
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace bamboo {
+
+/**
+ * @brief Wait-free SPSC ring of trivially copyable T.
+ *
+ * Exactly one thread may call the push functions and exactly one (other)
+ * thread the pop functions. Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing stores raw copies of T");
+
+public:
+    explicit SpscRing(size_t capacity)
+        : capacity_(std::bit_ceil(std::max<size_t>(capacity, 2))),
+          mask_(capacity_ - 1),
+          buffer_(std::make_unique<T[]>(capacity_)) {}
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+    /** Approximate fill level; exact when called from either endpoint. */
+    [[nodiscard]] size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    // ── Producer ─────────────────────────────────────────────────────────────
+
+    /** Push up to n items; returns how many fit. */
+    size_t push(const T* items, size_t n) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        n = std::min(n, capacity_ - (head - tail));
+        const size_t first = std::min(n, capacity_ - (head & mask_));
+        std::copy_n(items, first, buffer_.get() + (head & mask_));
+        std::copy_n(items + first, n - first, buffer_.get());
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    bool tryPush(const T& item) { return push(&item, 1) == 1; }
+
+    // ── Consumer ─────────────────────────────────────────────────────────────
+
+    /** Pop up to n items into out; returns how many were available. */
+    size_t pop(T* out, size_t n) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        n = std::min(n, head - tail);
+        const size_t first = std::min(n, capacity_ - (tail & mask_));
+        std::copy_n(buffer_.get() + (tail & mask_), first, out);
+        std::copy_n(buffer_.get(), n - first, out + first);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    bool tryPop(T& out) { return pop(&out, 1) == 1; }
+
+    /** Drop everything currently readable (consumer side). */
+    void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+private:
+    const size_t         capacity_;
+    const size_t         mask_;
+    std::unique_ptr<T[]> buffer_;
+
+    alignas(64) std::atomic<size_t> head_{0};  // written by the producer
+    alignas(64) std::atomic<size_t> tail_{0};  // written by the consumer
+};
+
+} // namespace bamboo
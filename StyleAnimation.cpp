@@ -0,0 +1,63 @@
+// bamboo/StyleAnimation.cpp - see include/bamboo/StyleAnimation.hpp for API docs
+#include "bamboo/StyleAnimation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace bamboo {
+
+namespace {
+
+int lerpInt(int a, int b, float t) {
+    return static_cast<int>(std::lround(a + (b - a) * static_cast<double>(t)));
+}
+
+uint8_t lerpByte(uint8_t a, uint8_t b, float t) {
+    return static_cast<uint8_t>(std::clamp(lerpInt(a, b, t), 0, 255));
+}
+
+Color lerpColor(Color a, Color b, float t) {
+    return { lerpByte(a.r, b.r, t), lerpByte(a.g, b.g, t),
+             lerpByte(a.b, b.b, t), lerpByte(a.a, b.a, t) };
+}
+
+} // namespace
+
+float ease(Easing easing, float t) {
+    t = std::clamp(t, 0.0f, 1.0f);
+    switch (easing) {
+        case Easing::Linear:  return t;
+        case Easing::EaseIn:  return t * t * t;
+        case Easing::EaseOut: { float u = 1.0f - t; return 1.0f - u * u * u; }
+        case Easing::EaseInOut:
+            if (t < 0.5f) return 4.0f * t * t * t;
+            { float u = -2.0f * t + 2.0f; return 1.0f - u * u * u / 2.0f; }
+    }
+    return t;
+}
+
+std::optional<Easing> parseEasing(std::string_view name) {
+    if (name == "linear")      return Easing::Linear;
+    if (name == "ease-in")     return Easing::EaseIn;
+    if (name == "ease-out")    return Easing::EaseOut;
+    if (name == "ease-in-out") return Easing::EaseInOut;
+    return std::nullopt;
+}
+
+WindowStyle lerpStyle(const WindowStyle& from, const WindowStyle& to, float t) {
+    if (t >= 1.0f) return to;
+    WindowStyle out = to;
+    out.backgroundOpacity = from.backgroundOpacity + (to.backgroundOpacity - from.backgroundOpacity) * t;
+    out.cornerRadius      = lerpInt(from.cornerRadius, to.cornerRadius, t);
+    out.backgroundColor   = lerpColor(from.backgroundColor, to.backgroundColor, t);
+    if (from.shadow.enabled == to.shadow.enabled) {
+        out.shadow.color   = lerpColor(from.shadow.color, to.shadow.color, t);
+        out.shadow.blur    = lerpInt(from.shadow.blur,    to.shadow.blur,    t);
+        out.shadow.spread  = lerpInt(from.shadow.spread,  to.shadow.spread,  t);
+        out.shadow.offsetX = lerpInt(from.shadow.offsetX, to.shadow.offsetX, t);
+        out.shadow.offsetY = lerpInt(from.shadow.offsetY, to.shadow.offsetY, t);
+    }
+    return out;
+}
+
+} // namespace bamboo
@@ -0,0 +1,35 @@
+#pragma once
+// bamboo/StyleAnimation.hpp
+// Easing curves and WindowStyle interpolation used by Browser::animateStyle().
+
+#include "bamboo/WindowStyle.hpp"
+#include <optional>
+#include <string_view>
+
+namespace bamboo {
+
+enum class Easing {
+    Linear,
+    EaseIn,     // cubic
+    EaseOut,    // cubic
+    EaseInOut,  // cubic
+};
+
+/** Map linear progress t ∈ [0, 1] through the easing curve. */
+[[nodiscard]] float ease(Easing easing, float t);
+
+/** Parse "linear" | "ease-in" | "ease-out" | "ease-in-out" (CSS names). */
+[[nodiscard]] std::optional<Easing> parseEasing(std::string_view name);
+
+/**
+ * @brief Style at eased progress `t` between `from` and `to`.
+ *
+ * Continuous fields — backgroundOpacity, cornerRadius, backgroundColor and
+ * the shadow's colour/blur/spread/offset — are interpolated. Everything
+ * else (booleans, enums, regions) takes `to`'s value from the first frame,
+ * so diffStyle() reports it once and never again. A shadow that is being
+ * switched on or off snaps as well.
+ */
+[[nodiscard]] WindowStyle lerpStyle(const WindowStyle& from, const WindowStyle& to, float t);
+
+} // namespace bamboo
@@ -4,7 +4,10 @@
 #pragma once
 
 #include "bamboo/WindowStyle.hpp"
+#include "bamboo/StyleDiff.hpp"
 #include "include/cef_browser.h"
+#include <cstdint>
+#include <functional>
 
 namespace bamboo::platform {
 
@@ -12,9 +15,11 @@ namespace bamboo::platform {
  * @brief Apply a WindowStyle to the native window hosting the given CEF browser.
  *
  * Called on the CEF UI thread after the browser window is created and
- * whenever setStyle() is called at runtime.
+ * whenever setStyle() is called at runtime. Only the field groups in
+ * `changed` are pushed to the OS (see diffStyle()).
  */
-void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style);
+void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style,
+                StyleField changed = StyleField::All);
 
 /**
  * @brief Set drag regions for a frameless window.
@@ -63,4 +68,38 @@ void setShadow(CefRefPtr<CefBrowser> browser, const Shadow& shadow);
  */
 void setResizable(CefRefPtr<CefBrowser> browser, bool resizable);
 
+/**
+ * @brief Call `onFrame` once per display frame, before paint, until it
+ *        returns false. Drives Browser::animateStyle().
+ *
+ * Returns false if the window has no usable frame clock (only GTK provides
+ * one today); callers then fall back to a UI-thread timer.
+ */
+bool addFrameCallback(CefRefPtr<CefBrowser> browser, std::function<bool()> onFrame);
+
+/**
+ * @brief Drop any native state cached for this browser (window handles,
+ *        per-window style objects). Call from OnBeforeClose.
+ */
+void forgetBrowser(CefRefPtr<CefBrowser> browser);
+
+/**
+ * @brief Cumulative cost of native style application.
+ *
+ * Only the X11 backend counts anything; other platforms return zeros.
+ * `requests` is measured with XNextRequest, so it includes requests GTK
+ * issues on our behalf. `roundTrips` counts calls that block on a reply.
+ */
+struct NativeStyleStats {
+    uint64_t applications       = 0;  // applyStyle() calls + standalone setters
+    uint64_t requests           = 0;
+    uint64_t roundTrips         = 0;
+    uint64_t flushes            = 0;
+    uint64_t handleCacheMisses  = 0;  // toplevel-list walks
+    uint64_t lastRequests       = 0;  // for the most recent application
+    uint64_t lastRoundTrips     = 0;
+};
+
+[[nodiscard]] NativeStyleStats nativeStyleStats();
+
 } // namespace bamboo::platform
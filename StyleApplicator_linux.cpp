@@ -2,6 +2,8 @@
 // Linux-specific WindowStyle application via GTK3/X11.
 
 #include "bamboo/platform/StyleApplicator.hpp"
+#include "bamboo/Trace.hpp"
+#include "bamboo/DragRegionIndex.hpp"
 #include "include/cef_browser.h"
 
 #if defined(__linux__)
@@ -10,27 +12,242 @@
 #include <gdk/gdkx.h>
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace bamboo::platform {
 
 namespace {
 
-GtkWidget* getGtkWidget(CefRefPtr<CefBrowser> browser) {
-    if (!browser) return nullptr;
-    CefWindowHandle handle = browser->GetHost()->GetWindowHandle();
+// ─── Generated window CSS ─────────────────────────────────────────────────────
+// Everything Bamboo styles through GTK CSS lives in one provider per window
+// that is reloaded in place; adding a fresh provider per call would make
+// every later style recalculation walk all of them.
+
+struct WindowCSS {
+    int                  cornerRadius = 0;
+    std::optional<Color> background;
+};
+
+uint64_t hashCSS(const WindowCSS& css) {
+    uint64_t h = 1469598103934665603ull;  // FNV-1a
+    auto mix = [&](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+    mix(static_cast<uint64_t>(css.cornerRadius));
+    mix(css.background.has_value());
+    if (css.background) {
+        const Color& c = *css.background;
+        mix((uint64_t(c.r) << 24) | (uint64_t(c.g) << 16) | (uint64_t(c.b) << 8) | c.a);
+    }
+    return h;
+}
+
+/** CSS text for `css`, memoised by hash — animated radii revisit the same few values. */
+const std::string& generateCSS(const WindowCSS& css, uint64_t hash) {
+    static std::unordered_map<uint64_t, std::string> memo;
+    if (auto it = memo.find(hash); it != memo.end()) return it->second;
+    if (memo.size() >= 256) memo.clear();
+
+    std::string out = "window {";
+    if (css.cornerRadius > 0)
+        out += std::format(" border-radius: {}px;", css.cornerRadius);
+    if (css.background) {
+        const Color& c = *css.background;
+        out += std::format(" background-color: rgba({},{},{},{:.3f});", c.r, c.g, c.b, c.a / 255.0);
+    }
+    out += " }";
+    return memo.emplace(hash, std::move(out)).first->second;
+}
+
+// ─── Native handle cache ──────────────────────────────────────────────────────
+// gtk_window_list_toplevels() allocates a list and walks every toplevel, so
+// resolve each browser once and remember it. The GtkWidget* is registered as
+// a GObject weak pointer and nulls itself if GTK destroys the window first.
+
+struct CachedWindow {
+    int             browserId = 0;
+    GtkWidget*      widget    = nullptr;
+    CefWindowHandle xid       = 0;
+    bool            noToplevel = false;  // findToplevel(xid) failed; retried once xid changes
+    GtkCssProvider* provider  = nullptr;  // attached to widget's style context
+    WindowCSS       css;
+    uint64_t        cssHash   = 0;
+    std::vector<DragRegion> dragRegionList;   // as given, for the input shape
+    DragRegionIndex dragRegions;
+    GdkWindow*      dragInput    = nullptr;   // input-only, over the content view
+    gulong          pressHandler = 0;         // "button-press-event" while regions exist
+};
+
+std::unordered_map<int, CachedWindow>& windowCache() {
+    static std::unordered_map<int, CachedWindow> cache;  // UI thread only
+    return cache;
+}
+
+NativeStyleStats g_stats;
+
+GtkWidget* findToplevel(CefWindowHandle handle) {
+    ++g_stats.handleCacheMisses;
     // On Linux, GetWindowHandle() returns an X11 Window ID (XID).
     // We walk GTK's window list to find the matching GdkWindow.
     GList* toplevels = gtk_window_list_toplevels();
+    GtkWidget* found = nullptr;
     for (GList* l = toplevels; l; l = l->next) {
         GtkWidget* w = GTK_WIDGET(l->data);
         GdkWindow* gdk = gtk_widget_get_window(w);
-        if (gdk && GDK_WINDOW_XID(gdk) == handle) {
-            g_list_free(toplevels);
-            return w;
-        }
+        if (gdk && GDK_WINDOW_XID(gdk) == handle) { found = w; break; }
     }
     g_list_free(toplevels);
-    return nullptr;
+    return found;
+}
+
+void updateWindowCSS(CachedWindow& e) {
+    if (!e.widget) return;
+    const uint64_t hash = hashCSS(e.css);
+    if (e.provider && hash == e.cssHash) return;
+    if (!e.provider) {
+        e.provider = gtk_css_provider_new();
+        gtk_style_context_add_provider(
+            gtk_widget_get_style_context(e.widget),
+            GTK_STYLE_PROVIDER(e.provider),
+            GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
+        );
+    }
+    gtk_css_provider_load_from_data(e.provider, generateCSS(e.css, hash).c_str(), -1, nullptr);
+    e.cssHash = hash;
+}
+
+// ─── Drag regions ─────────────────────────────────────────────────────────────
+// Presses over web content go to Chromium's own child X window and never
+// reach the toplevel. A native input-only window stacked above the content
+// and shaped to the draggable area takes exactly those presses; its user
+// data is the toplevel widget, so they arrive as its "button-press-event",
+// in content-view coordinates.
+
+/** Origin of the CEF content view in the toplevel's GdkWindow. */
+GdkPoint contentOffset(const CachedWindow& e, GdkWindow* top) {
+    int x = 0, y = 0;
+    ::Window child = 0;
+    if (e.xid != GDK_WINDOW_XID(top)) {
+        ++g_stats.roundTrips;
+        XTranslateCoordinates(GDK_WINDOW_XDISPLAY(top), e.xid, GDK_WINDOW_XID(top), 0, 0, &x, &y, &child);
+    }
+    return { x, y };
+}
+
+/** In CEF order: a later region overrides an earlier one where they overlap. */
+cairo_region_t* dragShape(const std::vector<DragRegion>& regions) {
+    cairo_region_t* shape = cairo_region_create();
+    for (const auto& r : regions) {
+        const cairo_rectangle_int_t rect{ r.x, r.y, r.width, r.height };
+        if (r.isDraggable) cairo_region_union_rectangle(shape, &rect);
+        else               cairo_region_subtract_rectangle(shape, &rect);
+    }
+    return shape;
+}
+
+gboolean onButtonPress(GtkWidget* w, GdkEventButton* ev, gpointer data) {
+    if (ev->type != GDK_BUTTON_PRESS || ev->button != GDK_BUTTON_PRIMARY) return FALSE;
+    auto& cache = windowCache();
+    auto it = cache.find(GPOINTER_TO_INT(data));
+    if (it == cache.end() || ev->window != it->second.dragInput ||
+        !it->second.dragRegions.isDraggable(static_cast<int>(ev->x), static_cast<int>(ev->y)))
+        return FALSE;
+    gtk_window_begin_move_drag(GTK_WINDOW(w), static_cast<gint>(ev->button),
+        static_cast<gint>(ev->x_root), static_cast<gint>(ev->y_root), ev->time);
+    return TRUE;
+}
+
+void updateDragHandler(CachedWindow& e) {
+    if (!e.widget) return;
+    if (e.dragRegions.empty()) {
+        if (e.dragInput) gdk_window_hide(e.dragInput);
+        if (e.pressHandler) g_signal_handler_disconnect(e.widget, e.pressHandler);
+        e.pressHandler = 0;
+        return;
+    }
+    GdkWindow* top = gtk_widget_get_window(e.widget);
+    if (!top) return;
+    if (!e.dragInput) {
+        GdkWindowAttr attr{};
+        attr.wclass      = GDK_INPUT_ONLY;
+        attr.window_type = GDK_WINDOW_CHILD;
+        attr.event_mask  = GDK_BUTTON_PRESS_MASK;
+        // Larger than any window; the input shape limits it to the regions.
+        attr.width = attr.height = 16384;
+        e.dragInput = gdk_window_new(top, &attr, 0);
+        // A client-side GDK child would sit below Chromium's X window.
+        gdk_window_ensure_native(e.dragInput);
+        gdk_window_set_user_data(e.dragInput, e.widget);
+        g_object_add_weak_pointer(G_OBJECT(e.dragInput), reinterpret_cast<gpointer*>(&e.dragInput));
+    }
+    const GdkPoint at = contentOffset(e, top);
+    gdk_window_move(e.dragInput, at.x, at.y);
+    cairo_region_t* shape = dragShape(e.dragRegionList);
+    gdk_window_input_shape_combine_region(e.dragInput, shape, 0, 0);
+    cairo_region_destroy(shape);
+    gdk_window_show(e.dragInput);
+    gdk_window_raise(e.dragInput);
+    if (!e.pressHandler) {
+        gtk_widget_add_events(e.widget, GDK_BUTTON_PRESS_MASK);
+        e.pressHandler = g_signal_connect(e.widget, "button-press-event",
+            G_CALLBACK(onButtonPress), GINT_TO_POINTER(e.browserId));
+    }
+}
+
+/** Detach the window's provider and stop tracking the widget. */
+void releaseWindow(CachedWindow& e) {
+    if (e.provider) {
+        if (e.widget)
+            gtk_style_context_remove_provider(gtk_widget_get_style_context(e.widget),
+                                              GTK_STYLE_PROVIDER(e.provider));
+        g_object_unref(e.provider);
+        e.provider = nullptr;
+    }
+    if (e.pressHandler && e.widget)
+        g_signal_handler_disconnect(e.widget, e.pressHandler);
+    e.pressHandler = 0;
+    if (e.dragInput) {
+        g_object_remove_weak_pointer(G_OBJECT(e.dragInput), reinterpret_cast<gpointer*>(&e.dragInput));
+        gdk_window_destroy(e.dragInput);
+        e.dragInput = nullptr;
+    }
+    if (e.widget)
+        g_object_remove_weak_pointer(G_OBJECT(e.widget), reinterpret_cast<gpointer*>(&e.widget));
+    e.widget = nullptr;
+}
+
+CachedWindow* getCachedWindow(CefRefPtr<CefBrowser> browser) {
+    if (!browser) return nullptr;
+    CefWindowHandle handle = browser->GetHost()->GetWindowHandle();
+    auto& entry = windowCache()[browser->GetIdentifier()];
+    if (entry.xid == handle) {
+        if (entry.widget)     return &entry;
+        if (entry.noToplevel) return nullptr;
+    }
+
+    releaseWindow(entry);
+    entry.browserId  = browser->GetIdentifier();
+    entry.widget     = findToplevel(handle);
+    entry.xid        = handle;
+    entry.noToplevel = !entry.widget;
+    if (!entry.widget) return nullptr;
+    // unordered_map never moves its nodes, so &entry.widget stays valid.
+    g_object_add_weak_pointer(G_OBJECT(entry.widget), reinterpret_cast<gpointer*>(&entry.widget));
+    // Window was re-created: restore its CSS and drag handling.
+    if (entry.cssHash) updateWindowCSS(entry);
+    updateDragHandler(entry);
+    return &entry;
+}
+
+GtkWidget* getGtkWidget(CefRefPtr<CefBrowser> browser) {
+    CachedWindow* e = getCachedWindow(browser);
+    return e ? e->widget : nullptr;
 }
 
 ::Display* getDisplay(GtkWidget* w) {
@@ -41,80 +258,166 @@ GtkWidget* getGtkWidget(CefRefPtr<CefBrowser> browser) {
     return GDK_WINDOW_XID(gtk_widget_get_window(w));
 }
 
+// ─── Atom cache ───────────────────────────────────────────────────────────────
+// XInternAtom is a synchronous round trip. Every atom this file uses is
+// interned in one XInternAtoms batch the first time a display is seen;
+// anything else is interned on demand and remembered for the process.
+
+constexpr const char* kKnownAtoms[] = {
+    "_MOTIF_WM_HINTS",
+};
+
+struct AtomCache {
+    ::Display*                            display = nullptr;
+    std::unordered_map<std::string, Atom> atoms;
+};
+
+AtomCache& atomCache() {
+    static AtomCache cache;
+    return cache;
+}
+
+Atom internAtom(::Display* dpy, const char* name) {
+    auto& cache = atomCache();
+    if (cache.display != dpy) {
+        cache.display = dpy;
+        cache.atoms.clear();
+        constexpr int n = static_cast<int>(std::size(kKnownAtoms));
+        Atom out[n] = {};
+        ++g_stats.roundTrips;
+        if (XInternAtoms(dpy, const_cast<char**>(kKnownAtoms), n, False, out))
+            for (int i = 0; i < n; ++i) cache.atoms.emplace(kKnownAtoms[i], out[i]);
+    }
+    if (auto it = cache.atoms.find(name); it != cache.atoms.end()) return it->second;
+    ++g_stats.roundTrips;
+    Atom a = XInternAtom(dpy, name, False);
+    cache.atoms.emplace(name, a);
+    return a;
+}
+
+// ─── Request batching ─────────────────────────────────────────────────────────
+// Property changes only sit in Xlib's output buffer until flushed. Each
+// public entry point opens a batch; nested ones (applyStyle → setShadow)
+// join the outermost, which flushes once and records the request count.
+
+class StyleBatch {
+public:
+    explicit StyleBatch(GtkWidget* w) {
+        if (depth_++ > 0) return;
+        display_        = getDisplay(w);
+        startRequest_   = XNextRequest(display_);
+        startRoundTrip_ = g_stats.roundTrips;
+    }
+    ~StyleBatch() {
+        if (--depth_ > 0) return;
+        XFlush(display_);
+        const uint64_t requests = XNextRequest(display_) - startRequest_;
+        ++g_stats.applications;
+        ++g_stats.flushes;
+        g_stats.requests      += requests;
+        g_stats.lastRequests   = requests;
+        g_stats.lastRoundTrips = g_stats.roundTrips - startRoundTrip_;
+    }
+
+    StyleBatch(const StyleBatch&)            = delete;
+    StyleBatch& operator=(const StyleBatch&) = delete;
+
+private:
+    static inline int depth_ = 0;
+    ::Display*    display_        = nullptr;
+    unsigned long startRequest_   = 0;
+    uint64_t      startRoundTrip_ = 0;
+};
+
 void setX11Property(GtkWidget* w, const char* name, long value) {
     Display* dpy  = getDisplay(w);
     ::Window  xwin = getXWindow(w);
-    Atom prop = XInternAtom(dpy, name, False);
-    Atom type = XInternAtom(dpy, "CARDINAL", False);
-    XChangeProperty(dpy, xwin, prop, type, 32, PropModeReplace,
+    Atom prop = internAtom(dpy, name);
+    XChangeProperty(dpy, xwin, prop, XA_CARDINAL, 32, PropModeReplace,
         reinterpret_cast<unsigned char*>(&value), 1);
 }
 
 } // namespace
 
-void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style) {
+void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style, StyleField changed) {
+    BAMBOO_TRACE_SCOPE("platform::applyStyle");
+    if (changed == StyleField::None) return;
     GtkWidget* w = getGtkWidget(browser);
     if (!w) return;
+    StyleBatch batch(w);
 
     GtkWindow* win = GTK_WINDOW(w);
 
     // ── Chrome mode ───────────────────────────────────────────────────────────
-    switch (style.chromeMode) {
-        case ChromeMode::Full:
-            gtk_window_set_decorated(win, TRUE);
-            break;
-        case ChromeMode::NativeTitlebar:
-            gtk_window_set_decorated(win, TRUE);
-            break;
-        case ChromeMode::Frameless:
-        case ChromeMode::CustomTitlebar:
-            gtk_window_set_decorated(win, FALSE);
-            break;
-    }
-
-    // ── Transparency ─────────────────────────────────────────────────────────
-    if (style.transparent || style.backgroundOpacity < 1.0f) {
-        GdkScreen* screen = gtk_widget_get_screen(w);
-        GdkVisual* visual = gdk_screen_get_rgba_visual(screen);
-        if (visual) {
-            gtk_widget_set_visual(w, visual);
-            gtk_widget_set_app_paintable(w, TRUE);
+    if (any(changed, StyleField::ChromeMode)) {
+        switch (style.chromeMode) {
+            case ChromeMode::Full:
+                gtk_window_set_decorated(win, TRUE);
+                break;
+            case ChromeMode::NativeTitlebar:
+                gtk_window_set_decorated(win, TRUE);
+                break;
+            case ChromeMode::Frameless:
+            case ChromeMode::CustomTitlebar:
+                gtk_window_set_decorated(win, FALSE);
+                break;
         }
     }
 
+    // ── Transparency / background colour ─────────────────────────────────────
+    // Only the background goes translucent: an RGBA visual, and the opacity
+    // as the alpha of the window CSS background. gtk_widget_set_opacity would
+    // fade the web content with it; it is left to setTransparent().
+    if (any(changed, StyleField::Transparency | StyleField::BackgroundColor)) {
+        Color bg = style.backgroundColor;
+        if (style.transparent || style.backgroundOpacity < 1.0f) {
+            if (GdkVisual* visual = gdk_screen_get_rgba_visual(gtk_widget_get_screen(w)))
+                gtk_widget_set_visual(w, visual);
+            bg.a = static_cast<uint8_t>(std::clamp(style.backgroundOpacity, 0.0f, 1.0f) * bg.a + 0.5f);
+        }
+        setBackgroundColor(browser, bg);
+    }
+
     // ── Always on top ─────────────────────────────────────────────────────────
-    gtk_window_set_keep_above(win, style.alwaysOnTop ? TRUE : FALSE);
+    if (any(changed, StyleField::AlwaysOnTop))
+        gtk_window_set_keep_above(win, style.alwaysOnTop ? TRUE : FALSE);
 
     // ── Skip taskbar ──────────────────────────────────────────────────────────
-    gtk_window_set_skip_taskbar_hint(win, style.skipTaskbar ? TRUE : FALSE);
+    if (any(changed, StyleField::SkipTaskbar))
+        gtk_window_set_skip_taskbar_hint(win, style.skipTaskbar ? TRUE : FALSE);
 
     // ── Resize ───────────────────────────────────────────────────────────────
-    setResizable(browser, style.resizable);
+    if (any(changed, StyleField::Resizable))
+        setResizable(browser, style.resizable);
 
     // ── Shadow (compositor hint) ──────────────────────────────────────────────
-    setShadow(browser, style.shadow);
+    if (any(changed, StyleField::Shadow))
+        setShadow(browser, style.shadow);
+
+    // ── Corner radius ─────────────────────────────────────────────────────────
+    if (any(changed, StyleField::CornerRadius))
+        setCornerRadius(browser, style.cornerRadius);
 
     gtk_widget_queue_draw(w);
 }
 
-void setDragRegions(CefRefPtr<CefBrowser>, const std::vector<DragRegion>&) {
-    // Drag regions on Linux are handled via CEF's drag handler.
-    // Nothing to do at the GTK/X11 level.
+void setDragRegions(CefRefPtr<CefBrowser> browser, const std::vector<DragRegion>& regions) {
+    // There is no OS-level drag region concept on X11, so Bamboo catches
+    // primary button presses itself and hands matches to the window manager.
+    CachedWindow* e = getCachedWindow(browser);
+    if (!e) return;
+    e->dragRegionList = regions;
+    e->dragRegions.rebuild(regions);
+    updateDragHandler(*e);
 }
 
 void setCornerRadius(CefRefPtr<CefBrowser> browser, int radius) {
-    GtkWidget* w = getGtkWidget(browser);
-    if (!w) return;
-    // Apply rounded corners via GTK CSS
-    auto* provider = gtk_css_provider_new();
-    auto css = std::string("window { border-radius: ") + std::to_string(radius) + "px; }";
-    gtk_css_provider_load_from_data(provider, css.c_str(), -1, nullptr);
-    gtk_style_context_add_provider(
-        gtk_widget_get_style_context(w),
-        GTK_STYLE_PROVIDER(provider),
-        GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
-    );
-    g_object_unref(provider);
+    CachedWindow* e = getCachedWindow(browser);
+    if (!e) return;
+    StyleBatch batch(e->widget);
+    // Apply rounded corners via the window's Bamboo CSS provider
+    e->css.cornerRadius = radius;
+    updateWindowCSS(*e);
 }
 
 void setMacOSVibrancy(CefRefPtr<CefBrowser>, MacOSVibrancy) {
@@ -126,15 +429,17 @@ void setWindowsMaterial(CefRefPtr<CefBrowser>, WindowsMaterial) {
 }
 
 void setBackgroundColor(CefRefPtr<CefBrowser> browser, Color c) {
-    GtkWidget* w = getGtkWidget(browser);
-    if (!w) return;
-    GdkRGBA color{c.r/255.0, c.g/255.0, c.b/255.0, c.a/255.0};
-    gtk_widget_override_background_color(w, GTK_STATE_FLAG_NORMAL, &color);
+    CachedWindow* e = getCachedWindow(browser);
+    if (!e) return;
+    StyleBatch batch(e->widget);
+    e->css.background = c;
+    updateWindowCSS(*e);
 }
 
 void setTransparent(CefRefPtr<CefBrowser> browser, bool transparent, float opacity) {
     GtkWidget* w = getGtkWidget(browser);
     if (!w) return;
+    StyleBatch batch(w);
     if (transparent) {
         GdkScreen* screen = gtk_widget_get_screen(w);
         GdkVisual* visual = gdk_screen_get_rgba_visual(screen);
@@ -152,14 +457,15 @@ void setMacOSTitlebarButtonPosition(CefRefPtr<CefBrowser>, const TitlebarButtonP
 void setShadow(CefRefPtr<CefBrowser> browser, const Shadow& shadow) {
     GtkWidget* w = getGtkWidget(browser);
     if (!w) return;
+    StyleBatch batch(w);
     // Hint the compositor to draw/suppress shadow
     GdkWindow* gdk = gtk_widget_get_window(w);
     if (gdk) {
         // _GTK_HIDE_TITLEBAR_WHEN_MAXIMIZED is a common hint; shadow is
         // compositor-dependent. Best we can do on X11 is the _NET_WM_WINDOW_SHADOW hint.
-        Display* dpy = GDK_DISPLAY_XDISPLAY(gtk_widget_get_display(w));
+        Display* dpy = getDisplay(w);
         ::Window xwin = GDK_WINDOW_XID(gdk);
-        Atom motifAtom = XInternAtom(dpy, "_MOTIF_WM_HINTS", False);
+        Atom motifAtom = internAtom(dpy, "_MOTIF_WM_HINTS");
         if (motifAtom != None) {
             struct MotifHints { unsigned long flags, functions, decorations, input_mode, status; };
             MotifHints hints{2, 0, shadow.enabled ? 1UL : 0UL, 0, 0};
@@ -172,8 +478,34 @@ void setShadow(CefRefPtr<CefBrowser> browser, const Shadow& shadow) {
 void setResizable(CefRefPtr<CefBrowser> browser, bool resizable) {
     GtkWidget* w = getGtkWidget(browser);
     if (!w) return;
+    StyleBatch batch(w);
     gtk_window_set_resizable(GTK_WINDOW(w), resizable ? TRUE : FALSE);
 }
 
+bool addFrameCallback(CefRefPtr<CefBrowser> browser, std::function<bool()> onFrame) {
+    GtkWidget* w = getGtkWidget(browser);
+    if (!w) return false;
+    using Callback = std::function<bool()>;
+    // The GdkFrameClock tick runs right before layout/paint of each frame.
+    gtk_widget_add_tick_callback(w,
+        [](GtkWidget*, GdkFrameClock*, gpointer data) -> gboolean {
+            return (*static_cast<Callback*>(data))() ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+        },
+        new Callback(std::move(onFrame)),
+        [](gpointer data) { delete static_cast<Callback*>(data); });
+    return true;
+}
+
+void forgetBrowser(CefRefPtr<CefBrowser> browser) {
+    if (!browser) return;
+    auto& cache = windowCache();
+    auto it = cache.find(browser->GetIdentifier());
+    if (it == cache.end()) return;
+    releaseWindow(it->second);
+    cache.erase(it);
+}
+
+NativeStyleStats nativeStyleStats() { return g_stats; }
+
 } // namespace bamboo::platform
 #endif // __linux__
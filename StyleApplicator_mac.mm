@@ -3,6 +3,7 @@
 // Compiled as Objective-C++ (.mm) so we can mix Cocoa APIs with C++.
 
 #include "bamboo/platform/StyleApplicator.hpp"
+#include "bamboo/Trace.hpp"
 #include "include/cef_browser.h"
 
 #import <AppKit/AppKit.h>
@@ -52,79 +53,89 @@ void removeVibrancy(NSWindow* window) {
 
 } // namespace
 
-void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style) {
+void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style, StyleField changed) {
+    BAMBOO_TRACE_SCOPE("platform::applyStyle");
+    if (changed == StyleField::None) return;
     NSWindow* win = getNSWindow(browser);
     if (!win) return;
 
     // ── Chrome mode ───────────────────────────────────────────────────────────
-    switch (style.chromeMode) {
-        case ChromeMode::Full:
-            // Nothing to strip — CEF's full Chrome UI is the default in CefSettings.chrome_runtime
-            break;
-
-        case ChromeMode::NativeTitlebar:
-            // Standard macOS titlebar, no custom chrome
-            win.titlebarAppearsTransparent = NO;
-            win.titleVisibility = NSWindowTitleVisible;
-            win.styleMask |= NSWindowStyleMaskTitled;
-            break;
-
-        case ChromeMode::Frameless:
-            win.styleMask = NSWindowStyleMaskBorderless
-                          | NSWindowStyleMaskResizable
-                          | (style.resizable ? NSWindowStyleMaskResizable : 0);
-            [win setMovableByWindowBackground:NO];
-            break;
-
-        case ChromeMode::CustomTitlebar:
-            if (style.titlebar.macosHidden) {
-                // "Hidden titlebar" — traffic lights float over content
-                win.titlebarAppearsTransparent = YES;
-                win.titleVisibility = NSWindowTitleHidden;
-                win.styleMask |= NSWindowStyleMaskFullSizeContentView;
-            } else {
-                win.titlebarAppearsTransparent = style.titlebar.transparentWhenInactive;
-            }
-            break;
+    if (any(changed, StyleField::ChromeMode | StyleField::Titlebar | StyleField::Resizable)) {
+        switch (style.chromeMode) {
+            case ChromeMode::Full:
+                // Nothing to strip — CEF's full Chrome UI is the default in CefSettings.chrome_runtime
+                break;
+
+            case ChromeMode::NativeTitlebar:
+                // Standard macOS titlebar, no custom chrome
+                win.titlebarAppearsTransparent = NO;
+                win.titleVisibility = NSWindowTitleVisible;
+                win.styleMask |= NSWindowStyleMaskTitled;
+                break;
+
+            case ChromeMode::Frameless:
+                win.styleMask = NSWindowStyleMaskBorderless
+                              | NSWindowStyleMaskResizable
+                              | (style.resizable ? NSWindowStyleMaskResizable : 0);
+                [win setMovableByWindowBackground:NO];
+                break;
+
+            case ChromeMode::CustomTitlebar:
+                if (style.titlebar.macosHidden) {
+                    // "Hidden titlebar" — traffic lights float over content
+                    win.titlebarAppearsTransparent = YES;
+                    win.titleVisibility = NSWindowTitleHidden;
+                    win.styleMask |= NSWindowStyleMaskFullSizeContentView;
+                } else {
+                    win.titlebarAppearsTransparent = style.titlebar.transparentWhenInactive;
+                }
+                break;
+        }
     }
 
     // ── Traffic light position ────────────────────────────────────────────────
-    if (style.titlebar.macosButtonPosition.has_value()) {
+    if (any(changed, StyleField::ChromeMode | StyleField::Titlebar) &&
+        style.titlebar.macosButtonPosition.has_value()) {
         setMacOSTitlebarButtonPosition(browser, *style.titlebar.macosButtonPosition);
     }
 
     // ── Transparency ─────────────────────────────────────────────────────────
-    if (style.transparent || style.backgroundOpacity < 1.0f) {
-        win.opaque = NO;
-        CGFloat alpha = style.backgroundOpacity;
-        win.backgroundColor = [NSColor colorWithRed: style.backgroundColor.r / 255.0
-                                              green: style.backgroundColor.g / 255.0
-                                               blue: style.backgroundColor.b / 255.0
-                                              alpha: alpha];
-    } else {
-        win.opaque = YES;
-        win.backgroundColor = [NSColor colorWithRed: style.backgroundColor.r / 255.0
-                                              green: style.backgroundColor.g / 255.0
-                                               blue: style.backgroundColor.b / 255.0
-                                              alpha: 1.0];
+    if (any(changed, StyleField::Transparency | StyleField::BackgroundColor)) {
+        if (style.transparent || style.backgroundOpacity < 1.0f) {
+            win.opaque = NO;
+            CGFloat alpha = style.backgroundOpacity;
+            win.backgroundColor = [NSColor colorWithRed: style.backgroundColor.r / 255.0
+                                                  green: style.backgroundColor.g / 255.0
+                                                   blue: style.backgroundColor.b / 255.0
+                                                  alpha: alpha];
+        } else {
+            win.opaque = YES;
+            win.backgroundColor = [NSColor colorWithRed: style.backgroundColor.r / 255.0
+                                                  green: style.backgroundColor.g / 255.0
+                                                   blue: style.backgroundColor.b / 255.0
+                                                  alpha: 1.0];
+        }
     }
 
     // ── Vibrancy ─────────────────────────────────────────────────────────────
-    setMacOSVibrancy(browser, style.macosVibrancy);
+    if (any(changed, StyleField::MacOSVibrancy))
+        setMacOSVibrancy(browser, style.macosVibrancy);
 
     // ── Shadow ───────────────────────────────────────────────────────────────
-    win.hasShadow = style.shadow.enabled;
+    if (any(changed, StyleField::Shadow))
+        win.hasShadow = style.shadow.enabled;
 
     // ── Window behaviour ─────────────────────────────────────────────────────
-    win.level = style.alwaysOnTop ? NSFloatingWindowLevel : NSNormalWindowLevel;
+    if (any(changed, StyleField::AlwaysOnTop))
+        win.level = style.alwaysOnTop ? NSFloatingWindowLevel : NSNormalWindowLevel;
 
-    if (!style.minimizable)
+    if (any(changed, StyleField::Minimizable) && !style.minimizable)
         win.styleMask &= ~NSWindowStyleMaskMiniaturizable;
-    if (!style.maximizable)
+    if (any(changed, StyleField::Maximizable) && !style.maximizable)
         [[win standardWindowButton:NSWindowZoomButton] setEnabled:NO];
 
     // ── Corner radius ─────────────────────────────────────────────────────────
-    if (style.cornerRadius > 0) {
+    if (any(changed, StyleField::CornerRadius) && style.cornerRadius > 0) {
         setCornerRadius(browser, style.cornerRadius);
     }
 
@@ -227,4 +238,14 @@ void setResizable(CefRefPtr<CefBrowser> browser, bool resizable) {
         win.styleMask &= ~NSWindowStyleMaskResizable;
 }
 
+bool addFrameCallback(CefRefPtr<CefBrowser>, std::function<bool()>) {
+    return false;  // no frame clock hooked up; Browser falls back to a timer
+}
+
+void forgetBrowser(CefRefPtr<CefBrowser>) {
+    // Nothing cached — the native handle comes straight from CEF.
+}
+
+NativeStyleStats nativeStyleStats() { return {}; }
+
 } // namespace bamboo::platform
@@ -3,6 +3,7 @@
 // Uses DWM APIs for Mica, Acrylic, transparency, and rounded corners.
 
 #include "bamboo/platform/StyleApplicator.hpp"
+#include "bamboo/Trace.hpp"
 #include "include/cef_browser.h"
 
 #if defined(_WIN32)
@@ -69,7 +70,9 @@ void extendFrameIntoClient(HWND hwnd) {
 
 } // namespace
 
-void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style) {
+void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style, StyleField changed) {
+    BAMBOO_TRACE_SCOPE("platform::applyStyle");
+    if (changed == StyleField::None) return;
     HWND hwnd = getHWND(browser);
     if (!hwnd) return;
 
@@ -77,33 +80,36 @@ void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style) {
     LONG winStyle = GetWindowLong(hwnd, GWL_STYLE);
 
     // ── Chrome mode ───────────────────────────────────────────────────────────
-    switch (style.chromeMode) {
-        case ChromeMode::Full:
-            // CEF chrome runtime handles this
-            break;
-
-        case ChromeMode::NativeTitlebar:
-            winStyle |= WS_CAPTION | WS_SYSMENU | WS_THICKFRAME;
-            break;
-
-        case ChromeMode::Frameless:
-            winStyle &= ~(WS_CAPTION | WS_THICKFRAME);
-            winStyle |= WS_POPUP;
-            if (style.resizable) winStyle |= WS_SIZEBOX;
-            break;
-
-        case ChromeMode::CustomTitlebar:
-            // Keep system controls but remove caption drawing
-            winStyle |= WS_CAPTION | WS_SYSMENU;
-            winStyle &= ~WS_THICKFRAME;
-            extendFrameIntoClient(hwnd);
-            break;
+    if (any(changed, StyleField::ChromeMode | StyleField::Resizable)) {
+        switch (style.chromeMode) {
+            case ChromeMode::Full:
+                // CEF chrome runtime handles this
+                break;
+
+            case ChromeMode::NativeTitlebar:
+                winStyle |= WS_CAPTION | WS_SYSMENU | WS_THICKFRAME;
+                break;
+
+            case ChromeMode::Frameless:
+                winStyle &= ~(WS_CAPTION | WS_THICKFRAME);
+                winStyle |= WS_POPUP;
+                if (style.resizable) winStyle |= WS_SIZEBOX;
+                break;
+
+            case ChromeMode::CustomTitlebar:
+                // Keep system controls but remove caption drawing
+                winStyle |= WS_CAPTION | WS_SYSMENU;
+                winStyle &= ~WS_THICKFRAME;
+                extendFrameIntoClient(hwnd);
+                break;
+        }
+
+        SetWindowLong(hwnd, GWL_STYLE, winStyle);
     }
 
-    SetWindowLong(hwnd, GWL_STYLE, winStyle);
-
     // ── Transparency / material ───────────────────────────────────────────────
-    if (style.transparent || style.backgroundOpacity < 1.0f) {
+    if (any(changed, StyleField::Transparency) &&
+        (style.transparent || style.backgroundOpacity < 1.0f)) {
         exStyle |= WS_EX_LAYERED;
         SetWindowLong(hwnd, GWL_EXSTYLE, exStyle);
         SetLayeredWindowAttributes(hwnd, 0,
@@ -112,40 +118,53 @@ void applyStyle(CefRefPtr<CefBrowser> browser, const WindowStyle& style) {
     }
 
     // ── Windows material (Mica / Acrylic) ─────────────────────────────────────
-    setWindowsMaterial(browser, style.windowsMaterial);
+    if (any(changed, StyleField::WindowsMaterial))
+        setWindowsMaterial(browser, style.windowsMaterial);
 
     // ── Always on top ─────────────────────────────────────────────────────────
-    SetWindowPos(hwnd,
-        style.alwaysOnTop ? HWND_TOPMOST : HWND_NOTOPMOST,
-        0, 0, 0, 0,
-        SWP_NOMOVE | SWP_NOSIZE | SWP_FRAMECHANGED);
+    if (any(changed, StyleField::AlwaysOnTop)) {
+        SetWindowPos(hwnd,
+            style.alwaysOnTop ? HWND_TOPMOST : HWND_NOTOPMOST,
+            0, 0, 0, 0,
+            SWP_NOMOVE | SWP_NOSIZE | SWP_FRAMECHANGED);
+    }
 
     // ── Corner radius ─────────────────────────────────────────────────────────
-    if (style.cornerRadius > 0) {
-        setCornerRadius(browser, style.cornerRadius);
-    } else {
-        setDWMAttribute(hwnd, DWMWA_WINDOW_CORNER_PREFERENCE, DWMWCP_DEFAULT);
+    if (any(changed, StyleField::CornerRadius)) {
+        if (style.cornerRadius > 0) {
+            setCornerRadius(browser, style.cornerRadius);
+        } else {
+            setDWMAttribute(hwnd, DWMWA_WINDOW_CORNER_PREFERENCE, DWMWCP_DEFAULT);
+        }
     }
 
     // ── Shadow ───────────────────────────────────────────────────────────────
-    setShadow(browser, style.shadow);
+    if (any(changed, StyleField::Shadow))
+        setShadow(browser, style.shadow);
 
     // ── Resize ───────────────────────────────────────────────────────────────
-    setResizable(browser, style.resizable);
+    if (any(changed, StyleField::Resizable))
+        setResizable(browser, style.resizable);
 
     // ── Taskbar visibility ────────────────────────────────────────────────────
-    if (style.skipTaskbar) {
-        exStyle |= WS_EX_TOOLWINDOW;
-        exStyle &= ~WS_EX_APPWINDOW;
-    } else {
-        exStyle &= ~WS_EX_TOOLWINDOW;
-        exStyle |= WS_EX_APPWINDOW;
+    if (any(changed, StyleField::SkipTaskbar)) {
+        exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
+        if (style.skipTaskbar) {
+            exStyle |= WS_EX_TOOLWINDOW;
+            exStyle &= ~WS_EX_APPWINDOW;
+        } else {
+            exStyle &= ~WS_EX_TOOLWINDOW;
+            exStyle |= WS_EX_APPWINDOW;
+        }
+        SetWindowLong(hwnd, GWL_EXSTYLE, exStyle);
     }
-    SetWindowLong(hwnd, GWL_EXSTYLE, exStyle);
 
-    // Flush style changes
-    SetWindowPos(hwnd, nullptr, 0, 0, 0, 0,
-        SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
+    // Flush style changes — only needed when GWL_STYLE / GWL_EXSTYLE changed.
+    if (any(changed, StyleField::ChromeMode | StyleField::Resizable |
+                     StyleField::Transparency | StyleField::SkipTaskbar)) {
+        SetWindowPos(hwnd, nullptr, 0, 0, 0, 0,
+            SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
+    }
 }
 
 void setDragRegions(CefRefPtr<CefBrowser> browser,
@@ -254,5 +273,15 @@ void setResizable(CefRefPtr<CefBrowser> browser, bool resizable) {
         SWP_NOMOVE|SWP_NOSIZE|SWP_NOZORDER|SWP_FRAMECHANGED);
 }
 
+bool addFrameCallback(CefRefPtr<CefBrowser>, std::function<bool()>) {
+    return false;  // no frame clock hooked up; Browser falls back to a timer
+}
+
+void forgetBrowser(CefRefPtr<CefBrowser>) {
+    // Nothing cached — the native handle comes straight from CEF.
+}
+
+NativeStyleStats nativeStyleStats() { return {}; }
+
 } // namespace bamboo::platform
 #endif // _WIN32
@@ -0,0 +1,88 @@
+#pragma once
+// bamboo/StyleDiff.hpp
+// Field-level comparison of two WindowStyles, so runtime style changes only
+// touch the native window properties (and page CSS) that actually changed.
+
+#include "bamboo/WindowStyle.hpp"
+#include <cstdint>
+
+namespace bamboo {
+
+/**
+ * @brief One bit per independently-applicable group of WindowStyle fields.
+ */
+enum class StyleField : uint32_t {
+    None            = 0,
+    ChromeMode      = 1u << 0,
+    Titlebar        = 1u << 1,
+    BackgroundColor = 1u << 2,
+    Transparency    = 1u << 3,   // transparent + backgroundOpacity
+    MacOSVibrancy   = 1u << 4,
+    WindowsMaterial = 1u << 5,
+    Shadow          = 1u << 6,
+    CornerRadius    = 1u << 7,
+    Resizable       = 1u << 8,
+    Minimizable     = 1u << 9,
+    Maximizable     = 1u << 10,
+    AlwaysOnTop     = 1u << 11,
+    SkipTaskbar     = 1u << 12,
+    Fullscreen      = 1u << 13,
+    DragRegions     = 1u << 14,
+    Scrollbar       = 1u << 15,
+    ContextMenu     = 1u << 16,
+    DevTools        = 1u << 17,
+    Zoom            = 1u << 18,
+    TextSelection   = 1u << 19,
+    All             = 0xFFFFFFFFu,
+};
+
+[[nodiscard]] constexpr StyleField operator|(StyleField a, StyleField b) {
+    return static_cast<StyleField>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+[[nodiscard]] constexpr StyleField operator&(StyleField a, StyleField b) {
+    return static_cast<StyleField>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+}
+constexpr StyleField& operator|=(StyleField& a, StyleField b) { return a = a | b; }
+
+/** True if any of the bits in `fields` are set in `set`. */
+[[nodiscard]] constexpr bool any(StyleField set, StyleField fields) {
+    return (set & fields) != StyleField::None;
+}
+
+/** Fields that feed buildBridgeCSS(); changing anything else needs no CSS push. */
+inline constexpr StyleField kCSSFields = StyleField::Scrollbar | StyleField::TextSelection;
+
+/**
+ * @brief Which field groups differ between `from` and `to`.
+ */
+[[nodiscard]] inline StyleField diffStyle(const WindowStyle& from, const WindowStyle& to) {
+    StyleField d = StyleField::None;
+    auto mark = [&](bool changed, StyleField f) { if (changed) d |= f; };
+
+    mark(from.chromeMode      != to.chromeMode,      StyleField::ChromeMode);
+    mark(from.titlebar        != to.titlebar,        StyleField::Titlebar);
+    mark(from.backgroundColor != to.backgroundColor, StyleField::BackgroundColor);
+    mark(from.transparent       != to.transparent ||
+         from.backgroundOpacity != to.backgroundOpacity, StyleField::Transparency);
+    mark(from.macosVibrancy   != to.macosVibrancy,   StyleField::MacOSVibrancy);
+    mark(from.windowsMaterial != to.windowsMaterial, StyleField::WindowsMaterial);
+    mark(from.shadow          != to.shadow,          StyleField::Shadow);
+    mark(from.cornerRadius    != to.cornerRadius,    StyleField::CornerRadius);
+    mark(from.resizable       != to.resizable,       StyleField::Resizable);
+    mark(from.minimizable     != to.minimizable,     StyleField::Minimizable);
+    mark(from.maximizable     != to.maximizable,     StyleField::Maximizable);
+    mark(from.alwaysOnTop     != to.alwaysOnTop,     StyleField::AlwaysOnTop);
+    mark(from.skipTaskbar     != to.skipTaskbar,     StyleField::SkipTaskbar);
+    mark(from.fullscreen      != to.fullscreen,      StyleField::Fullscreen);
+    mark(from.dragRegions     != to.dragRegions,     StyleField::DragRegions);
+    mark(from.scrollbar       != to.scrollbar,       StyleField::Scrollbar);
+    mark(from.contextMenu     != to.contextMenu,     StyleField::ContextMenu);
+    mark(from.devTools          != to.devTools ||
+         from.devToolsDocked    != to.devToolsDocked, StyleField::DevTools);
+    mark(from.zoomFactor      != to.zoomFactor ||
+         from.allowZoom       != to.allowZoom,       StyleField::Zoom);
+    mark(from.allowTextSelection != to.allowTextSelection, StyleField::TextSelection);
+    return d;
+}
+
+} // namespace bamboo
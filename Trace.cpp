@@ -0,0 +1,106 @@
+// bamboo/Trace.cpp - see include/bamboo/Trace.hpp for API docs
+#include "bamboo/Trace.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <mutex>
+#include <utility>
+
+#if defined(_WIN32)
+  #include <windows.h>
+#elif defined(__APPLE__)
+  #include <pthread.h>
+#else
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace bamboo::trace {
+
+namespace {
+
+// Enough for a long interactive session; beyond it spans are dropped rather
+// than letting a forgotten trace grow without bound.
+constexpr size_t kMaxSpans = size_t{1} << 20;
+
+struct Recorder {
+    std::mutex             mutex;
+    std::vector<TraceSpan> spans;
+};
+
+Recorder& recorder() {
+    static Recorder r;
+    return r;
+}
+
+} // namespace
+
+uint64_t nowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t currentThreadId() {
+    thread_local const uint64_t id = [] {
+#if defined(_WIN32)
+        return static_cast<uint64_t>(GetCurrentThreadId());
+#elif defined(__APPLE__)
+        return static_cast<uint64_t>(pthread_mach_thread_np(pthread_self()));
+#else
+        return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+    }();
+    return id;
+}
+
+void startRecording() {
+    auto& r = recorder();
+    std::lock_guard lock(r.mutex);
+    r.spans.clear();
+    detail::recording.store(true, std::memory_order_relaxed);
+}
+
+std::vector<TraceSpan> stopRecording() {
+    auto& r = recorder();
+    std::lock_guard lock(r.mutex);
+    detail::recording.store(false, std::memory_order_relaxed);
+    return std::exchange(r.spans, {});
+}
+
+void record(const char* name, const char* category, uint64_t startUs, uint64_t endUs) {
+    if (!recording()) return;
+    const uint64_t tid = currentThreadId();
+    auto& r = recorder();
+    std::lock_guard lock(r.mutex);
+    if (r.spans.size() >= kMaxSpans) return;
+    r.spans.push_back({ name, category, startUs, endUs - startUs, tid });
+}
+
+std::expected<std::string, TraceError>
+mergeChromeTrace(std::string_view chromeJson, const std::vector<TraceSpan>& spans,
+                 int64_t clockOffsetUs, int64_t pid) {
+    json doc = chromeJson.empty() ? json::object() : json::parse(chromeJson, nullptr, false);
+    if (doc.is_discarded()) return std::unexpected(TraceError::ParseFailed);
+    if (doc.is_array()) doc = json{ {"traceEvents", std::move(doc)} };
+    if (!doc.is_object()) return std::unexpected(TraceError::ParseFailed);
+
+    auto& events = doc["traceEvents"];
+    if (events.is_null()) events = json::array();
+    if (!events.is_array()) return std::unexpected(TraceError::ParseFailed);
+
+    for (const auto& s : spans) {
+        events.push_back({
+            {"name", s.name},
+            {"cat",  s.category},
+            {"ph",   "X"},
+            {"ts",   static_cast<int64_t>(s.startUs) + clockOffsetUs},
+            {"dur",  s.durationUs},
+            {"pid",  pid},
+            {"tid",  s.threadId},
+        });
+    }
+    return doc.dump();
+}
+
+} // namespace bamboo::trace
@@ -0,0 +1,126 @@
+#pragma once
+// bamboo/Trace.hpp
+// Scoped timing spans for Bamboo (and user) code, written into the same
+// Chrome trace file as CEF/Chromium's own events. See App::startTracing().
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bamboo {
+
+// ─── Error codes ──────────────────────────────────────────────────────────────
+
+enum class TraceError {
+    AlreadyTracing,
+    NotTracing,
+    BeginFailed,    // CefBeginTracing refused
+    EndFailed,      // CefEndTracing refused
+    ReadFailed,     // Chromium's trace file could not be read
+    ParseFailed,    // …or was not Chrome trace JSON
+    WriteFailed,
+};
+
+// ─── Span recorder ────────────────────────────────────────────────────────────
+
+struct TraceSpan {
+    const char* name;      // string literal / static storage only
+    const char* category;
+    uint64_t    startUs;   // trace::nowUs() clock
+    uint64_t    durationUs;
+    uint64_t    threadId;  // OS thread id, matches Chromium's "tid"
+};
+
+namespace trace {
+
+namespace detail {
+inline std::atomic<bool> recording{false};
+}
+
+/** True while spans are being collected. Cheap enough for every scope. */
+[[nodiscard]] inline bool recording() {
+    return detail::recording.load(std::memory_order_relaxed);
+}
+
+/** Monotonic microseconds; the clock TraceSpan::startUs is measured on. */
+[[nodiscard]] uint64_t nowUs();
+
+/** OS id of the calling thread (cached per thread). */
+[[nodiscard]] uint64_t currentThreadId();
+
+/**
+ * @brief Start collecting Bamboo spans, without Chromium tracing.
+ *
+ * App::startTracing() calls this too. Call it yourself before App::create()
+ * to capture startup; the spans end up in the file from App::stopTracing().
+ */
+void startRecording();
+
+/** Stop collecting and hand back everything recorded (thread-safe). */
+[[nodiscard]] std::vector<TraceSpan> stopRecording();
+
+/** Append one finished span. No-op unless recording(). Thread-safe. */
+void record(const char* name, const char* category, uint64_t startUs, uint64_t endUs);
+
+/**
+ * @brief Add Bamboo spans to a Chrome trace JSON document.
+ *
+ * `chromeJson` is what CefEndTracing wrote (object with "traceEvents", or a
+ * bare event array). `clockOffsetUs` maps nowUs() onto Chromium's trace clock
+ * (CefNowFromSystemTraceTime() − nowUs(), sampled once). Spans become complete
+ * ("X") events of process `pid`, so they share rows with Chromium's threads.
+ */
+[[nodiscard]] std::expected<std::string, TraceError>
+mergeChromeTrace(std::string_view chromeJson, const std::vector<TraceSpan>& spans,
+                 int64_t clockOffsetUs, int64_t pid);
+
+} // namespace trace
+
+/**
+ * @brief RAII span: times the enclosing scope while recording is on.
+ *
+ * Prefer the macros below, which compile to nothing unless Bamboo is built
+ * with -DBAMBOO_ENABLE_TRACING=ON.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, const char* category = "bamboo")
+        : name_(name), category_(category),
+          startUs_(trace::recording() ? trace::nowUs() : 0) {}
+
+    ~TraceScope() {
+        if (startUs_) trace::record(name_, category_, startUs_, trace::nowUs());
+    }
+
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    uint64_t    startUs_;
+};
+
+} // namespace bamboo
+
+// ─── Macros ───────────────────────────────────────────────────────────────────
+//   BAMBOO_TRACE_SCOPE("MyApp::loadProject");
+//   BAMBOO_TRACE_SCOPE_CAT("Decoder::frame", "media");
+//   BAMBOO_TRACE_FUNCTION();
+
+#define BAMBOO_TRACE_CONCAT_(a, b) a##b
+#define BAMBOO_TRACE_CONCAT(a, b)  BAMBOO_TRACE_CONCAT_(a, b)
+
+#if defined(BAMBOO_ENABLE_TRACING) && BAMBOO_ENABLE_TRACING
+  #define BAMBOO_TRACE_SCOPE_CAT(name, category) \
+      ::bamboo::TraceScope BAMBOO_TRACE_CONCAT(bambooTraceScope_, __LINE__)(name, category)
+  #define BAMBOO_TRACE_SCOPE(name) BAMBOO_TRACE_SCOPE_CAT(name, "bamboo")
+  #define BAMBOO_TRACE_FUNCTION()  BAMBOO_TRACE_SCOPE(__func__)
+#else
+  #define BAMBOO_TRACE_SCOPE_CAT(name, category) static_cast<void>(0)
+  #define BAMBOO_TRACE_SCOPE(name)               static_cast<void>(0)
+  #define BAMBOO_TRACE_FUNCTION()                static_cast<void>(0)
+#endif
@@ -0,0 +1,285 @@
+// bamboo/Watchdog.cpp - see include/bamboo/Watchdog.hpp for API docs
+#include "bamboo/Watchdog.hpp"
+#include "bamboo/Log.hpp"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <optional>
+
+#if defined(__linux__)
+  #include <cerrno>
+  #include <cstdlib>
+  #include <cxxabi.h>
+  #include <execinfo.h>
+  #include <pthread.h>
+#endif
+
+namespace bamboo {
+
+namespace {
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Task {
+    const char* kind;
+    std::string name;
+    const char* file;
+    int         line;
+    int64_t     startNs;
+    bool        reported;
+};
+
+// Process-wide: TaskScopes find it without a pointer, and a late heartbeat
+// task can still touch it after the watchdog is gone.
+struct State {
+    std::atomic<uint64_t> generation{0};    // non-zero while a watchdog runs
+    std::atomic<int64_t>  thresholdNs{0};
+
+    std::mutex              mutex;          // guards everything below
+    std::condition_variable wake;
+    bool                    stop = false;
+    std::vector<Task>       tasks;          // the UI thread's open scopes, outermost first
+    int64_t                 pingPostedNs = 0;   // 0 = no heartbeat in flight
+    bool                    pingReported = false;
+    bool                    stallSincePing = false;
+    WatchdogStats           stats;
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+void recordStall(State& s, std::string site, uint64_t us, bool untracked) {
+    ++s.stats.stalls;
+    if (untracked) ++s.stats.untracked;
+    if (us > s.stats.durationUs.max()) s.stats.worstSite = std::move(site);
+    s.stats.durationUs.record(us);
+}
+
+void heartbeat() {
+    auto& s = state();
+    std::lock_guard lock(s.mutex);
+    if (s.pingPostedNs == 0) return;
+    const int64_t late = nowNs() - s.pingPostedNs;
+    // A tracked stall already accounts for the delay.
+    if (late >= s.thresholdNs.load(std::memory_order_relaxed) && !s.stallSincePing)
+        recordStall(s, "untracked", static_cast<uint64_t>(late / 1000), true);
+    s.pingPostedNs   = 0;
+    s.pingReported   = false;
+    s.stallSincePing = false;
+}
+
+void logStall(const StallReport& r) {
+    std::string where = r.file.empty() ? r.name : std::format("{} ({}:{})", r.name, r.file, r.line);
+    std::string stack;
+    for (const auto& frame : r.stack) stack += std::format("\n    at {}", frame);
+    BAMBOO_LOG_WARN("UI thread stalled for {} ms in {} {}{}", r.running.count(), r.kind, where, stack);
+}
+
+// ─── Stack sampling (Linux) ───────────────────────────────────────────────────
+
+#if defined(__linux__)
+// A sample is a generation: the watchdog thread bumps gRequested and the
+// handler fills gFrames only while that generation is outstanding, then
+// publishes it in gCompleted. A handler that runs after its sample timed
+// out therefore still finishes before the next sample may start, and a
+// stray signal with nothing requested writes nothing.
+constexpr int         kMaxFrames = 64;
+void*                 gFrames[kMaxFrames];
+int                   gFrameCount = 0;
+std::atomic<uint32_t> gRequested{0};   // written by the sampling thread only
+std::atomic<uint32_t> gCompleted{0};   // written by the handler only
+pthread_t             gUIThread;
+
+void onStackSignal(int) {
+    const int saved = errno;
+    const uint32_t gen = gRequested.load(std::memory_order_acquire);
+    if (gen != gCompleted.load(std::memory_order_relaxed)) {
+        gFrameCount = ::backtrace(gFrames, kMaxFrames);
+        gCompleted.store(gen, std::memory_order_release);
+    }
+    errno = saved;
+}
+
+bool awaitCompleted(uint32_t gen) {
+    for (int i = 0; i < 100; ++i) {
+        if (gCompleted.load(std::memory_order_acquire) == gen) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return gCompleted.load(std::memory_order_acquire) == gen;
+}
+
+// "libapp.so(_ZN3foo3barEv+0x1c) [0x7f…]" → "libapp.so(foo::bar()+0x1c) [0x7f…]"
+std::string demangleFrame(std::string_view frame) {
+    const size_t open = frame.find('('), plus = frame.find('+', open);
+    if (open == frame.npos || plus == frame.npos || plus == open + 1) return std::string(frame);
+    const std::string mangled(frame.substr(open + 1, plus - open - 1));
+    int status = 0;
+    char* name = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status != 0 || !name) return std::string(frame);
+    std::string out = std::format("{}{}{}", frame.substr(0, open + 1), name, frame.substr(plus));
+    std::free(name);
+    return out;
+}
+
+std::vector<std::string> sampleUIStack(int sig) {
+    // The previous sample's handler may still be writing gFrames; until it
+    // is done there is no stack to take.
+    const uint32_t previous = gRequested.load(std::memory_order_relaxed);
+    if (!awaitCompleted(previous)) return {};
+    const uint32_t gen = previous + 1;
+    gRequested.store(gen, std::memory_order_release);
+    if (::pthread_kill(gUIThread, sig) != 0 || !awaitCompleted(gen)) return {};
+    const int n = gFrameCount;
+    if (n <= 2) return {};
+    char** symbols = ::backtrace_symbols(gFrames, n);
+    if (!symbols) return {};
+    std::vector<std::string> out;
+    for (int i = 2; i < n; ++i) out.push_back(demangleFrame(symbols[i]));  // skip handler + trampoline
+    std::free(symbols);
+    return out;
+}
+
+bool installStackSignal(int sig) {
+    void* warm[1];
+    ::backtrace(warm, 1);  // loads libgcc now, not inside the handler
+    gUIThread = ::pthread_self();
+    struct sigaction sa {};
+    sa.sa_handler = onStackSignal;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    return ::sigaction(sig, &sa, nullptr) == 0;
+}
+#endif
+
+} // namespace
+
+// ─── Watchdog ─────────────────────────────────────────────────────────────────
+
+std::expected<std::unique_ptr<UIWatchdog>, WatchdogError>
+UIWatchdog::create(WatchdogConfig config) {
+    if (!CefCurrentlyOn(TID_UI)) return std::unexpected(WatchdogError::NotUIThread);
+    auto& s = state();
+    if (s.generation.load() != 0) return std::unexpected(WatchdogError::AlreadyRunning);
+
+    auto dog = std::unique_ptr<UIWatchdog>(new UIWatchdog(std::move(config)));
+#if defined(__linux__)
+    if (dog->config_.stackSignal && !installStackSignal(dog->config_.stackSignal)) {
+        BAMBOO_LOG_WARN("Watchdog: cannot handle signal {}; stalls are reported without stacks",
+                        dog->config_.stackSignal);
+        dog->config_.stackSignal = 0;
+    }
+#endif
+    {
+        std::lock_guard lock(s.mutex);
+        static uint64_t generations = 0;
+        s.stop = false;
+        s.tasks.clear();
+        s.pingPostedNs = 0;
+        s.pingReported = s.stallSincePing = false;
+        s.stats = {};
+        s.thresholdNs = std::chrono::nanoseconds(dog->config_.threshold).count();
+        s.generation  = ++generations;
+    }
+    dog->thread_ = std::thread([d = dog.get()] { d->run(); });
+    return dog;
+}
+
+UIWatchdog::~UIWatchdog() {
+    auto& s = state();
+    {
+        std::lock_guard lock(s.mutex);
+        s.stop = true;
+        s.generation = 0;
+        s.tasks.clear();
+    }
+    s.wake.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+WatchdogStats UIWatchdog::stats() const {
+    auto& s = state();
+    std::lock_guard lock(s.mutex);
+    return s.stats;
+}
+
+void UIWatchdog::run() {
+    auto& s = state();
+    const int64_t threshold = s.thresholdNs.load();
+    const auto tick = std::max<std::chrono::milliseconds>(config_.threshold / 4, std::chrono::milliseconds(5));
+
+    std::unique_lock lock(s.mutex);
+    while (!s.wake.wait_for(lock, tick, [&] { return s.stop; })) {
+        const int64_t now = nowNs();
+        std::optional<StallReport> report;
+        bool postPing = false;
+
+        if (!s.tasks.empty()) {
+            // Timed from the outermost scope, attributed to the innermost.
+            Task& outer = s.tasks.front();
+            const Task& inner = s.tasks.back();
+            if (!outer.reported && now - outer.startNs >= threshold) {
+                outer.reported = true;
+                report = StallReport{ inner.kind, inner.name, inner.file, inner.line,
+                                      std::chrono::milliseconds((now - outer.startNs) / 1'000'000), {} };
+            }
+        } else if (s.pingPostedNs == 0) {
+            s.pingPostedNs = now;
+            postPing = true;
+        } else if (!s.pingReported && now - s.pingPostedNs >= threshold) {
+            s.pingReported = true;
+            report = StallReport{ "untracked", "heartbeat delayed", {}, 0,
+                                  std::chrono::milliseconds((now - s.pingPostedNs) / 1'000'000), {} };
+        }
+
+        lock.unlock();
+        if (postPing) CefPostTask(TID_UI, CefCreateClosureTask(&heartbeat));
+        if (report) {
+#if defined(__linux__)
+            if (config_.stackSignal) report->stack = sampleUIStack(config_.stackSignal);
+#endif
+            config_.onStall ? config_.onStall(*report) : logStall(*report);
+        }
+        lock.lock();
+    }
+}
+
+// ─── Task scopes ──────────────────────────────────────────────────────────────
+
+namespace watchdog {
+
+TaskScope::TaskScope(const char* kind, std::string_view name, std::source_location where)
+    : generation_(state().generation.load(std::memory_order_relaxed)) {
+    if (!generation_) return;
+    auto& s = state();
+    std::lock_guard lock(s.mutex);
+    s.tasks.push_back({ kind, std::string(name), where.file_name(), static_cast<int>(where.line()),
+                        nowNs(), false });
+}
+
+TaskScope::~TaskScope() {
+    if (!generation_) return;
+    auto& s = state();
+    std::lock_guard lock(s.mutex);
+    if (s.generation.load(std::memory_order_relaxed) != generation_ || s.tasks.empty()) return;
+    Task t = std::move(s.tasks.back());
+    s.tasks.pop_back();
+    // Nested scopes are part of their parent's stall; count the outermost.
+    const int64_t ns = nowNs() - t.startNs;
+    if (s.tasks.empty() && ns >= s.thresholdNs.load(std::memory_order_relaxed)) {
+        recordStall(s, std::format("{}:{}", t.kind, t.name), static_cast<uint64_t>(ns / 1000), false);
+        s.stallSincePing = true;
+    }
+}
+
+} // namespace watchdog
+
+} // namespace bamboo
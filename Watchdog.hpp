@@ -0,0 +1,111 @@
+#pragma once
+// bamboo/Watchdog.hpp
+// UI-thread stall detection with task provenance and stack samples.
+
+#include "bamboo/Histogram.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace bamboo {
+
+enum class WatchdogError {
+    AlreadyRunning,     // one watchdog per process
+    NotUIThread,
+};
+
+struct StallReport {
+    std::string               kind;       // "task" (postUITask), "bridge", "call", or "untracked"
+    std::string               name;       // posting function, bridge event or bound function name
+    std::string               file;       // posting site, for "task"
+    int                       line = 0;
+    std::chrono::milliseconds running{0}; // at detection; the task may still be running
+    std::vector<std::string>  stack;      // UI thread at detection, innermost first (Linux)
+};
+
+struct WatchdogStats {
+    uint64_t    stalls    = 0;     // tasks (or untracked gaps) over the threshold
+    uint64_t    untracked = 0;     // of those, outside any Bamboo task: Chromium work, native code
+    Histogram   durationUs;        // full duration of each stall
+    std::string worstSite;         // kind:name of the longest stall
+};
+
+struct WatchdogConfig {
+    std::chrono::milliseconds threshold{250};
+    /** Runs on the watchdog thread while the UI thread is still stuck. Default: log a warning. */
+    std::function<void(const StallReport&)> onStall;
+#if defined(__linux__)
+    int stackSignal = SIGURG;      // sent to the UI thread for a stack sample; 0 = no stacks
+#else
+    int stackSignal = 0;           // stack samples are Linux only
+#endif
+};
+
+/**
+ * @brief Detects UI-thread work that runs longer than a threshold.
+ *
+ * Bamboo marks the UI-thread work it starts with a watchdog::TaskScope:
+ * App::postUITask tasks carry their posting site (std::source_location),
+ * bridge messages their event and bound calls their function name. A
+ * watchdog thread checks the innermost running scope every threshold/4.
+ * It also posts a heartbeat task, so stalls in code Bamboo does not see
+ * (Chromium, native dialogs) are reported as "untracked". Each stall is
+ * reported once, while it is still happening, with a stack sample of the
+ * UI thread on Linux; its full duration is counted in stats() when it ends.
+ *
+ * Without a watchdog a TaskScope costs one relaxed atomic load. Create on
+ * the UI thread; stops when destroyed.
+ *
+ * Example:
+ *   auto dog = bamboo::UIWatchdog::create({ .threshold = std::chrono::milliseconds(100) }).value();
+ *   ...
+ *   auto s = dog->stats();   // s.stalls, s.durationUs.percentile(0.99)
+ */
+class UIWatchdog {
+public:
+    [[nodiscard]]
+    static std::expected<std::unique_ptr<UIWatchdog>, WatchdogError>
+    create(WatchdogConfig config = {});
+
+    ~UIWatchdog();
+
+    UIWatchdog(const UIWatchdog&)            = delete;
+    UIWatchdog& operator=(const UIWatchdog&) = delete;
+
+    /** Any thread. */
+    [[nodiscard]] WatchdogStats stats() const;
+
+private:
+    explicit UIWatchdog(WatchdogConfig config) : config_(std::move(config)) {}
+    void run();
+
+    WatchdogConfig config_;
+    std::thread    thread_;
+};
+
+namespace watchdog {
+
+/** Marks the UI-thread work it spans for the watchdog. Nests; UI thread only. */
+class TaskScope {
+public:
+    TaskScope(const char* kind, std::string_view name, std::source_location where = {});
+    ~TaskScope();
+
+    TaskScope(const TaskScope&)            = delete;
+    TaskScope& operator=(const TaskScope&) = delete;
+
+private:
+    uint64_t generation_;   // of the watchdog it was opened under; 0 = none
+};
+
+} // namespace watchdog
+
+} // namespace bamboo
@@ -41,6 +41,8 @@ struct Color {
     static constexpr Color transparent() { return {0, 0, 0, 0}; }
     static constexpr Color white()       { return {255, 255, 255, 255}; }
     static constexpr Color black()       { return {0, 0, 0, 255}; }
+
+    constexpr bool operator==(const Color&) const = default;
 };
 
 // ─── Chrome UI Mode ───────────────────────────────────────────────────────────
@@ -105,6 +107,8 @@ enum class WindowsMaterial {
 struct DragRegion {
     int  x, y, width, height;
     bool isDraggable = true;  // false = a no-drag "hole" punched inside a drag rect
+
+    bool operator==(const DragRegion&) const = default;
 };
 
 // ─── Window shadow ────────────────────────────────────────────────────────────
@@ -116,6 +120,8 @@ struct Shadow {
     int   spread  = 0;
     int   offsetX = 0;
     int   offsetY = 4;
+
+    bool operator==(const Shadow&) const = default;
 };
 
 // ─── Traffic light / titlebar button position (macOS) ────────────────────────
@@ -123,6 +129,8 @@ struct Shadow {
 struct TitlebarButtonPosition {
     int x = 20;  // pixels from left edge
     int y = 20;  // pixels from top edge
+
+    bool operator==(const TitlebarButtonPosition&) const = default;
 };
 
 // ─── Context menu style ───────────────────────────────────────────────────────
@@ -136,9 +144,12 @@ enum class ContextMenuStyle {
 // ─── Scrollbar style ──────────────────────────────────────────────────────────
 
 enum class ScrollbarStyle {
-    Default,  // OS default
-    Hidden,   // Always hidden
-    Overlay,  // Thin overlay scrollbar (macOS style)
+    Default,        // OS default
+    Hidden,         // Always hidden
+    Overlay,        // Thin overlay scrollbar (macOS style), drawn with ::-webkit-scrollbar CSS
+    NativeOverlay,  // Chromium's own composited overlay scrollbars — no CSS injected.
+                    // Needs AppConfig::nativeOverlayScrollbars (a process-wide switch);
+                    // without it this behaves like Default.
 };
 
 // ─── Fullscreen behaviour ─────────────────────────────────────────────────────
@@ -168,6 +179,8 @@ struct TitlebarStyle {
     // the window controls but your HTML canvas fills the entire frame.
     bool                                  macosHidden        = false;
     std::optional<TitlebarButtonPosition> macosButtonPosition;
+
+    bool operator==(const TitlebarStyle&) const = default;
 };
 
 // ─── Main window style config ─────────────────────────────────────────────────
@@ -0,0 +1,105 @@
+// bench/bamboo_bench.cpp — microbenchmarks for the JS bridge's browser-side hot paths
+//
+// Usage: bamboo_bench [--filter=<substring>] [--samples=30] [--min-batch-ms=5] [--out=<file>]
+//
+// Needs no display and never starts CEF: codec functions are called directly
+// and message dispatch runs against Browser::createDetached(), where script
+// execution is a no-op. Compare runs before and after a bridge change:
+//   bamboo_bench --out=before.json   (change, rebuild)
+//   bamboo_bench --out=after.json
+
+#include "bench_harness.hpp"
+#include "bamboo/Browser.hpp"
+#include "bamboo/BridgeCodec.hpp"
+#include <nlohmann/json.hpp>
+#include <format>
+#include <string>
+
+using bamboo::bench::doNotOptimize;
+using json = nlohmann::json;
+
+namespace {
+
+void codecBenchmarks(bamboo::bench::Runner& r) {
+    const json number = 3.25, text = "hello from the page", object = json::parse(R"({"a":1})");
+    r.run("codec/jsonToJsValue/number", [&] { doNotOptimize(bamboo::bridge::jsonToJsValue(number)); });
+    r.run("codec/jsonToJsValue/string", [&] { doNotOptimize(bamboo::bridge::jsonToJsValue(text)); });
+    r.run("codec/jsonToJsValue/object", [&] { doNotOptimize(bamboo::bridge::jsonToJsValue(object)); });
+
+    const bamboo::JsValue vNumber = 3.25, vText = std::string("result text");
+    r.run("codec/jsValueToJson/number", [&] { doNotOptimize(bamboo::bridge::jsValueToJson(vNumber)); });
+    r.run("codec/jsValueToJson/string", [&] { doNotOptimize(bamboo::bridge::jsValueToJson(vText)); });
+
+    bamboo::WindowStyle style;
+    style.scrollbar          = bamboo::ScrollbarStyle::Overlay;
+    style.allowTextSelection = false;
+    r.run("codec/buildBridgeCSS", [&] { doNotOptimize(bamboo::bridge::buildBridgeCSS(style)); });
+    const std::string css = bamboo::bridge::buildBridgeCSS(style);
+    r.run("codec/hashCSS", [&] { doNotOptimize(bamboo::bridge::hashCSS(css)); });
+
+    const std::string small = R"({"id":7,"ok":true})";
+    const std::string large = json{ {"rows", std::vector<int>(1000, 42)} }.dump();  // ~4 KiB
+    r.run("script/dispatch/small", [&] { doNotOptimize(bamboo::bridge::dispatchScript("update", small)); });
+    r.run("script/dispatch/4KiB",  [&] { doNotOptimize(bamboo::bridge::dispatchScript("update", large)); });
+    r.run("script/eval", [&] {
+        doNotOptimize(bamboo::bridge::evalScript("document.title", 42));
+    });
+    r.run("script/resolveCall", [&] {
+        doNotOptimize(bamboo::bridge::resolveCallScript("c17", vText));
+    });
+
+    const std::string sendRequest = R"({"type":"message","event":"update","data":{"id":7,"ok":true}})";
+    const std::string callRequest = R"({"type":"call","name":"add","args":[1,2,3],"id":"c1"})";
+    r.run("codec/routeRequest/message", [&] { doNotOptimize(bamboo::bridge::routeRequest(sendRequest)); });
+    r.run("codec/routeRequest/call",    [&] { doNotOptimize(bamboo::bridge::routeRequest(callRequest)); });
+}
+
+void browserBenchmarks(bamboo::bench::Runner& r) {
+    auto win = bamboo::Browser::createDetached();
+    win->onMessage([](std::string_view, std::string_view data) { doNotOptimize(data.size()); });
+    win->onJank([](const bamboo::JankReport& rep) { doNotOptimize(rep.cls); });
+    win->bindFunction("add", [](std::vector<bamboo::JsValue> args) -> bamboo::JsValue {
+        double sum = 0;
+        for (const auto& a : args) if (auto* d = std::get_if<double>(&a)) sum += *d;
+        return sum;
+    });
+
+    const std::string payload = R"({"id":7,"ok":true})";
+    r.run("browser/sendMessage", [&] { win->sendMessage("update", payload); });
+
+    // evalJS registers a pending callback; the matching __evalResult settles it.
+    // Ids are issued sequentially from 0 on a fresh window.
+    int nextId = 0;
+    r.run("browser/evalJS+__evalResult", [&] {
+        win->evalJS("document.title", [](auto v) { doNotOptimize(v.has_value()); });
+        win->fireMessage("__evalResult", std::format(R"({{"id":{},"value":"t","error":null}})", nextId++));
+    });
+
+    auto dispatch = [&](std::string name, std::string_view event, std::string data) {
+        r.run("dispatch/" + name, [&, event, data = std::move(data)] { win->fireMessage(event, data); });
+    };
+    dispatch("user",          "update", payload);
+    dispatch("__call",        "__call", R"({"name":"add","id":"c1","args":[1,2,3]})");
+    dispatch("__call+rtt",    "__call", R"({"name":"add","id":"c1","args":[1,2],"rtt":[0.4,0.6,0.5,0.7]})");
+    dispatch("__call/unknown","__call", R"({"name":"missing","id":"c1","args":[]})");
+    dispatch("__setStyle",    "__setStyle", R"({"cornerRadius":12,"alwaysOnTop":false})");
+    dispatch("__animateStyle","__animateStyle", R"({"style":{"cornerRadius":8},"duration":0})");
+    dispatch("__setDragRegions", "__setDragRegions",
+             R"([{"x":0,"y":0,"width":800,"height":32},{"x":0,"y":32,"width":40,"height":400}])");
+    dispatch("__windowOp",    "__windowOp", R"({"op":"zoom","value":1.25})");
+    dispatch("__jank",        "__jank",
+             R"({"url":"app://main","intervalMs":5000,"longTasks":{"count":3,"totalMs":240,"maxMs":120,)"
+             R"("blockingMs":90},"longFrames":{"count":2,"totalMs":180,"maxMs":110,"blockingMs":70},)"
+             R"("worstScript":"app.js:render","layoutShifts":1,"layoutShiftScore":0.02,"cls":0.05})");
+
+    r.run("browser/bridgeStats.toJson", [&] { doNotOptimize(win->bridgeStats().toJson()); });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bamboo::bench::Runner runner("bamboo_bench", argc, argv);
+    codecBenchmarks(runner);
+    browserBenchmarks(runner);
+    return runner.finish();
+}
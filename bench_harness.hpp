@@ -0,0 +1,132 @@
+#pragma once
+// bench/bench_harness.hpp — minimal in-tree microbenchmark harness
+//
+// A benchmark is a callable run in timed batches. The batch size is doubled
+// until one batch takes at least --min-batch-ms; after a warm-up batch, each
+// of --samples batches contributes one sample (mean ns per call). The report
+// is one JSON document on stdout (or --out=<file>):
+//
+//   {"benchmark":"bamboo_bench","metrics":{
+//     "codec/jsonToJsValue/string":{"unit":"ns","lowerIsBetter":true,"samples":[41.2,…]}}}
+//
+// Every sample is kept, so two reports can be compared statistically rather
+// than by a single mean. Progress goes to stderr.
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bamboo::bench {
+
+/** Keeps `value` (and the work that produced it) from being optimized away. */
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    static const void* volatile sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+struct Metric {
+    std::string         unit = "ns";
+    bool                lowerIsBetter = true;
+    std::vector<double> samples;
+};
+
+struct Options {
+    std::string filter;          // run only names containing this
+    std::string out;             // "" = stdout
+    int         samples    = 30;
+    double      minBatchMs = 5;
+};
+
+class Runner {
+public:
+    /** Accepts --filter=<s> --samples=<n> --min-batch-ms=<n> --out=<file>; unknown flags are left alone. */
+    Runner(std::string benchmark, int argc, char* argv[]) : benchmark_(std::move(benchmark)) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view a = argv[i];
+            if      (a.starts_with("--filter="))       opt_.filter = a.substr(9);
+            else if (a.starts_with("--out="))          opt_.out    = a.substr(6);
+            else if (a.starts_with("--samples="))      parse(a.substr(10), opt_.samples);
+            else if (a.starts_with("--min-batch-ms=")) parse(a.substr(15), opt_.minBatchMs);
+        }
+        opt_.samples = std::max(opt_.samples, 1);
+    }
+
+    [[nodiscard]] const Options& options() const { return opt_; }
+    [[nodiscard]] bool selected(std::string_view name) const {
+        return opt_.filter.empty() || name.find(opt_.filter) != std::string_view::npos;
+    }
+
+    /** Time `op()` and record ns per call under `name`. */
+    template <class F>
+    void run(std::string_view name, F&& op) {
+        if (!selected(name)) return;
+        using clock = std::chrono::steady_clock;
+        auto batch = [&](uint64_t n) {
+            const auto t0 = clock::now();
+            for (uint64_t i = 0; i < n; ++i) op();
+            return std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        };
+
+        uint64_t iters = 1;
+        while (batch(iters) < opt_.minBatchMs * 1e6 && iters < (uint64_t(1) << 40)) iters *= 2;
+        batch(iters);  // warm-up at the final size
+
+        Metric m;
+        m.samples.reserve(static_cast<size_t>(opt_.samples));
+        for (int s = 0; s < opt_.samples; ++s)
+            m.samples.push_back(batch(iters) / static_cast<double>(iters));
+        add(std::string(name), std::move(m));
+    }
+
+    /** Record samples measured elsewhere (end-to-end benchmarks). */
+    void add(std::string name, Metric m) {
+        if (!m.samples.empty()) {
+            auto sorted = m.samples;
+            std::ranges::sort(sorted);
+            std::println(stderr, "{:<44} median {:>12.1f} {} ({} samples)",
+                         name, sorted[sorted.size() / 2], m.unit, sorted.size());
+        }
+        report_["metrics"][name] = {
+            {"unit", m.unit}, {"lowerIsBetter", m.lowerIsBetter}, {"samples", m.samples},
+        };
+    }
+
+    /** Extra top-level fields (configuration, environment). */
+    nlohmann::json& info() { return report_; }
+
+    /** Write the report; returns main()'s exit code. */
+    int finish() {
+        report_["benchmark"] = benchmark_;
+        if (!report_.contains("metrics")) report_["metrics"] = nlohmann::json::object();
+        const std::string text = report_.dump(2);
+        if (opt_.out.empty()) { std::println("{}", text); return 0; }
+        std::ofstream f(opt_.out);
+        f << text << '\n';
+        if (!f) { std::println(stderr, "cannot write {}", opt_.out); return 1; }
+        return 0;
+    }
+
+private:
+    template <class T>
+    static void parse(std::string_view s, T& out) {
+        std::from_chars(s.data(), s.data() + s.size(), out);
+    }
+
+    std::string    benchmark_;
+    Options        opt_;
+    nlohmann::json report_ = nlohmann::json::object();
+};
+
+} // namespace bamboo::bench
@@ -0,0 +1,388 @@
+// bench/bridge_bench.cpp — end-to-end JS bridge throughput and latency
+//
+// Usage: bamboo_bridge_bench [--mode=call,send,message,jank] [--count=5000] [--rate=0]
+//                            [--payload=64] [--windows=1] [--rounds=3] [--depth=32]
+//                            [--out=<file>]
+//
+// Loads a local page into off-screen windows and drives the real bridge:
+//   call     bamboo.call('benchEcho', payload) → C++ → promise resolved in JS.
+//            Round trip measured in the page; at most --depth calls in flight.
+//   send     bamboo.send('bench', …) from JS, received by Browser::onMessage.
+//   message  Browser::sendMessage('bench', …) from C++, received by bamboo.on.
+//   jank     a 200 ms long task in the page, which must come back through
+//            Browser::onJank. Latency is task end → report (the page flushes
+//            every 5 s); a round without a report fails the run.
+// send/message latencies are one-way, from the wall clock both processes share.
+// --rate is messages per second per window (0 = as fast as the bridge takes
+// them); --windows runs that many windows at once and reports their sum.
+//
+// Each round yields one throughput sample; every message yields one latency
+// sample. The report uses bench_harness's schema, plus a "summary" object
+// with msgs/s and p50/p99/p999 per mode — the numbers to track per release.
+
+#include "bench_harness.hpp"
+#include "bamboo/App.hpp"
+#include "bamboo/Browser.hpp"
+#include "include/cef_task.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <print>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Installs window.__bridgeBench. Completion is reported as 'bench-done'.
+constexpr std::string_view kBenchPage = R"js(
+(() => {
+  const now = () => performance.timeOrigin + performance.now();
+
+  async function pace(n, rate, fn) {
+    const start = performance.now();
+    for (let i = 0; i < n; i++) {
+      if (rate > 0) {
+        const wait = start + i * 1000 / rate - performance.now();
+        if (wait > 1) await new Promise(r => setTimeout(r, wait));
+      } else if ((i & 255) === 255) {
+        await new Promise(r => setTimeout(r, 0));   // let replies in
+      }
+      await fn(i);
+    }
+  }
+
+  let expect = 0, latencies = [];
+  window.bamboo.on('bench', d => {
+    latencies.push(now() - d.t);
+    if (latencies.length === expect) window.bamboo.send('bench-done', { lat: latencies });
+  });
+
+  window.__bridgeBench = {
+    async call(n, rate, payload, depth) {
+      const lat = [], pending = new Set(), t0 = performance.now();
+      await pace(n, rate, async () => {
+        if (pending.size >= depth) await Promise.race(pending);
+        const s = performance.now();
+        const p = window.bamboo.call('benchEcho', payload).then(() => {
+          lat.push(performance.now() - s);
+          pending.delete(p);
+        });
+        pending.add(p);
+      });
+      await Promise.all(pending);
+      window.bamboo.send('bench-done', { elapsedMs: performance.now() - t0, lat });
+    },
+    async send(n, rate, payload) {
+      await pace(n, rate, () => window.bamboo.send('bench', { t: now(), payload }));
+    },
+    expectMessages(n) { expect = n; latencies = []; },
+    longTask(ms) {
+      const end = performance.now() + ms;
+      while (performance.now() < end) {}
+    },
+  };
+})();
+)js";
+
+enum class Mode { Call, Send, Message, Jank };
+
+constexpr int kLongTaskMs = 200;
+
+constexpr std::string_view modeName(Mode m) {
+    switch (m) {
+        case Mode::Call:    return "call";
+        case Mode::Send:    return "send";
+        case Mode::Message: return "message";
+        case Mode::Jank:    return "jank";
+    }
+    return "?";
+}
+
+struct Options {
+    std::vector<Mode> modes = { Mode::Call, Mode::Send, Mode::Message, Mode::Jank };
+    int    count   = 5000;   // messages per window per round
+    double rate    = 0;      // per window; 0 = unthrottled
+    size_t payload = 64;     // bytes of string payload
+    int    windows = 1;
+    int    rounds  = 3;
+    int    depth   = 32;     // max bamboo.call()s in flight (call mode)
+};
+
+Options parseOptions(int argc, char* argv[]) {
+    Options o;
+    auto num = [](std::string_view s) { return std::atof(std::string(s).c_str()); };
+    for (int i = 1; i < argc; ++i) {
+        std::string_view a = argv[i];
+        if (a.starts_with("--mode=")) {
+            o.modes.clear();
+            for (auto part : std::views::split(a.substr(7), ',')) {
+                std::string_view m(part.begin(), part.end());
+                if      (m == "call")    o.modes.push_back(Mode::Call);
+                else if (m == "send")    o.modes.push_back(Mode::Send);
+                else if (m == "message") o.modes.push_back(Mode::Message);
+                else if (m == "jank")    o.modes.push_back(Mode::Jank);
+            }
+        }
+        else if (a.starts_with("--count="))   o.count   = std::max(1, static_cast<int>(num(a.substr(8))));
+        else if (a.starts_with("--rate="))    o.rate    = std::max(0.0, num(a.substr(7)));
+        else if (a.starts_with("--payload=")) o.payload = static_cast<size_t>(std::max(0.0, num(a.substr(10))));
+        else if (a.starts_with("--windows=")) o.windows = std::max(1, static_cast<int>(num(a.substr(10))));
+        else if (a.starts_with("--rounds="))  o.rounds  = std::max(1, static_cast<int>(num(a.substr(9))));
+        else if (a.starts_with("--depth="))   o.depth   = std::max(1, static_cast<int>(num(a.substr(8))));
+    }
+    return o;
+}
+
+double epochMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    const auto i = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(i, 1, sorted.size()) - 1];
+}
+
+/** One window's part of a round. */
+struct WindowRun {
+    std::shared_ptr<bamboo::Browser> win;
+    double startMs = 0, endMs = 0;   // epoch
+    int    received = 0;             // send mode: messages seen by C++
+    int    sent     = 0;             // message mode: messages sent by C++
+    bool   done     = false;
+};
+
+class BridgeBench {
+public:
+    BridgeBench(bamboo::App& app, bamboo::bench::Runner& runner, Options opt)
+        : app_(app), runner_(runner), opt_(std::move(opt)),
+          payload_(opt_.payload, 'x') {}
+
+    [[nodiscard]] int exitCode() const { return exitCode_; }
+
+    void start() {
+        for (int i = 0; i < opt_.windows; ++i) {
+            auto win = bamboo::Browser::create({
+                .title = std::format("Bridge bench {}", i), .url = "about:blank",
+                .width = 800, .height = 600, .offscreen = true, .frameRate = 30,
+            });
+            if (!win) { fail("failed to create window"); return; }
+            setUp(*win);
+            runs_.push_back({ .win = *win });
+        }
+    }
+
+private:
+    void setUp(const std::shared_ptr<bamboo::Browser>& win) {
+        win->bindFunction("benchEcho", [](std::vector<bamboo::JsValue> args) -> bamboo::JsValue {
+            return args.empty() ? bamboo::JsValue{} : args.front();
+        });
+        win->onLoad([this, w = std::weak_ptr(win)](const bamboo::LoadEvent& e) {
+            if (e.isError) { fail(std::format("load failed: {}", e.errorText)); return; }
+            if (auto b = w.lock()) b->executeJS(kBenchPage);
+            if (++loaded_ == opt_.windows) nextRound();
+        });
+        win->onMessage([this, raw = win.get()](std::string_view event, std::string_view data) {
+            auto it = std::ranges::find_if(runs_, [&](const WindowRun& r) { return r.win.get() == raw; });
+            if (it != runs_.end()) onMessage(*it, event, data);
+        });
+        win->onJank([this, raw = win.get()](const bamboo::JankReport& report) {
+            auto it = std::ranges::find_if(runs_, [&](const WindowRun& r) { return r.win.get() == raw; });
+            if (it != runs_.end()) onJank(*it, report);
+        });
+    }
+
+    void nextRound() {
+        if (round_ == opt_.rounds) {
+            round_ = 0;
+            summarize();
+            if (++modeIndex_ == opt_.modes.size()) { finish(); return; }
+        }
+        ++round_;
+        ++generation_;
+        const Mode mode = opt_.modes[modeIndex_];
+        const double t0 = epochMs();
+        for (auto& r : runs_) {
+            r.startMs = t0; r.endMs = 0; r.received = 0; r.sent = 0; r.done = false;
+            switch (mode) {
+                case Mode::Call:
+                    r.win->executeJS(std::format("window.__bridgeBench.call({},{},{},{});",
+                                     opt_.count, opt_.rate, json(payload_).dump(), opt_.depth));
+                    break;
+                case Mode::Send:
+                    r.win->executeJS(std::format("window.__bridgeBench.send({},{},{});",
+                                     opt_.count, opt_.rate, json(payload_).dump()));
+                    break;
+                case Mode::Message:
+                    r.win->executeJS(std::format("window.__bridgeBench.expectMessages({});", opt_.count));
+                    break;
+                case Mode::Jank:
+                    r.win->executeJS(std::format("window.__bridgeBench.longTask({});", kLongTaskMs));
+                    break;
+            }
+        }
+        if (mode == Mode::Message) pumpMessages(generation_, t0);
+
+        // A round that never completes means the bridge dropped something.
+        // A jank report is due within one flush interval of the task.
+        CefPostDelayedTask(TID_UI, CefCreateClosureTask([this, gen = generation_] {
+            if (gen == generation_ && !failed_)
+                fail(std::format("{} round {} timed out", modeName(opt_.modes[modeIndex_]), round_));
+        }), mode == Mode::Jank ? 15'000 : 120'000);
+    }
+
+    // C++ → JS: send what is due by now, then come back in 1 ms.
+    void pumpMessages(uint64_t gen, double t0) {
+        if (gen != generation_ || failed_) return;
+        const double elapsedMs = epochMs() - t0;
+        bool more = false;
+        for (auto& r : runs_) {
+            int due = opt_.rate > 0 ? static_cast<int>(elapsedMs * opt_.rate / 1000.0) + 1
+                                    : r.sent + 256;
+            due = std::min(due, opt_.count);
+            for (; r.sent < due; ++r.sent)
+                r.win->sendMessage("bench", std::format(R"({{"t":{:.3f},"payload":{}}})",
+                                                        epochMs(), json(payload_).dump()));
+            more |= r.sent < opt_.count;
+        }
+        if (more)
+            CefPostDelayedTask(TID_UI, CefCreateClosureTask([this, gen, t0] { pumpMessages(gen, t0); }),
+                               opt_.rate > 0 ? 1 : 0);
+    }
+
+    void onMessage(WindowRun& r, std::string_view event, std::string_view data) {
+        if (r.done) return;
+        const Mode mode = opt_.modes[modeIndex_];
+        if (event == "bench" && mode == Mode::Send) {
+            auto j = json::parse(data, nullptr, false);
+            if (!j.is_object()) return;
+            latencyMs_.push_back(epochMs() - j.value("t", 0.0));
+            if (++r.received == opt_.count) complete(r, epochMs());
+            return;
+        }
+        if (event != "bench-done") return;
+        auto j = json::parse(data, nullptr, false);
+        if (!j.is_object()) { fail("malformed bench-done"); return; }
+        for (const auto& ms : j.value("lat", json::array()))
+            if (ms.is_number()) latencyMs_.push_back(ms.get<double>());
+        complete(r, mode == Mode::Call ? r.startMs + j.value("elapsedMs", 0.0) : epochMs());
+    }
+
+    void onJank(WindowRun& r, const bamboo::JankReport& report) {
+        if (r.done || opt_.modes[modeIndex_] != Mode::Jank) return;
+        // A report from before the task (page load) does not count.
+        const double worst = std::max(report.longTasks.maxMs, report.longFrames.maxMs);
+        if (worst < kLongTaskMs * 0.9) return;
+        const double now = epochMs();
+        latencyMs_.push_back(now - r.startMs - kLongTaskMs);
+        complete(r, now);
+    }
+
+    void complete(WindowRun& r, double endMs) {
+        r.done  = true;
+        r.endMs = endMs;
+        if (!std::ranges::all_of(runs_, &WindowRun::done)) return;
+
+        double first = runs_.front().startMs, last = 0;
+        for (const auto& w : runs_) { first = std::min(first, w.startMs); last = std::max(last, w.endMs); }
+        const double total = static_cast<double>(opt_.count) * static_cast<double>(runs_.size());
+        if (opt_.modes[modeIndex_] != Mode::Jank)
+            throughput_.push_back(last > first ? total * 1000.0 / (last - first) : 0.0);
+        ++generation_;  // disarm the timeout
+        CefPostTask(TID_UI, CefCreateClosureTask([this] { nextRound(); }));
+    }
+
+    void summarize() {
+        const std::string name(modeName(opt_.modes[modeIndex_]));
+        std::vector<double> us;
+        us.reserve(latencyMs_.size());
+        for (double ms : latencyMs_) us.push_back(ms * 1000.0);
+        std::vector<double> sorted = us;
+        std::ranges::sort(sorted);
+        std::vector<double> tput = throughput_;
+        std::ranges::sort(tput);
+
+        runner_.info()["summary"][name] = {
+            {"msgsPerSec", tput.empty() ? 0.0 : tput[tput.size() / 2]},
+            {"p50Us",      percentile(sorted, 0.50)},
+            {"p99Us",      percentile(sorted, 0.99)},
+            {"p999Us",     percentile(sorted, 0.999)},
+            {"messages",   sorted.size()},
+        };
+        if (!throughput_.empty())
+            runner_.add(name + "/throughput", { .unit = "msg/s", .lowerIsBetter = false,
+                                                .samples = std::move(throughput_) });
+        runner_.add(name + "/latency", { .unit = "us", .samples = std::move(us) });
+        throughput_.clear();
+        latencyMs_.clear();
+    }
+
+    void finish() {
+        runner_.info()["config"] = {
+            {"count", opt_.count}, {"rate", opt_.rate}, {"payloadBytes", opt_.payload},
+            {"windows", opt_.windows}, {"rounds", opt_.rounds}, {"depth", opt_.depth},
+        };
+        exitCode_ = runner_.finish();
+        app_.quit();
+    }
+
+    void fail(std::string why) {
+        if (failed_) return;
+        failed_ = true;
+        std::println(stderr, "bridge bench: {}", why);
+        exitCode_ = 1;
+        app_.quit();
+    }
+
+    bamboo::App&           app_;
+    bamboo::bench::Runner& runner_;
+    Options                opt_;
+    std::string            payload_;
+    std::vector<WindowRun> runs_;
+    int      loaded_    = 0;
+    size_t   modeIndex_ = 0;
+    int      round_     = 0;
+    uint64_t generation_ = 0;
+    bool     failed_    = false;
+    int      exitCode_  = 0;
+    std::vector<double> latencyMs_;
+    std::vector<double> throughput_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bamboo::bench::Runner runner("bridge", argc, argv);
+    Options opt = parseOptions(argc, argv);
+    if (opt.modes.empty()) {
+        std::println(stderr, "--mode takes call, send, message and/or jank");
+        return 2;
+    }
+
+    auto app = bamboo::App::create(argc, argv, {
+        .name                = "BambooBridgeBench",
+        .cachePath           = "./bamboo_bench_cache",
+        .enableGPU           = false,
+        .windowlessRendering = true,
+        .logToConsole        = false,
+        .chromiumFlags       = { "--ozone-platform=headless" },
+    });
+    if (!app) {
+        std::println(stderr, "Bamboo init failed (code {})", static_cast<int>(app.error()));
+        return 1;
+    }
+
+    BridgeBench bench(**app, runner, std::move(opt));
+    bench.start();
+    (*app)->run();
+    return bench.exitCode();
+}
@@ -0,0 +1,129 @@
+// bench/bridge_replay.cpp — inspect and replay a recorded bridge log
+//
+// Usage: bamboo_bridge_replay <log> --dump
+//        bamboo_bridge_replay <log> [--speed=0] [--window=<id>] [--loops=1]
+//                                   [--filter=<substring>] [--out=<file>]
+//
+// --dump prints every record as a JSON line. Otherwise the inbound traffic
+// is replayed into a Browser::createDetached() window — no CEF, no display —
+// at full speed (--speed=0) or at the recorded pace scaled by --speed. This
+// tool only has Bamboo's built-in handlers plus no-op stand-ins for the
+// bound functions and onMessage; to measure your own handlers, register
+// them on a detached window and call bamboo::replayBridgeLog from your code.
+//
+// Metrics are "replay/<event>" and "replay/call/<function>", ns per
+// dispatch, one sample per record — the same report bamboo_perf_compare reads.
+
+#include "bench_harness.hpp"
+#include "bamboo/Browser.hpp"
+#include "bamboo/BridgeRecorder.hpp"
+#include <nlohmann/json.hpp>
+#include <cstdlib>
+#include <format>
+#include <map>
+#include <print>
+#include <set>
+#include <string>
+#include <string_view>
+
+using bamboo::bench::doNotOptimize;
+using json = nlohmann::json;
+
+namespace {
+
+std::string_view directionName(bamboo::BridgeDirection d) {
+    switch (d) {
+        case bamboo::BridgeDirection::Inbound:    return "in";
+        case bamboo::BridgeDirection::CallResult: return "result";
+        case bamboo::BridgeDirection::Outbound:   return "out";
+    }
+    return "?";
+}
+
+void dump(const bamboo::BridgeLog& log) {
+    for (const auto& r : log.records()) {
+        std::println("{}", json{
+            {"t", r.timeUs / 1000.0}, {"dir", directionName(r.direction)}, {"window", r.window},
+            {"event", r.event}, {"data", r.data},
+        }.dump(-1, ' ', false, json::error_handler_t::replace));
+    }
+}
+
+/** Metric name per record: bound calls are split out by function. */
+std::vector<std::string> metricNames(const bamboo::BridgeLog& log, std::set<std::string>& functions) {
+    std::vector<std::string> names;
+    names.reserve(log.records().size());
+    for (const auto& r : log.records()) {
+        if (r.event == "__call") {
+            auto j = json::parse(r.data, nullptr, false);
+            const std::string fn = j.is_object() ? j.value("name", std::string{}) : std::string{};
+            functions.insert(fn);
+            names.push_back(std::format("replay/call/{}", fn));
+        } else {
+            names.push_back(std::format("replay/{}", r.event));
+        }
+    }
+    return names;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    bool dumpOnly = false;
+    bamboo::BridgeReplayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view a = argv[i];
+        if      (a == "--dump")                dumpOnly       = true;
+        else if (a.starts_with("--speed="))    options.speed  = std::atof(argv[i] + 8);
+        else if (a.starts_with("--window="))   options.window = std::atoi(argv[i] + 9);
+        else if (a.starts_with("--loops="))    options.loops  = std::atoi(argv[i] + 8);
+        else if (!a.starts_with("--"))         path           = a;
+    }
+    if (path.empty()) {
+        std::println(stderr, "usage: bamboo_bridge_replay <log> [--dump] [--speed=0] [--window=<id>] [--loops=1] [--out=<file>]");
+        return 2;
+    }
+
+    auto log = bamboo::BridgeLog::open(path);
+    if (!log) {
+        std::println(stderr, "{}: {}", path,
+                     log.error() == bamboo::BridgeLogError::OpenFailed ? "cannot open" : "not a bridge log");
+        return 1;
+    }
+    if (log->truncated()) std::println(stderr, "{}: ends mid-record; replaying the complete ones", path);
+    if (dumpOnly) { dump(*log); return 0; }
+
+    bamboo::bench::Runner runner("bridge_replay", argc, argv);
+    std::set<std::string> functions;
+    const auto names = metricNames(*log, functions);
+
+    auto win = bamboo::Browser::createDetached();
+    win->onMessage([](std::string_view, std::string_view data) { doNotOptimize(data.size()); });
+    for (const auto& fn : functions)
+        win->bindFunction(fn, [](std::vector<bamboo::JsValue> args) -> bamboo::JsValue {
+            doNotOptimize(args.size());
+            return std::monostate{};
+        });
+
+    std::map<std::string_view, bamboo::bench::Metric> metrics;
+    const bamboo::BridgeRecord* base = log->records().data();
+    options.onDispatched = [&](const bamboo::BridgeRecord& r, std::chrono::nanoseconds took) {
+        metrics[names[static_cast<size_t>(&r - base)]].samples.push_back(static_cast<double>(took.count()));
+    };
+    const auto stats = bamboo::replayBridgeLog(*log, *win, options);
+
+    for (auto& [name, m] : metrics)
+        if (runner.selected(name)) runner.add(std::string(name), std::move(m));
+    runner.info()["replay"] = {
+        {"log", path}, {"records", log->records().size()}, {"truncated", log->truncated()},
+        {"speed", options.speed}, {"loops", options.loops},
+        {"dispatched", stats.dispatched},
+        {"elapsedMs", stats.elapsed.count() / 1e6},
+        {"handlerMs", stats.handlerTime.count() / 1e6},
+        {"maxLagMs",  stats.maxLag.count() / 1e3},
+    };
+    std::println(stderr, "replayed {} messages in {:.1f} ms ({:.1f} ms in handlers)",
+                 stats.dispatched, stats.elapsed.count() / 1e6, stats.handlerTime.count() / 1e6);
+    return runner.finish();
+}
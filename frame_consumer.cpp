@@ -0,0 +1,131 @@
+// examples/frame_consumer.cpp — local consumer stub for Browser::exportFrames()
+// Connects to the export socket, maps the shared frame ring and prints
+// per-second throughput, torn-frame and latency figures.
+//
+//   ./bamboo_frame_consumer /tmp/bamboo-frames.sock [frameCount]
+
+#include "bamboo/FrameExport.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace bamboo::frame_export;
+
+namespace {
+
+struct Mapping {
+    const uint8_t* base = nullptr;
+    size_t         size = 0;
+
+    ~Mapping() { reset(); }
+    void reset() {
+        if (base) munmap(const_cast<uint8_t*>(base), size);
+        base = nullptr;
+        size = 0;
+    }
+};
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <socket-path> [frameCount]\n", argv[0]);
+        return 2;
+    }
+    const long limit = argc > 2 ? std::atol(argv[2]) : 0;
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, argv[1], sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::perror("connect");
+        return 1;
+    }
+
+    Mapping map;
+    long    frames = 0, torn = 0, windowFrames = 0;
+    int64_t latencySum = 0, windowStart = nowNs();
+
+    for (;;) {
+        alignas(8) uint8_t buf[64];
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        iovec  iov{ buf, sizeof(buf) };
+        msghdr msg{};
+        msg.msg_iov        = &iov;
+        msg.msg_iovlen     = 1;
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+        if (n <= 0) break;
+
+        MessageType type;
+        std::memcpy(&type, buf, sizeof(type));
+
+        if (type == MessageType::Hello) {
+            HelloMessage hello;
+            std::memcpy(&hello, buf, sizeof(hello));
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS) continue;
+            int memfd;
+            std::memcpy(&memfd, CMSG_DATA(cmsg), sizeof(int));
+
+            map.reset();
+            void* p = mmap(nullptr, hello.mappingSize, PROT_READ, MAP_SHARED, memfd, 0);
+            close(memfd);
+            if (p == MAP_FAILED) { std::perror("mmap"); return 1; }
+            map.base = static_cast<const uint8_t*>(p);
+            map.size = hello.mappingSize;
+
+            const auto* ring = reinterpret_cast<const RingHeader*>(map.base);
+            std::printf("ring: %u slots, up to %ux%u\n", ring->slotCount, ring->maxWidth, ring->maxHeight);
+            continue;
+        }
+
+        if (type != MessageType::FrameReady || !map.base) continue;
+        FrameReadyMessage ready;
+        std::memcpy(&ready, buf, sizeof(ready));
+
+        const auto* ring = reinterpret_cast<const RingHeader*>(map.base);
+        const auto* slot = reinterpret_cast<const SlotHeader*>(
+            map.base + ring->headerSize + ready.slot * ring->slotStride);
+
+        if (slot->seq.load(std::memory_order_acquire) != ready.seq) { ++torn; continue; }
+        // A real consumer would upload/composite the pixels here, in place.
+        const uint8_t* pixels = reinterpret_cast<const uint8_t*>(slot + 1);
+        volatile uint8_t touch = pixels[0];
+        (void)touch;
+        const int64_t published = slot->timestampNs;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seq.load(std::memory_order_relaxed) != ready.seq) { ++torn; continue; }
+
+        latencySum += nowNs() - published;
+        ++frames;
+        ++windowFrames;
+
+        const int64_t now = nowNs();
+        if (now - windowStart >= 1'000'000'000) {
+            std::printf("%ld fps, %ld torn, avg notify latency %.1f us\n",
+                        windowFrames, torn, latencySum / 1000.0 / windowFrames);
+            windowFrames = 0;
+            latencySum   = 0;
+            windowStart  = now;
+        }
+        if (limit && frames >= limit) break;
+    }
+
+    std::printf("received %ld frames (%ld torn)\n", frames, torn);
+    close(fd);
+    return 0;
+}
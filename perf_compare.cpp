@@ -0,0 +1,306 @@
+// bench/perf_compare.cpp — benchmark baselines and noise-aware regression reports
+//
+// Usage:
+//   bamboo_perf_compare store   <report.json> [--name=baseline] [--dir=.bamboo-baselines]
+//   bamboo_perf_compare list    [--dir=.bamboo-baselines]
+//   bamboo_perf_compare compare <report.json> [--name=baseline | --against=<old.json>]
+//                               [--threshold=5] [--threshold=<substring>:<pct>]…
+//                               [--alpha=0.01] [--dir=.bamboo-baselines] [--json]
+//
+// Works on the reports written by bench_harness (bamboo_bench, bridge and
+// startup benches): every metric carries all of its samples. For each metric
+// in both runs, compare prints:
+//   - the change in median,
+//   - a 95% bootstrap confidence interval for that change,
+//   - the two-sided Mann-Whitney U p-value.
+// A metric is a regression only if all three agree: p < alpha, the interval
+// excludes zero, and the median moved the wrong way by more than the
+// threshold. Everything else is "same", however large the raw change — on
+// a noisy machine, that is the point.
+//
+// Baselines live in <dir>/<benchmark>/<name>.json. compare exits 1 when
+// anything regressed, so it can gate a script; it needs no network.
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+
+// ─── Statistics ───────────────────────────────────────────────────────────────
+
+double median(std::vector<double> v) {
+    if (v.empty()) return 0;
+    const size_t mid = v.size() / 2;
+    std::ranges::nth_element(v, v.begin() + static_cast<std::ptrdiff_t>(mid));
+    if (v.size() % 2) return v[mid];
+    const double hi = v[mid];
+    return (*std::ranges::max_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(mid)) + hi) / 2;
+}
+
+/** Two-sided Mann-Whitney U p-value (normal approximation, tie- and continuity-corrected). */
+double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+    const size_t n1 = a.size(), n2 = b.size(), n = n1 + n2;
+    if (n1 == 0 || n2 == 0) return 1.0;
+
+    std::vector<std::pair<double, bool>> all;  // value, from a
+    all.reserve(n);
+    for (double x : a) all.emplace_back(x, true);
+    for (double x : b) all.emplace_back(x, false);
+    std::ranges::sort(all, {}, &std::pair<double, bool>::first);
+
+    double rankSumA = 0, tieTerm = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && all[j].first == all[i].first) ++j;
+        const double rank = (static_cast<double>(i + j) + 1) / 2;  // mean of ranks i+1 … j
+        for (size_t k = i; k < j; ++k) if (all[k].second) rankSumA += rank;
+        const double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+    const double dn1 = static_cast<double>(n1), dn2 = static_cast<double>(n2), dn = static_cast<double>(n);
+    const double u     = rankSumA - dn1 * (dn1 + 1) / 2;
+    const double mu    = dn1 * dn2 / 2;
+    const double var   = dn1 * dn2 / 12 * ((dn + 1) - tieTerm / (dn * (dn - 1)));
+    if (var <= 0) return 1.0;  // every sample identical
+    const double z = std::max(0.0, std::abs(u - mu) - 0.5) / std::sqrt(var);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+struct Interval { double lo, hi; };
+
+/** 95% bootstrap CI of the relative change in median, in percent. Fixed seed: reports are reproducible. */
+Interval bootstrapChange(const std::vector<double>& base, const std::vector<double>& next, int resamples = 2000) {
+    std::mt19937_64 rng(0x5eed);
+    auto resampleMedian = [&](const std::vector<double>& v, std::vector<double>& scratch) {
+        std::uniform_int_distribution<size_t> pick(0, v.size() - 1);
+        scratch.resize(v.size());
+        for (double& x : scratch) x = v[pick(rng)];
+        return median(scratch);
+    };
+    std::vector<double> changes, s1, s2;
+    changes.reserve(static_cast<size_t>(resamples));
+    for (int i = 0; i < resamples; ++i) {
+        const double b = resampleMedian(base, s1), n = resampleMedian(next, s2);
+        if (b != 0) changes.push_back((n / b - 1) * 100);
+    }
+    if (changes.empty()) return { 0, 0 };
+    std::ranges::sort(changes);
+    auto at = [&](double q) { return changes[static_cast<size_t>(q * static_cast<double>(changes.size() - 1))]; };
+    return { at(0.025), at(0.975) };
+}
+
+// ─── Reports ──────────────────────────────────────────────────────────────────
+
+struct Options {
+    std::string command;
+    std::string report;
+    std::string dir     = ".bamboo-baselines";
+    std::string name    = "baseline";
+    std::string against;
+    double      threshold = 5;   // percent
+    std::vector<std::pair<std::string, double>> thresholds;  // substring → percent
+    double      alpha   = 0.01;
+    bool        asJson  = false;
+};
+
+std::optional<json> readReport(const fs::path& path) {
+    std::ifstream in(path);
+    if (!in) { std::println(stderr, "cannot read {}", path.string()); return std::nullopt; }
+    auto j = json::parse(in, nullptr, false);
+    if (!j.is_object() || !j.contains("benchmark") || !j["metrics"].is_object()) {
+        std::println(stderr, "{}: not a benchmark report (need \"benchmark\" and \"metrics\")", path.string());
+        return std::nullopt;
+    }
+    return j;
+}
+
+fs::path baselinePath(const Options& o, std::string_view benchmark) {
+    return fs::path(o.dir) / benchmark / (o.name + ".json");
+}
+
+std::string hostName() {
+#if defined(__unix__) || defined(__APPLE__)
+    char buf[256] = {};
+    if (::gethostname(buf, sizeof buf - 1) == 0) return buf;
+#endif
+    return "unknown";
+}
+
+int store(const Options& o) {
+    auto report = readReport(o.report);
+    if (!report) return 2;
+    const auto path = baselinePath(o, (*report)["benchmark"].get<std::string>());
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    (*report)["baseline"] = {
+        {"name", o.name}, {"source", o.report}, {"host", hostName()},
+        {"storedAt", std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()},
+    };
+    std::ofstream out(path);
+    out << report->dump(1) << '\n';
+    if (!out) { std::println(stderr, "cannot write {}", path.string()); return 2; }
+    std::println("stored {}", path.string());
+    return 0;
+}
+
+int list(const Options& o) {
+    std::error_code ec;
+    for (const auto& bench : fs::directory_iterator(o.dir, ec)) {
+        if (!bench.is_directory()) continue;
+        for (const auto& f : fs::directory_iterator(bench.path(), ec)) {
+            if (f.path().extension() != ".json") continue;
+            auto j = readReport(f.path());
+            if (!j) continue;
+            const auto meta = j->value("baseline", json::object());
+            std::println("{:<16} {:<16} {:>4} metrics  host {}", bench.path().filename().string(),
+                         f.path().stem().string(), (*j)["metrics"].size(), meta.value("host", "?"));
+        }
+    }
+    if (ec) { std::println(stderr, "no baselines in {}", o.dir); return 2; }
+    return 0;
+}
+
+double thresholdFor(const Options& o, std::string_view metric) {
+    double t = o.threshold;
+    for (const auto& [pattern, pct] : o.thresholds)
+        if (metric.find(pattern) != std::string_view::npos) t = pct;  // last match wins
+    return t;
+}
+
+std::vector<double> samplesOf(const json& metric) {
+    std::vector<double> out;
+    for (const auto& s : metric.value("samples", json::array()))
+        if (s.is_number()) out.push_back(s.get<double>());
+    return out;
+}
+
+int compare(const Options& o) {
+    auto next = readReport(o.report);
+    if (!next) return 2;
+    const std::string benchmark = (*next)["benchmark"];
+    auto base = readReport(o.against.empty() ? baselinePath(o, benchmark) : fs::path(o.against));
+    if (!base) return 2;
+
+    json rows = json::array();
+    int regressions = 0, improvements = 0;
+    for (const auto& [name, metric] : (*next)["metrics"].items()) {
+        const auto& baseMetrics = (*base)["metrics"];
+        if (!baseMetrics.contains(name)) { rows.push_back({ {"metric", name}, {"verdict", "added"} }); continue; }
+
+        const auto a = samplesOf(baseMetrics[name]), b = samplesOf(metric);
+        const bool lowerIsBetter = metric.value("lowerIsBetter", true);
+        const double mA = median(a), mB = median(b);
+        const double change = mA != 0 ? (mB / mA - 1) * 100 : 0;
+        const double limit  = thresholdFor(o, name);
+
+        std::string verdict = "same";
+        json row = { {"metric", name}, {"unit", metric.value("unit", "")},
+                     {"baseMedian", mA}, {"newMedian", mB}, {"changePct", change},
+                     {"thresholdPct", limit}, {"n", {a.size(), b.size()}} };
+        if (a.size() < 3 || b.size() < 3) {
+            verdict = "too few samples";
+        } else {
+            const double p  = mannWhitneyP(a, b);
+            const auto   ci = bootstrapChange(a, b);
+            row["p"]     = p;
+            row["ciPct"] = { ci.lo, ci.hi };
+            const bool significant = p < o.alpha && (ci.lo > 0 || ci.hi < 0);
+            const bool worse  = lowerIsBetter ? change >  limit : change < -limit;
+            const bool better = lowerIsBetter ? change < -limit : change >  limit;
+            if      (significant && worse)  { verdict = "REGRESSION"; ++regressions; }
+            else if (significant && better) { verdict = "improved";   ++improvements; }
+        }
+        row["verdict"] = verdict;
+        rows.push_back(std::move(row));
+    }
+    for (const auto& [name, _] : (*base)["metrics"].items())
+        if (!(*next)["metrics"].contains(name)) rows.push_back({ {"metric", name}, {"verdict", "removed"} });
+
+    if (o.asJson) {
+        std::println("{}", json{ {"benchmark", benchmark}, {"regressions", regressions},
+                                 {"improvements", improvements}, {"metrics", rows} }.dump(2));
+        return regressions ? 1 : 0;
+    }
+
+    std::println("{}: {} vs {}", benchmark, o.report,
+                 o.against.empty() ? baselinePath(o, benchmark).string() : o.against);
+    std::println("{:<40} {:>15} {:>15} {:>8} {:>19} {:>8}  {}",
+                 "metric", "base", "new", "change", "95% CI", "p", "verdict");
+    for (const auto& r : rows) {
+        if (!r.contains("baseMedian")) {
+            std::println("{:<40} {:>77}  {}", r["metric"].get<std::string>(), "", r["verdict"].get<std::string>());
+            continue;
+        }
+        const std::string unit = r["unit"];
+        const std::string ci = r.contains("ciPct")
+            ? std::format("[{:+.1f}%, {:+.1f}%]", r["ciPct"][0].get<double>(), r["ciPct"][1].get<double>()) : "";
+        const std::string p  = r.contains("p") ? std::format("{:.4f}", r["p"].get<double>()) : "";
+        std::println("{:<40} {:>9.1f} {:<5} {:>9.1f} {:<5} {:>+7.1f}% {:>19} {:>8}  {}",
+                     r["metric"].get<std::string>(), r["baseMedian"].get<double>(), unit,
+                     r["newMedian"].get<double>(), unit, r["changePct"].get<double>(),
+                     ci, p, r["verdict"].get<std::string>());
+    }
+    std::println("{} regression(s), {} improvement(s); alpha {}, default threshold {}%",
+                 regressions, improvements, o.alpha, o.threshold);
+    return regressions ? 1 : 0;
+}
+
+int usage() {
+    std::println(stderr,
+        "usage: bamboo_perf_compare store <report.json> [--name=N] [--dir=D]\n"
+        "       bamboo_perf_compare list [--dir=D]\n"
+        "       bamboo_perf_compare compare <report.json> [--name=N | --against=old.json]\n"
+        "                           [--threshold=PCT] [--threshold=SUBSTRING:PCT]... [--alpha=A] [--json]");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view a = argv[i];
+        if      (a.starts_with("--dir="))     o.dir     = a.substr(6);
+        else if (a.starts_with("--name="))    o.name    = a.substr(7);
+        else if (a.starts_with("--against=")) o.against = a.substr(10);
+        else if (a.starts_with("--alpha="))   o.alpha   = std::atof(argv[i] + 8);
+        else if (a == "--json")               o.asJson  = true;
+        else if (a.starts_with("--threshold=")) {
+            std::string_view v = a.substr(12);
+            if (auto colon = v.rfind(':'); colon != std::string_view::npos)
+                o.thresholds.emplace_back(std::string(v.substr(0, colon)), std::atof(std::string(v.substr(colon + 1)).c_str()));
+            else
+                o.threshold = std::atof(std::string(v).c_str());
+        }
+        else if (a.starts_with("--"))         return usage();
+        else if (o.command.empty())           o.command = a;
+        else if (o.report.empty())            o.report  = a;
+        else                                  return usage();
+    }
+
+    if (o.command == "list")                          return list(o);
+    if (o.command == "store"   && !o.report.empty())  return store(o);
+    if (o.command == "compare" && !o.report.empty())  return compare(o);
+    return usage();
+}
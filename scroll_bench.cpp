@@ -0,0 +1,164 @@
+// bench/scroll_bench.cpp — CSS overlay scrollbars vs Chromium native overlay scrollbars
+//
+// Usage: bamboo_scroll_bench <css|native> [seconds=5] [busyMs=0]
+//
+// Builds a long, moderately heavy page, drives it with synthetic wheel
+// events from the browser process (so scrolling takes the same input →
+// compositor path as a real mouse) and samples every rendered frame with
+// requestAnimationFrame. `busyMs` burns main-thread time each frame to show
+// whether scrolling keeps up when the renderer's main thread is loaded.
+//
+// Native overlay scrollbars are a process-wide switch, so each mode is a
+// separate run:
+//   bamboo_scroll_bench css    > css.json
+//   bamboo_scroll_bench native > native.json
+
+#include "bamboo/App.hpp"
+#include "bamboo/Browser.hpp"
+#include "include/cef_task.h"
+#include <chrono>
+#include <cstdlib>
+#include <expected>
+#include <format>
+#include <functional>
+#include <print>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// Installs the benchmark document and window.__scrollBench.
+constexpr std::string_view kBenchPage = R"js(
+(() => {
+  document.body.innerHTML = '';
+  document.body.style.cssText = 'margin:0;font:14px system-ui';
+  const list = document.createElement('div');
+  list.style.cssText = 'height:100vh;overflow-y:scroll';
+  for (let i = 0; i < 4000; i++) {
+    const row = document.createElement('div');
+    row.style.cssText = `padding:8px 12px;border-bottom:1px solid #ddd;` +
+                        `background:hsl(${(i * 37) % 360} 60% 96%)`;
+    row.innerHTML = `<b>Row ${i}</b> — <span>${'lorem ipsum '.repeat(6)}</span>`;
+    list.appendChild(row);
+  }
+  document.body.appendChild(list);
+
+  const busyMs = %BUSY%;
+  const frames = [];
+  let last = 0, running = true;
+  function tick(now) {
+    if (last) frames.push({ dt: now - last, y: list.scrollTop });
+    last = now;
+    if (busyMs > 0) { const end = performance.now() + busyMs; while (performance.now() < end) {} }
+    if (running) requestAnimationFrame(tick);
+  }
+  requestAnimationFrame(tick);
+
+  window.__scrollBench = {
+    report() {
+      running = false;
+      const dts = frames.map(f => f.dt).sort((a, b) => a - b);
+      const pct = p => dts.length ? dts[Math.min(dts.length - 1, Math.floor(p * dts.length))] : 0;
+      const budget = dts.length ? pct(0.5) * 1.5 : 0;
+      let stalls = 0;  // frames where the scroll position did not move
+      for (let i = 1; i < frames.length; i++) if (frames[i].y === frames[i - 1].y) stalls++;
+      return JSON.stringify({
+        frames: dts.length,
+        frameP50Ms: pct(0.5), frameP95Ms: pct(0.95), frameP99Ms: pct(0.99),
+        longFrames: dts.filter(d => d > budget).length,
+        stalledFrames: stalls,
+        scrolledPx: frames.length ? frames[frames.length - 1].y - frames[0].y : 0,
+      });
+    },
+  };
+})();
+)js";
+
+struct Options {
+    bool native  = false;
+    int  seconds = 5;
+    int  busyMs  = 0;
+};
+
+void driveWheel(std::shared_ptr<bamboo::Browser> win,
+                std::chrono::steady_clock::time_point end,
+                std::function<void()> finished) {
+    if (std::chrono::steady_clock::now() >= end) { finished(); return; }
+    if (auto cef = win->cefBrowser()) {
+        CefMouseEvent ev;
+        ev.x = win->config().width / 2;
+        ev.y = win->config().height / 2;
+        cef->GetHost()->SendMouseWheelEvent(ev, 0, -120);
+    }
+    CefPostDelayedTask(TID_UI, CefCreateClosureTask([win, end, finished = std::move(finished)]() mutable {
+        driveWheel(win, end, std::move(finished));
+    }), 16);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (argc > 1) opt.native  = std::string_view(argv[1]) == "native";
+    if (argc > 2) opt.seconds = std::atoi(argv[2]);
+    if (argc > 3) opt.busyMs  = std::atoi(argv[3]);
+
+    auto app = bamboo::App::create(argc, argv, {
+        .name                    = "BambooScrollBench",
+        .cachePath               = "./bamboo_bench_cache",
+        .nativeOverlayScrollbars = opt.native,
+        .logToConsole            = false,
+    });
+    if (!app) {
+        std::println(stderr, "Bamboo init failed (code {})", static_cast<int>(app.error()));
+        return 1;
+    }
+
+    bamboo::WindowStyle style;
+    style.scrollbar = opt.native ? bamboo::ScrollbarStyle::NativeOverlay
+                                 : bamboo::ScrollbarStyle::Overlay;
+
+    auto win = bamboo::Browser::create({
+        .title = "Scroll bench", .url = "about:blank",
+        .width = 1024, .height = 768, .style = style,
+    });
+    if (!win) {
+        std::println(stderr, "Failed to create window");
+        return 1;
+    }
+    auto browser = *win;
+
+    int exitCode = 1;
+    browser->onLoad([&](const bamboo::LoadEvent& e) {
+        if (e.isError) { (*app)->quit(); return; }
+        std::string page(kBenchPage);
+        page.replace(page.find("%BUSY%"), 6, std::to_string(opt.busyMs));
+        browser->executeJS(page);
+
+        auto end = std::chrono::steady_clock::now() + std::chrono::seconds(opt.seconds);
+        driveWheel(browser, end, [&] {
+            // Read over DevTools, which does not depend on the page's bridge.
+            auto dt = browser->devTools();
+            if (!dt) {
+                std::println(stderr, "scroll bench: DevTools unavailable");
+                (*app)->quit();
+                return;
+            }
+            (*dt)->send(bamboo::cdp::Runtime::evaluate{ .expression = "window.__scrollBench.report()" },
+                [&](std::expected<bamboo::cdp::Runtime::evaluate::Result, bamboo::CdpError> r) {
+                    if (r && r->result.value.is_string()) {
+                        std::println(R"({{"benchmark":"scroll","mode":"{}","busyMs":{},"result":{}}})",
+                                     opt.native ? "native" : "css", opt.busyMs,
+                                     r->result.value.get<std::string>());
+                        exitCode = 0;
+                    } else {
+                        std::println(stderr, "scroll bench: no result from page");
+                    }
+                    (*app)->quit();
+                });
+        });
+    });
+
+    (*app)->run();
+    return exitCode;
+}
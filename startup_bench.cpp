@@ -0,0 +1,288 @@
+// bench/startup_bench.cpp — cold and warm launch times (Linux)
+//
+// Usage: bamboo_startup_bench [--runs=10] [--configs=default,no-gpu,minimal,offscreen]
+//                             [--cache=./bamboo_startup_cache] [--out=<file>]
+//
+// Launches itself repeatedly with posix_spawn. Every child records how long
+// after the parent's spawn call it reached each milestone:
+//   main             main() entered (process exec + dynamic loading)
+//   cefInitialize    App::create returned (CefInitialize done)
+//   afterCreated     Browser::create returned (CEF's OnAfterCreated runs inside it)
+//   loadEnd          first main-frame OnLoadEnd
+//   firstPaint       first OnPaint (off-screen) or the page's 'first-paint' entry
+//
+// Cold runs wipe the cache directory and evict the page cache first: all of it
+// via /proc/sys/vm/drop_caches when running as root, else the executable's
+// directory (libcef, .pak, ICU data, snapshots) with posix_fadvise. The report
+// says which. Warm runs follow one unmeasured priming launch.
+//
+// Metrics are "<config>/<cold|warm>/<milestone>" in ms, one sample per launch.
+
+#include "bench_harness.hpp"
+#include "bamboo/App.hpp"
+#include "bamboo/Browser.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+  #include <fcntl.h>
+  #include <poll.h>
+  #include <signal.h>
+  #include <spawn.h>
+  #include <sys/wait.h>
+  #include <unistd.h>
+  extern char** environ;
+#endif
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr std::string_view kPage =
+    "data:text/html,<!doctype html><title>startup</title>"
+    "<body style='font:16px system-ui'><h1>Bamboo startup</h1><p>First contentful paint.</p>";
+
+constexpr std::string_view kMilestones[] = {
+    "main", "cefInitialize", "afterCreated", "loadEnd", "firstPaint",
+};
+
+struct Variant {
+    std::string_view  name;
+    bamboo::AppConfig app;
+    bool              offscreen = false;
+};
+
+std::vector<Variant> variants() {
+    return {
+        { "default", {} },
+        { "no-gpu",  { .enableGPU = false } },
+        { "minimal", { .enableGPU = false, .enableWebGL = false, .enableMedia = false } },
+        { "offscreen", { .enableGPU = false, .windowlessRendering = true,
+                         .chromiumFlags = { "--ozone-platform=headless" } }, true },
+    };
+}
+
+int64_t epochUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::optional<std::string_view> flag(int argc, char* argv[], std::string_view name) {
+    for (int i = 1; i < argc; ++i) {
+        std::string_view a = argv[i];
+        if (a.starts_with(name) && a.size() > name.size() && a[name.size()] == '=')
+            return a.substr(name.size() + 1);
+    }
+    return std::nullopt;
+}
+
+// ─── Child: one measured launch ───────────────────────────────────────────────
+
+int runChild(int argc, char* argv[], std::string_view variantName) {
+    const int64_t t0 = std::atoll(std::string(flag(argc, argv, "--startup-t0").value_or("0")).c_str());
+    json result;
+    auto mark = [&](std::string_view milestone, int64_t atUs) {
+        if (!result.contains(milestone)) result[std::string(milestone)] = (atUs - t0) / 1000.0;
+    };
+    mark("main", epochUs());
+
+    auto all = variants();
+    auto v = std::ranges::find(all, variantName, &Variant::name);
+    if (v == all.end()) return 2;
+    bamboo::AppConfig config = v->app;
+    config.name         = "BambooStartupBench";
+    config.cachePath    = std::string(flag(argc, argv, "--startup-cache").value_or("./bamboo_startup_cache"));
+    config.logToConsole = false;
+
+    auto app = bamboo::App::create(argc, argv, config);
+    if (!app) return 1;
+    mark("cefInitialize", epochUs());
+
+    auto win = bamboo::Browser::create({
+        .title = "Startup bench", .url = std::string(kPage),
+        .width = 800, .height = 600, .offscreen = v->offscreen,
+    });
+    if (!win) return 1;
+    mark("afterCreated", epochUs());
+
+    bool reported = false;
+    auto finish = [&] {
+        if (!reported && result.contains("firstPaint") && result.contains("loadEnd")) {
+            reported = true;
+            std::println("{}", result.dump());
+            std::fflush(stdout);
+            (*app)->quit();
+        }
+    };
+    if (v->offscreen) {
+        (*win)->onPaint([&](const bamboo::PaintEvent&) { mark("firstPaint", epochUs()); finish(); });
+    }
+    (*win)->onLoad([&](const bamboo::LoadEvent& e) {
+        if (e.isError) { (*app)->quit(); return; }
+        mark("loadEnd", epochUs());
+        if (v->offscreen) { finish(); return; }
+        // Windowed: Chromium's own paint timing, converted to the epoch clock.
+        // Read over DevTools, which does not depend on the page's bridge.
+        auto dt = (*win)->devTools();
+        if (!dt) { result["firstPaint"] = nullptr; finish(); return; }
+        (*dt)->send(bamboo::cdp::Runtime::evaluate{
+                .expression =
+                    "new Promise(r=>{const end=performance.now()+5000;const f=()=>{"
+                    "const e=performance.getEntriesByName('first-paint')[0];"
+                    "if(e)r(performance.timeOrigin+e.startTime);"
+                    "else if(performance.now()>end)r(0);else requestAnimationFrame(f)};f()})",
+                .awaitPromise = true },
+            [&](std::expected<bamboo::cdp::Runtime::evaluate::Result, bamboo::CdpError> r) {
+                const json value = r ? r->result.value : json();
+                const double ms = value.is_number() ? value.get<double>() : 0.0;
+                if (ms > 0) mark("firstPaint", static_cast<int64_t>(ms * 1000.0));
+                else        result["firstPaint"] = nullptr;
+                finish();
+            });
+    });
+
+    (*app)->run();
+    return result.contains("firstPaint") ? 0 : 1;
+}
+
+// ─── Parent: spawn, evict, collect ────────────────────────────────────────────
+
+#if defined(__linux__)
+
+/** Evict cached file pages; returns how ("drop_caches", "fadvise" or "none"). */
+std::string_view dropPageCache() {
+    ::sync();
+    {
+        std::ofstream f("/proc/sys/vm/drop_caches");
+        if (f << "3" << std::flush) return "drop_caches";
+    }
+    std::error_code ec;
+    const auto dir = std::filesystem::read_symlink("/proc/self/exe", ec).parent_path();
+    if (ec) return "none";
+    bool any = false;
+    for (const auto& e : std::filesystem::recursive_directory_iterator(dir, ec)) {
+        if (!e.is_regular_file(ec)) continue;
+        int fd = ::open(e.path().c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        any |= ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        ::close(fd);
+    }
+    return any ? "fadvise" : "none";
+}
+
+/** One launch; the child's JSON line, or nullopt if it failed or hung. */
+std::optional<json> launch(std::string_view variant, const std::string& cache) {
+    int out[2];
+    if (::pipe2(out, O_CLOEXEC) != 0) return std::nullopt;
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+
+    std::string exe  = std::filesystem::read_symlink("/proc/self/exe").string();
+    std::string a1   = std::format("--startup-child={}", variant);
+    std::string a2   = std::format("--startup-cache={}", cache);
+    std::string a3   = std::format("--startup-t0={}", epochUs());
+    char* args[] = { exe.data(), a1.data(), a2.data(), a3.data(), nullptr };
+
+    pid_t pid = 0;
+    const int rc = ::posix_spawn(&pid, exe.c_str(), &actions, nullptr, args, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(out[1]);
+    if (rc != 0) { ::close(out[0]); return std::nullopt; }
+
+    std::string text;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    for (char buf[4096];;) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        pollfd p{ out[0], POLLIN, 0 };
+        if (left <= 0 || ::poll(&p, 1, static_cast<int>(left)) <= 0) { ::kill(pid, SIGKILL); break; }
+        const ssize_t n = ::read(out[0], buf, sizeof buf);
+        if (n <= 0) break;
+        text.append(buf, static_cast<size_t>(n));
+    }
+    ::close(out[0]);
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return std::nullopt;
+
+    // CEF may print too; the result is the last JSON line.
+    std::optional<json> result;
+    for (auto line : std::views::split(text, '\n')) {
+        std::string_view l(line.begin(), line.end());
+        if (!l.starts_with('{')) continue;
+        if (auto j = json::parse(l, nullptr, false); j.is_object()) result = std::move(j);
+    }
+    return result;
+}
+
+int runParent(bamboo::bench::Runner& runner, int argc, char* argv[]) {
+    const int runs = std::max(1, std::atoi(std::string(flag(argc, argv, "--runs").value_or("10")).c_str()));
+    const std::string cache(flag(argc, argv, "--cache").value_or("./bamboo_startup_cache"));
+    std::vector<std::string> selected;
+    for (auto part : std::views::split(flag(argc, argv, "--configs").value_or("default,no-gpu,minimal,offscreen"), ','))
+        selected.emplace_back(part.begin(), part.end());
+
+    std::string_view eviction = "none";
+    int failures = 0;
+    for (const auto& v : variants()) {
+        if (std::ranges::find(selected, v.name) == selected.end()) continue;
+
+        auto measure = [&](std::string_view kind, bool cold) {
+            std::vector<bamboo::bench::Metric> series(std::size(kMilestones));
+            for (int i = 0; i < runs; ++i) {
+                if (cold) {
+                    std::error_code ec;
+                    std::filesystem::remove_all(cache, ec);
+                    eviction = dropPageCache();
+                }
+                auto r = launch(v.name, cache);
+                if (!r) { ++failures; continue; }
+                for (size_t m = 0; m < std::size(kMilestones); ++m)
+                    if (auto it = r->find(kMilestones[m]); it != r->end() && it->is_number())
+                        series[m].samples.push_back(it->get<double>());
+            }
+            for (size_t m = 0; m < std::size(kMilestones); ++m) {
+                series[m].unit = "ms";
+                runner.add(std::format("{}/{}/{}", v.name, kind, kMilestones[m]), std::move(series[m]));
+            }
+        };
+        measure("cold", true);
+        launch(v.name, cache);  // prime
+        measure("warm", false);
+    }
+
+    runner.info()["config"] = { {"runs", runs}, {"configs", selected},
+                                {"pageCacheEviction", eviction}, {"failedLaunches", failures} };
+    if (failures) std::println(stderr, "startup bench: {} launches failed", failures);
+    return runner.finish();
+}
+
+#endif
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // CEF subprocesses re-enter here with --type=…; App::create runs them and exits.
+    if (auto child = flag(argc, argv, "--startup-child")) return runChild(argc, argv, *child);
+    if (flag(argc, argv, "--type")) { (void)bamboo::App::create(argc, argv); return 0; }
+
+#if defined(__linux__)
+    bamboo::bench::Runner runner("startup", argc, argv);
+    return runParent(runner, argc, argv);
+#else
+    std::println(stderr, "bamboo_startup_bench: Linux only");
+    return 1;
+#endif
+}